@@ -328,6 +328,12 @@ ifeq ($(strip $(RGBLIGHT_ENABLE)), yes)
     ifeq ($(strip $(VELOCIKEY_ENABLE)), yes)
         OPT_DEFS += -DVELOCIKEY_ENABLE
     endif
+
+    ifeq ($(strip $(RGBLIGHT_TIMELINE_ENABLE)), yes)
+        OPT_DEFS += -DRGBLIGHT_TIMELINE_ENABLE
+        SRC += $(QUANTUM_DIR)/rgblight/rgblight_timeline.c
+        DEFERRED_EXEC_ENABLE := yes
+    endif
 endif
 
 # Deprecated driver names - do not use
@@ -565,6 +571,12 @@ ifneq ($(strip $(VARIABLE_TRACE)),no)
     endif
 endif
 
+ifeq ($(strip $(MATRIX_IDLE_SLEEP_ENABLE)), yes)
+    SRC += $(QUANTUM_DIR)/matrix_idle_sleep.c
+    SRC += $(PLATFORM_PATH)/$(PLATFORM_KEY)/idle_sleep.c
+    OPT_DEFS += -DMATRIX_IDLE_SLEEP_ENABLE
+endif
+
 ifeq ($(strip $(SLEEP_LED_ENABLE)), yes)
     SRC += $(PLATFORM_COMMON_DIR)/sleep_led.c
     OPT_DEFS += -DSLEEP_LED_ENABLE
@@ -697,6 +709,27 @@ ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
     COMMON_VPATH += $(QUANTUM_PATH)/split_common
 endif
 
+VALID_CRC_DRIVER_TYPES := software vendor
+
+CRC_DRIVER ?= software
+ifeq ($(strip $(CRC_ENABLE)), yes)
+    ifeq ($(filter $(CRC_DRIVER),$(VALID_CRC_DRIVER_TYPES)),)
+        $(call CATASTROPHIC_ERROR,Invalid CRC_DRIVER,CRC_DRIVER="$(CRC_DRIVER)" is not a valid CRC driver)
+    endif
+
+    OPT_DEFS += -DCRC_DRIVER_$(strip $(shell echo $(CRC_DRIVER) | tr '[:lower:]' '[:upper:]'))
+
+    ifeq ($(strip $(CRC_DRIVER)), vendor)
+        CRC_VENDOR_SRC := $(firstword $(wildcard \
+            $(PLATFORM_PATH)/$(PLATFORM_KEY)/$(DRIVER_DIR)/vendor/$(MCU_FAMILY)/$(MCU_SERIES)/crc_vendor.c \
+            $(PLATFORM_PATH)/$(PLATFORM_KEY)/$(DRIVER_DIR)/vendor/$(MCU_FAMILY)/crc_vendor.c))
+        ifeq ($(CRC_VENDOR_SRC),)
+            $(call CATASTROPHIC_ERROR,Invalid CRC_DRIVER,There is no vendor-provided CRC driver available)
+        endif
+        SRC += $(CRC_VENDOR_SRC)
+    endif
+endif
+
 ifeq ($(strip $(FNV_ENABLE)), yes)
     OPT_DEFS += -DFNV_ENABLE
     VPATH += $(LIB_PATH)/fnv
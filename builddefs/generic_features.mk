@@ -47,6 +47,7 @@ GENERIC_FEATURES = \
     SEQUENCER \
     SPACE_CADET \
     SWAP_HANDS \
+    TASK_PROFILER \
     TAP_DANCE \
     TRI_LAYER \
     VIA \
@@ -14,6 +14,7 @@ BUILD_OPTION_NAMES = \
 
 HARDWARE_OPTION_NAMES = \
   SLEEP_LED_ENABLE \
+  MATRIX_IDLE_SLEEP_ENABLE \
   BACKLIGHT_ENABLE \
   BACKLIGHT_DRIVER \
   RGBLIGHT_ENABLE \
@@ -6,6 +6,23 @@
 #include "eeprom_driver.h"
 #include "wear_leveling.h"
 
+#ifdef WEAR_LEVELING_WRITE_BACK
+#    include "timer.h"
+
+// Flush once no writes have arrived for this long...
+#    ifndef WEAR_LEVELING_WRITE_BACK_IDLE_MS
+#        define WEAR_LEVELING_WRITE_BACK_IDLE_MS 500
+#    endif
+
+// ...or once the oldest pending write is this old, whichever comes first
+#    ifndef WEAR_LEVELING_WRITE_BACK_TIMEOUT_MS
+#        define WEAR_LEVELING_WRITE_BACK_TIMEOUT_MS 5000
+#    endif
+
+static uint32_t first_write_time;
+static uint32_t last_write_time;
+#endif // WEAR_LEVELING_WRITE_BACK
+
 void eeprom_driver_init(void) {
     wear_leveling_init();
 }
@@ -19,5 +36,40 @@ void eeprom_read_block(void *buf, const void *addr, size_t len) {
 }
 
 void eeprom_write_block(const void *buf, void *addr, size_t len) {
+#ifdef WEAR_LEVELING_WRITE_BACK
+    last_write_time = timer_read32();
+    if (!wear_leveling_write_pending()) {
+        first_write_time = last_write_time;
+    }
+#endif // WEAR_LEVELING_WRITE_BACK
     wear_leveling_write((uint32_t)addr, buf, len);
 }
+
+#ifdef WEAR_LEVELING_WRITE_BACK
+void eeprom_driver_flush(void) {
+    wear_leveling_flush();
+}
+#endif // WEAR_LEVELING_WRITE_BACK
+
+#if defined(WEAR_LEVELING_WRITE_BACK) || defined(WEAR_LEVELING_INCREMENTAL_CONSOLIDATION)
+void eeprom_driver_task(void) {
+#    ifdef WEAR_LEVELING_WRITE_BACK
+    if (wear_leveling_write_pending()) {
+        if (timer_elapsed32(last_write_time) >= WEAR_LEVELING_WRITE_BACK_IDLE_MS || timer_elapsed32(first_write_time) >= WEAR_LEVELING_WRITE_BACK_TIMEOUT_MS) {
+            if (wear_leveling_flush() == WEAR_LEVELING_FAILED) {
+                // Back off rather than retrying on every scan
+                first_write_time = last_write_time = timer_read32();
+            }
+        }
+        return;
+    }
+#    endif // WEAR_LEVELING_WRITE_BACK
+
+#    ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+    // One sector erase or one chunk copy per scan
+    if (wear_leveling_consolidation_pending()) {
+        wear_leveling_task();
+    }
+#    endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+}
+#endif // defined(WEAR_LEVELING_WRITE_BACK) || defined(WEAR_LEVELING_INCREMENTAL_CONSOLIDATION)
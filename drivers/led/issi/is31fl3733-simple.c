@@ -26,6 +26,10 @@
 #define IS31FL3733_PWM_REGISTER_COUNT 192
 #define IS31FL3733_LED_CONTROL_REGISTER_COUNT 24
 
+// One dirty bit per 16 PWM registers, i.e. per I2C transfer
+#define IS31FL3733_PWM_CHUNK(reg) ((uint16_t)1 << ((reg) / 16))
+#define IS31FL3733_PWM_CHUNK_ALL ((uint16_t)((1UL << (IS31FL3733_PWM_REGISTER_COUNT / 16)) - 1))
+
 #ifndef IS31FL3733_I2C_TIMEOUT
 #    define IS31FL3733_I2C_TIMEOUT 100
 #endif
@@ -72,8 +76,10 @@ uint8_t g_twi_transfer_buffer[20];
 // We could optimize this and take out the unused registers from these
 // buffers and the transfers in is31fl3733_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
-uint8_t g_pwm_buffer[IS31FL3733_DRIVER_COUNT][IS31FL3733_PWM_REGISTER_COUNT];
-bool    g_pwm_buffer_update_required[IS31FL3733_DRIVER_COUNT] = {false};
+// g_pwm_buffer_update_required has a bit set for every chunk of 16 PWM
+// registers that changed since the last flush, so only those are sent.
+uint8_t  g_pwm_buffer[IS31FL3733_DRIVER_COUNT][IS31FL3733_PWM_REGISTER_COUNT];
+uint16_t g_pwm_buffer_update_required[IS31FL3733_DRIVER_COUNT] = {0};
 
 uint8_t g_led_control_registers[IS31FL3733_DRIVER_COUNT][IS31FL3733_LED_CONTROL_REGISTER_COUNT] = {0};
 bool    g_led_control_registers_update_required[IS31FL3733_DRIVER_COUNT]                        = {false};
@@ -97,14 +103,18 @@ bool is31fl3733_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
     return true;
 }
 
-bool is31fl3733_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+static bool is31fl3733_write_pwm_chunks(uint8_t addr, uint8_t *pwm_buffer, uint16_t chunks) {
     // Assumes PG1 is already selected.
     // If any of the transactions fails function returns false.
     // Transmit PWM registers in 12 transfers of 16 bytes.
     // g_twi_transfer_buffer[] is 20 bytes
 
-    // Iterate over the pwm_buffer contents at 16 byte intervals.
+    // Iterate over the dirty chunks of pwm_buffer at 16 byte intervals.
     for (int i = 0; i < IS31FL3733_PWM_REGISTER_COUNT; i += 16) {
+        if (!(chunks & IS31FL3733_PWM_CHUNK(i))) {
+            continue;
+        }
+
         g_twi_transfer_buffer[0] = i;
         // Copy the data from i to i+15.
         // Device will auto-increment register for data after the first byte
@@ -126,6 +136,10 @@ bool is31fl3733_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
     return true;
 }
 
+bool is31fl3733_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+    return is31fl3733_write_pwm_chunks(addr, pwm_buffer, IS31FL3733_PWM_CHUNK_ALL);
+}
+
 void is31fl3733_init_drivers(void) {
     i2c_init();
 
@@ -210,8 +224,9 @@ void is31fl3733_set_value(int index, uint8_t value) {
         if (g_pwm_buffer[led.driver][led.v] == value) {
             return;
         }
-        g_pwm_buffer[led.driver][led.v]          = value;
-        g_pwm_buffer_update_required[led.driver] = true;
+        g_pwm_buffer[led.driver][led.v] = value;
+
+        g_pwm_buffer_update_required[led.driver] |= IS31FL3733_PWM_CHUNK(led.v);
     }
 }
 
@@ -245,10 +260,10 @@ void is31fl3733_update_pwm_buffers(uint8_t addr, uint8_t index) {
 
         // If any of the transactions fail we risk writing dirty PG0,
         // refresh page 0 just in case.
-        if (!is31fl3733_write_pwm_buffer(addr, g_pwm_buffer[index])) {
+        if (!is31fl3733_write_pwm_chunks(addr, g_pwm_buffer[index], g_pwm_buffer_update_required[index])) {
             g_led_control_registers_update_required[index] = true;
         }
-        g_pwm_buffer_update_required[index] = false;
+        g_pwm_buffer_update_required[index] = 0;
     }
 }
 
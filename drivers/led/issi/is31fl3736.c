@@ -23,6 +23,10 @@
 #define IS31FL3736_PWM_REGISTER_COUNT 192 // actually 96
 #define IS31FL3736_LED_CONTROL_REGISTER_COUNT 24
 
+// One dirty bit per 16 PWM registers, i.e. per I2C transfer
+#define IS31FL3736_PWM_CHUNK(reg) ((uint16_t)1 << ((reg) / 16))
+#define IS31FL3736_PWM_CHUNK_ALL ((uint16_t)((1UL << (IS31FL3736_PWM_REGISTER_COUNT / 16)) - 1))
+
 #ifndef IS31FL3736_I2C_TIMEOUT
 #    define IS31FL3736_I2C_TIMEOUT 100
 #endif
@@ -56,8 +60,10 @@ uint8_t g_twi_transfer_buffer[20];
 // We could optimize this and take out the unused registers from these
 // buffers and the transfers in is31fl3736_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
-uint8_t g_pwm_buffer[IS31FL3736_DRIVER_COUNT][IS31FL3736_PWM_REGISTER_COUNT];
-bool    g_pwm_buffer_update_required[IS31FL3736_DRIVER_COUNT] = {false};
+// g_pwm_buffer_update_required has a bit set for every chunk of 16 PWM
+// registers that changed since the last flush, so only those are sent.
+uint8_t  g_pwm_buffer[IS31FL3736_DRIVER_COUNT][IS31FL3736_PWM_REGISTER_COUNT];
+uint16_t g_pwm_buffer_update_required[IS31FL3736_DRIVER_COUNT] = {0};
 
 uint8_t g_led_control_registers[IS31FL3736_DRIVER_COUNT][IS31FL3736_LED_CONTROL_REGISTER_COUNT] = {0};
 bool    g_led_control_registers_update_required[IS31FL3736_DRIVER_COUNT]                        = {false};
@@ -75,14 +81,18 @@ void is31fl3736_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
 #endif
 }
 
-void is31fl3736_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+static void is31fl3736_write_pwm_chunks(uint8_t addr, uint8_t *pwm_buffer, uint16_t chunks) {
     // assumes PG1 is already selected
 
     // transmit PWM registers in 12 transfers of 16 bytes
     // g_twi_transfer_buffer[] is 20 bytes
 
-    // iterate over the pwm_buffer contents at 16 byte intervals
+    // iterate over the dirty chunks of pwm_buffer at 16 byte intervals
     for (int i = 0; i < IS31FL3736_PWM_REGISTER_COUNT; i += 16) {
+        if (!(chunks & IS31FL3736_PWM_CHUNK(i))) {
+            continue;
+        }
+
         g_twi_transfer_buffer[0] = i;
         // copy the data from i to i+15
         // device will auto-increment register for data after the first byte
@@ -99,6 +109,75 @@ void is31fl3736_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
     }
 }
 
+void is31fl3736_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+    is31fl3736_write_pwm_chunks(addr, pwm_buffer, IS31FL3736_PWM_CHUNK_ALL);
+}
+
+#ifdef I2C_ASYNC_ENABLE
+#    define IS31FL3736_PWM_TRANSFER_COUNT (IS31FL3736_PWM_REGISTER_COUNT / 16)
+
+static const uint8_t is31fl3736_unlock_command[2]     = {IS31FL3736_REG_COMMAND_WRITE_LOCK, IS31FL3736_COMMAND_WRITE_LOCK_MAGIC};
+static const uint8_t is31fl3736_select_pwm_command[2] = {IS31FL3736_REG_COMMAND, IS31FL3736_COMMAND_PWM};
+
+// Copy of g_pwm_buffer that is being sent in the background, as the register
+// address followed by 16 PWM values for each transfer. Rendering carries on
+// writing to g_pwm_buffer while the previous frame goes out.
+static uint8_t          g_pwm_transfer_buffer[IS31FL3736_DRIVER_COUNT][IS31FL3736_PWM_TRANSFER_COUNT][17];
+static volatile uint8_t g_pwm_transfers_pending[IS31FL3736_DRIVER_COUNT] = {0};
+static volatile bool    g_pwm_transfer_failed[IS31FL3736_DRIVER_COUNT]   = {false};
+
+static void is31fl3736_pwm_transfer_done(i2c_status_t status, void *arg) {
+    uint8_t index = (uintptr_t)arg;
+
+    if (status != I2C_STATUS_SUCCESS) {
+        g_pwm_transfer_failed[index] = true;
+    }
+    g_pwm_transfers_pending[index]--;
+}
+
+static void is31fl3736_queue_transfer(uint8_t addr, uint8_t index, const uint8_t *data, uint16_t length) {
+    i2c_transmit_async(addr << 1, data, length, IS31FL3736_I2C_TIMEOUT, IS31FL3736_I2C_PERSISTENCE, is31fl3736_pwm_transfer_done, (void *)(uintptr_t)index);
+}
+
+static void is31fl3736_queue_pwm_buffer(uint8_t addr, uint8_t index) {
+    // Leave the buffer dirty while the previous frame is still being sent,
+    // the next flush picks it up.
+    if (g_pwm_transfers_pending[index] > 0) {
+        return;
+    }
+
+    if (g_pwm_transfer_failed[index]) {
+        g_pwm_transfer_failed[index]        = false;
+        g_pwm_buffer_update_required[index] = IS31FL3736_PWM_CHUNK_ALL;
+    }
+
+    // Only the chunks that changed since the last flush are sent
+    uint16_t chunks = g_pwm_buffer_update_required[index];
+    uint8_t  count  = __builtin_popcount(chunks);
+    if (chunks == 0 || i2c_async_space() < count + 2) {
+        return;
+    }
+
+    for (uint8_t i = 0; i < IS31FL3736_PWM_TRANSFER_COUNT; i++) {
+        if (chunks & IS31FL3736_PWM_CHUNK(i * 16)) {
+            g_pwm_transfer_buffer[index][i][0] = i * 16;
+            memcpy(&g_pwm_transfer_buffer[index][i][1], &g_pwm_buffer[index][i * 16], 16);
+        }
+    }
+
+    // Unlock the command register and select PG1, then send the dirty PWM registers.
+    g_pwm_transfers_pending[index] = count + 2;
+    is31fl3736_queue_transfer(addr, index, is31fl3736_unlock_command, sizeof(is31fl3736_unlock_command));
+    is31fl3736_queue_transfer(addr, index, is31fl3736_select_pwm_command, sizeof(is31fl3736_select_pwm_command));
+    for (uint8_t i = 0; i < IS31FL3736_PWM_TRANSFER_COUNT; i++) {
+        if (chunks & IS31FL3736_PWM_CHUNK(i * 16)) {
+            is31fl3736_queue_transfer(addr, index, g_pwm_transfer_buffer[index][i], 17);
+        }
+    }
+    g_pwm_buffer_update_required[index] = 0;
+}
+#endif
+
 void is31fl3736_init_drivers(void) {
     i2c_init();
 
@@ -182,10 +261,11 @@ void is31fl3736_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
         if (g_pwm_buffer[led.driver][led.r] == red && g_pwm_buffer[led.driver][led.g] == green && g_pwm_buffer[led.driver][led.b] == blue) {
             return;
         }
-        g_pwm_buffer[led.driver][led.r]          = red;
-        g_pwm_buffer[led.driver][led.g]          = green;
-        g_pwm_buffer[led.driver][led.b]          = blue;
-        g_pwm_buffer_update_required[led.driver] = true;
+        g_pwm_buffer[led.driver][led.r] = red;
+        g_pwm_buffer[led.driver][led.g] = green;
+        g_pwm_buffer[led.driver][led.b] = blue;
+
+        g_pwm_buffer_update_required[led.driver] |= IS31FL3736_PWM_CHUNK(led.r) | IS31FL3736_PWM_CHUNK(led.g) | IS31FL3736_PWM_CHUNK(led.b);
     }
 }
 
@@ -233,14 +313,18 @@ void is31fl3736_set_led_control_register(uint8_t index, bool red, bool green, bo
 }
 
 void is31fl3736_update_pwm_buffers(uint8_t addr, uint8_t index) {
+#ifdef I2C_ASYNC_ENABLE
+    is31fl3736_queue_pwm_buffer(addr, index);
+#else
     if (g_pwm_buffer_update_required[index]) {
         // Firstly we need to unlock the command register and select PG1
         is31fl3736_write_register(addr, IS31FL3736_REG_COMMAND_WRITE_LOCK, IS31FL3736_COMMAND_WRITE_LOCK_MAGIC);
         is31fl3736_write_register(addr, IS31FL3736_REG_COMMAND, IS31FL3736_COMMAND_PWM);
 
-        is31fl3736_write_pwm_buffer(addr, g_pwm_buffer[index]);
-        g_pwm_buffer_update_required[index] = false;
+        is31fl3736_write_pwm_chunks(addr, g_pwm_buffer[index], g_pwm_buffer_update_required[index]);
+        g_pwm_buffer_update_required[index] = 0;
     }
+#endif
 }
 
 void is31fl3736_update_led_control_registers(uint8_t addr, uint8_t index) {
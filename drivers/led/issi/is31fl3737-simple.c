@@ -25,6 +25,10 @@
 #define IS31FL3737_PWM_REGISTER_COUNT 192 // actually 144
 #define IS31FL3737_LED_CONTROL_REGISTER_COUNT 24
 
+// One dirty bit per 16 PWM registers, i.e. per I2C transfer
+#define IS31FL3737_PWM_CHUNK(reg) ((uint16_t)1 << ((reg) / 16))
+#define IS31FL3737_PWM_CHUNK_ALL ((uint16_t)((1UL << (IS31FL3737_PWM_REGISTER_COUNT / 16)) - 1))
+
 #ifndef IS31FL3737_I2C_TIMEOUT
 #    define IS31FL3737_I2C_TIMEOUT 100
 #endif
@@ -58,9 +62,11 @@ uint8_t g_twi_transfer_buffer[20];
 // We could optimize this and take out the unused registers from these
 // buffers and the transfers in is31fl3737_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
+// g_pwm_buffer_update_required has a bit set for every chunk of 16 PWM
+// registers that changed since the last flush, so only those are sent.
 
-uint8_t g_pwm_buffer[IS31FL3737_DRIVER_COUNT][IS31FL3737_PWM_REGISTER_COUNT];
-bool    g_pwm_buffer_update_required[IS31FL3737_DRIVER_COUNT] = {false};
+uint8_t  g_pwm_buffer[IS31FL3737_DRIVER_COUNT][IS31FL3737_PWM_REGISTER_COUNT];
+uint16_t g_pwm_buffer_update_required[IS31FL3737_DRIVER_COUNT] = {0};
 
 uint8_t g_led_control_registers[IS31FL3737_DRIVER_COUNT][IS31FL3737_LED_CONTROL_REGISTER_COUNT] = {0};
 bool    g_led_control_registers_update_required[IS31FL3737_DRIVER_COUNT]                        = {false};
@@ -78,14 +84,18 @@ void is31fl3737_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
 #endif
 }
 
-void is31fl3737_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+static void is31fl3737_write_pwm_chunks(uint8_t addr, uint8_t *pwm_buffer, uint16_t chunks) {
     // assumes PG1 is already selected
 
     // transmit PWM registers in 12 transfers of 16 bytes
     // g_twi_transfer_buffer[] is 20 bytes
 
-    // iterate over the pwm_buffer contents at 16 byte intervals
+    // iterate over the dirty chunks of pwm_buffer at 16 byte intervals
     for (int i = 0; i < IS31FL3737_PWM_REGISTER_COUNT; i += 16) {
+        if (!(chunks & IS31FL3737_PWM_CHUNK(i))) {
+            continue;
+        }
+
         g_twi_transfer_buffer[0] = i;
         // copy the data from i to i+15
         // device will auto-increment register for data after the first byte
@@ -102,6 +112,10 @@ void is31fl3737_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
     }
 }
 
+void is31fl3737_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+    is31fl3737_write_pwm_chunks(addr, pwm_buffer, IS31FL3737_PWM_CHUNK_ALL);
+}
+
 void is31fl3737_init_drivers(void) {
     i2c_init();
 
@@ -185,8 +199,9 @@ void is31fl3737_set_value(int index, uint8_t value) {
         if (g_pwm_buffer[led.driver][led.v] == value) {
             return;
         }
-        g_pwm_buffer[led.driver][led.v]          = value;
-        g_pwm_buffer_update_required[led.driver] = true;
+        g_pwm_buffer[led.driver][led.v] = value;
+
+        g_pwm_buffer_update_required[led.driver] |= IS31FL3737_PWM_CHUNK(led.v);
     }
 }
 
@@ -218,8 +233,8 @@ void is31fl3737_update_pwm_buffers(uint8_t addr, uint8_t index) {
         is31fl3737_write_register(addr, IS31FL3737_REG_COMMAND_WRITE_LOCK, IS31FL3737_COMMAND_WRITE_LOCK_MAGIC);
         is31fl3737_write_register(addr, IS31FL3737_REG_COMMAND, IS31FL3737_COMMAND_PWM);
 
-        is31fl3737_write_pwm_buffer(addr, g_pwm_buffer[index]);
-        g_pwm_buffer_update_required[index] = false;
+        is31fl3737_write_pwm_chunks(addr, g_pwm_buffer[index], g_pwm_buffer_update_required[index]);
+        g_pwm_buffer_update_required[index] = 0;
     }
 }
 
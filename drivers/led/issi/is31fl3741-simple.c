@@ -21,9 +21,16 @@
 #include <string.h>
 #include "i2c_master.h"
 #include "wait.h"
+#include "util.h"
 
 #define IS31FL3741_PWM_REGISTER_COUNT 351
 
+// One dirty bit per 18 PWM registers, i.e. per I2C transfer. The first 10
+// chunks live on PG0, the remaining 10 (the last one 9 bytes long) on PG1.
+#define IS31FL3741_PWM_CHUNK(reg) ((uint32_t)1 << ((reg) / 18))
+#define IS31FL3741_PWM_CHUNK_ALL ((uint32_t)((1UL << 20) - 1))
+#define IS31FL3741_PWM_CHUNK_PG1 (IS31FL3741_PWM_CHUNK_ALL & ~((uint32_t)IS31FL3741_PWM_CHUNK(180) - 1))
+
 #ifndef IS31FL3741_I2C_TIMEOUT
 #    define IS31FL3741_I2C_TIMEOUT 100
 #endif
@@ -61,9 +68,11 @@ uint8_t g_twi_transfer_buffer[20] = {0xFF};
 // We could optimize this and take out the unused registers from these
 // buffers and the transfers in is31fl3741_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
-uint8_t g_pwm_buffer[IS31FL3741_DRIVER_COUNT][IS31FL3741_PWM_REGISTER_COUNT];
-bool    g_pwm_buffer_update_required[IS31FL3741_DRIVER_COUNT]        = {false};
-bool    g_scaling_registers_update_required[IS31FL3741_DRIVER_COUNT] = {false};
+// g_pwm_buffer_update_required has a bit set for every chunk of 18 PWM
+// registers that changed since the last flush, so only those are sent.
+uint8_t  g_pwm_buffer[IS31FL3741_DRIVER_COUNT][IS31FL3741_PWM_REGISTER_COUNT];
+uint32_t g_pwm_buffer_update_required[IS31FL3741_DRIVER_COUNT]        = {0};
+bool     g_scaling_registers_update_required[IS31FL3741_DRIVER_COUNT] = {false};
 
 uint8_t g_scaling_registers[IS31FL3741_DRIVER_COUNT][IS31FL3741_PWM_REGISTER_COUNT];
 
@@ -80,51 +89,49 @@ void is31fl3741_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
 #endif
 }
 
-bool is31fl3741_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+static bool is31fl3741_write_pwm_chunks(uint8_t addr, uint8_t *pwm_buffer, uint32_t chunks) {
     // Assume PG0 is already selected
+    bool pg1_selected = false;
+
+    // iterate over the dirty chunks of pwm_buffer at 18 byte intervals,
+    // the last one only holds the remaining 9 bytes as the total number is 351
+    for (int i = 0; i < IS31FL3741_PWM_REGISTER_COUNT; i += 18) {
+        uint8_t length = MIN(IS31FL3741_PWM_REGISTER_COUNT - i, 18);
+
+        if (!(chunks & IS31FL3741_PWM_CHUNK(i))) {
+            continue;
+        }
 
-    for (int i = 0; i < 342; i += 18) {
-        if (i == 180) {
+        if (i >= 180 && !pg1_selected) {
             // unlock the command register and select PG1
             is31fl3741_write_register(addr, IS31FL3741_REG_COMMAND_WRITE_LOCK, IS31FL3741_COMMAND_WRITE_LOCK_MAGIC);
             is31fl3741_write_register(addr, IS31FL3741_REG_COMMAND, IS31FL3741_COMMAND_PWM_1);
+            pg1_selected = true;
         }
 
         g_twi_transfer_buffer[0] = i % 180;
-        memcpy(g_twi_transfer_buffer + 1, pwm_buffer + i, 18);
+        memcpy(g_twi_transfer_buffer + 1, pwm_buffer + i, length);
 
 #if IS31FL3741_I2C_PERSISTENCE > 0
         for (uint8_t i = 0; i < IS31FL3741_I2C_PERSISTENCE; i++) {
-            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 19, IS31FL3741_I2C_TIMEOUT) != 0) {
+            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, IS31FL3741_I2C_TIMEOUT) != 0) {
                 return false;
             }
         }
 #else
-        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 19, IS31FL3741_I2C_TIMEOUT) != 0) {
+        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, IS31FL3741_I2C_TIMEOUT) != 0) {
             return false;
         }
 #endif
     }
 
-    // transfer the left cause the total number is 351
-    g_twi_transfer_buffer[0] = 162;
-    memcpy(g_twi_transfer_buffer + 1, pwm_buffer + 342, 9);
-
-#if IS31FL3741_I2C_PERSISTENCE > 0
-    for (uint8_t i = 0; i < IS31FL3741_I2C_PERSISTENCE; i++) {
-        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 10, IS31FL3741_I2C_TIMEOUT) != 0) {
-            return false;
-        }
-    }
-#else
-    if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 10, IS31FL3741_I2C_TIMEOUT) != 0) {
-        return false;
-    }
-#endif
-
     return true;
 }
 
+bool is31fl3741_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+    return is31fl3741_write_pwm_chunks(addr, pwm_buffer, IS31FL3741_PWM_CHUNK_ALL);
+}
+
 void is31fl3741_init_drivers(void) {
     i2c_init();
 
@@ -192,8 +199,9 @@ void is31fl3741_set_value(int index, uint8_t value) {
         if (g_pwm_buffer[led.driver][led.v] == value) {
             return;
         }
-        g_pwm_buffer_update_required[led.driver] = true;
-        g_pwm_buffer[led.driver][led.v]          = value;
+        g_pwm_buffer[led.driver][led.v] = value;
+
+        g_pwm_buffer_update_required[led.driver] |= IS31FL3741_PWM_CHUNK(led.v);
     }
 }
 
@@ -222,16 +230,16 @@ void is31fl3741_update_pwm_buffers(uint8_t addr, uint8_t index) {
         is31fl3741_write_register(addr, IS31FL3741_REG_COMMAND_WRITE_LOCK, IS31FL3741_COMMAND_WRITE_LOCK_MAGIC);
         is31fl3741_write_register(addr, IS31FL3741_REG_COMMAND, IS31FL3741_COMMAND_PWM_0);
 
-        is31fl3741_write_pwm_buffer(addr, g_pwm_buffer[index]);
+        is31fl3741_write_pwm_chunks(addr, g_pwm_buffer[index], g_pwm_buffer_update_required[index]);
     }
 
-    g_pwm_buffer_update_required[index] = false;
+    g_pwm_buffer_update_required[index] = 0;
 }
 
 void is31fl3741_set_pwm_buffer(const is31fl3741_led_t *pled, uint8_t value) {
     g_pwm_buffer[pled->driver][pled->v] = value;
 
-    g_pwm_buffer_update_required[pled->driver] = true;
+    g_pwm_buffer_update_required[pled->driver] |= IS31FL3741_PWM_CHUNK(pled->v);
 }
 
 void is31fl3741_update_led_control_registers(uint8_t addr, uint8_t index) {
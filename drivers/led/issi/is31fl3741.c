@@ -21,9 +21,16 @@
 #include <string.h>
 #include "i2c_master.h"
 #include "wait.h"
+#include "util.h"
 
 #define IS31FL3741_PWM_REGISTER_COUNT 351
 
+// One dirty bit per 18 PWM registers, i.e. per I2C transfer. The first 10
+// chunks live on PG0, the remaining 10 (the last one 9 bytes long) on PG1.
+#define IS31FL3741_PWM_CHUNK(reg) ((uint32_t)1 << ((reg) / 18))
+#define IS31FL3741_PWM_CHUNK_ALL ((uint32_t)((1UL << 20) - 1))
+#define IS31FL3741_PWM_CHUNK_PG1 (IS31FL3741_PWM_CHUNK_ALL & ~((uint32_t)IS31FL3741_PWM_CHUNK(180) - 1))
+
 #ifndef IS31FL3741_I2C_TIMEOUT
 #    define IS31FL3741_I2C_TIMEOUT 100
 #endif
@@ -61,9 +68,11 @@ uint8_t g_twi_transfer_buffer[20] = {0xFF};
 // We could optimize this and take out the unused registers from these
 // buffers and the transfers in is31fl3741_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
-uint8_t g_pwm_buffer[IS31FL3741_DRIVER_COUNT][IS31FL3741_PWM_REGISTER_COUNT];
-bool    g_pwm_buffer_update_required[IS31FL3741_DRIVER_COUNT]        = {false};
-bool    g_scaling_registers_update_required[IS31FL3741_DRIVER_COUNT] = {false};
+// g_pwm_buffer_update_required has a bit set for every chunk of 18 PWM
+// registers that changed since the last flush, so only those are sent.
+uint8_t  g_pwm_buffer[IS31FL3741_DRIVER_COUNT][IS31FL3741_PWM_REGISTER_COUNT];
+uint32_t g_pwm_buffer_update_required[IS31FL3741_DRIVER_COUNT]        = {0};
+bool     g_scaling_registers_update_required[IS31FL3741_DRIVER_COUNT] = {false};
 
 uint8_t g_scaling_registers[IS31FL3741_DRIVER_COUNT][IS31FL3741_PWM_REGISTER_COUNT];
 
@@ -80,50 +89,125 @@ void is31fl3741_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
 #endif
 }
 
-bool is31fl3741_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+static bool is31fl3741_write_pwm_chunks(uint8_t addr, uint8_t *pwm_buffer, uint32_t chunks) {
     // Assume PG0 is already selected
+    bool pg1_selected = false;
+
+    // iterate over the dirty chunks of pwm_buffer at 18 byte intervals,
+    // the last one only holds the remaining 9 bytes as the total number is 351
+    for (int i = 0; i < IS31FL3741_PWM_REGISTER_COUNT; i += 18) {
+        uint8_t length = MIN(IS31FL3741_PWM_REGISTER_COUNT - i, 18);
 
-    for (int i = 0; i < 342; i += 18) {
-        if (i == 180) {
+        if (!(chunks & IS31FL3741_PWM_CHUNK(i))) {
+            continue;
+        }
+
+        if (i >= 180 && !pg1_selected) {
             // unlock the command register and select PG1
             is31fl3741_write_register(addr, IS31FL3741_REG_COMMAND_WRITE_LOCK, IS31FL3741_COMMAND_WRITE_LOCK_MAGIC);
             is31fl3741_write_register(addr, IS31FL3741_REG_COMMAND, IS31FL3741_COMMAND_PWM_1);
+            pg1_selected = true;
         }
 
         g_twi_transfer_buffer[0] = i % 180;
-        memcpy(g_twi_transfer_buffer + 1, pwm_buffer + i, 18);
+        memcpy(g_twi_transfer_buffer + 1, pwm_buffer + i, length);
 
 #if IS31FL3741_I2C_PERSISTENCE > 0
         for (uint8_t i = 0; i < IS31FL3741_I2C_PERSISTENCE; i++) {
-            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 19, IS31FL3741_I2C_TIMEOUT) != 0) {
+            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, IS31FL3741_I2C_TIMEOUT) != 0) {
                 return false;
             }
         }
 #else
-        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 19, IS31FL3741_I2C_TIMEOUT) != 0) {
+        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, IS31FL3741_I2C_TIMEOUT) != 0) {
             return false;
         }
 #endif
     }
 
-    // transfer the left cause the total number is 351
-    g_twi_transfer_buffer[0] = 162;
-    memcpy(g_twi_transfer_buffer + 1, pwm_buffer + 342, 9);
+    return true;
+}
 
-#if IS31FL3741_I2C_PERSISTENCE > 0
-    for (uint8_t i = 0; i < IS31FL3741_I2C_PERSISTENCE; i++) {
-        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 10, IS31FL3741_I2C_TIMEOUT) != 0) {
-            return false;
-        }
+bool is31fl3741_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+    return is31fl3741_write_pwm_chunks(addr, pwm_buffer, IS31FL3741_PWM_CHUNK_ALL);
+}
+
+#ifdef I2C_ASYNC_ENABLE
+// 10 transfers of 18 bytes on PG0, 9 transfers of 18 bytes and the remaining 9 bytes on PG1
+#    define IS31FL3741_PWM_TRANSFER_COUNT 20
+
+static const uint8_t is31fl3741_unlock_command[2]       = {IS31FL3741_REG_COMMAND_WRITE_LOCK, IS31FL3741_COMMAND_WRITE_LOCK_MAGIC};
+static const uint8_t is31fl3741_select_pwm_0_command[2] = {IS31FL3741_REG_COMMAND, IS31FL3741_COMMAND_PWM_0};
+static const uint8_t is31fl3741_select_pwm_1_command[2] = {IS31FL3741_REG_COMMAND, IS31FL3741_COMMAND_PWM_1};
+
+// Copy of g_pwm_buffer that is being sent in the background, as the register
+// address followed by 18 PWM values for each transfer. Rendering carries on
+// writing to g_pwm_buffer while the previous frame goes out.
+static uint8_t          g_pwm_transfer_buffer[IS31FL3741_DRIVER_COUNT][IS31FL3741_PWM_TRANSFER_COUNT][19];
+static volatile uint8_t g_pwm_transfers_pending[IS31FL3741_DRIVER_COUNT] = {0};
+static volatile bool    g_pwm_transfer_failed[IS31FL3741_DRIVER_COUNT]   = {false};
+
+static void is31fl3741_pwm_transfer_done(i2c_status_t status, void *arg) {
+    uint8_t index = (uintptr_t)arg;
+
+    if (status != I2C_STATUS_SUCCESS) {
+        g_pwm_transfer_failed[index] = true;
     }
-#else
-    if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 10, IS31FL3741_I2C_TIMEOUT) != 0) {
-        return false;
+    g_pwm_transfers_pending[index]--;
+}
+
+static void is31fl3741_queue_transfer(uint8_t addr, uint8_t index, const uint8_t *data, uint16_t length) {
+    i2c_transmit_async(addr << 1, data, length, IS31FL3741_I2C_TIMEOUT, IS31FL3741_I2C_PERSISTENCE, is31fl3741_pwm_transfer_done, (void *)(uintptr_t)index);
+}
+
+static void is31fl3741_queue_pwm_buffer(uint8_t addr, uint8_t index) {
+    // Leave the buffer dirty while the previous frame is still being sent,
+    // the next flush picks it up.
+    if (g_pwm_transfers_pending[index] > 0) {
+        return;
     }
-#endif
 
-    return true;
+    if (g_pwm_transfer_failed[index]) {
+        g_pwm_transfer_failed[index]        = false;
+        g_pwm_buffer_update_required[index] = IS31FL3741_PWM_CHUNK_ALL;
+    }
+
+    // Only the chunks that changed since the last flush are sent, plus the
+    // unlock and page select commands for PG0 and, if needed, PG1
+    uint32_t chunks = g_pwm_buffer_update_required[index];
+    uint8_t  count  = __builtin_popcountl(chunks) + ((chunks & IS31FL3741_PWM_CHUNK_PG1) ? 4 : 2);
+    if (chunks == 0 || i2c_async_space() < count) {
+        return;
+    }
+
+    g_pwm_transfers_pending[index] = count;
+
+    // unlock the command register and select PG0
+    is31fl3741_queue_transfer(addr, index, is31fl3741_unlock_command, sizeof(is31fl3741_unlock_command));
+    is31fl3741_queue_transfer(addr, index, is31fl3741_select_pwm_0_command, sizeof(is31fl3741_select_pwm_0_command));
+
+    bool pg1_selected = false;
+    for (uint16_t i = 0, t = 0; i < IS31FL3741_PWM_REGISTER_COUNT; i += 18, t++) {
+        uint8_t length = MIN(IS31FL3741_PWM_REGISTER_COUNT - i, 18);
+
+        if (!(chunks & IS31FL3741_PWM_CHUNK(i))) {
+            continue;
+        }
+
+        if (i >= 180 && !pg1_selected) {
+            // unlock the command register and select PG1
+            is31fl3741_queue_transfer(addr, index, is31fl3741_unlock_command, sizeof(is31fl3741_unlock_command));
+            is31fl3741_queue_transfer(addr, index, is31fl3741_select_pwm_1_command, sizeof(is31fl3741_select_pwm_1_command));
+            pg1_selected = true;
+        }
+
+        g_pwm_transfer_buffer[index][t][0] = i % 180;
+        memcpy(&g_pwm_transfer_buffer[index][t][1], &g_pwm_buffer[index][i], length);
+        is31fl3741_queue_transfer(addr, index, g_pwm_transfer_buffer[index][t], length + 1);
+    }
+    g_pwm_buffer_update_required[index] = 0;
 }
+#endif
 
 void is31fl3741_init_drivers(void) {
     i2c_init();
@@ -192,10 +276,11 @@ void is31fl3741_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
         if (g_pwm_buffer[led.driver][led.r] == red && g_pwm_buffer[led.driver][led.g] == green && g_pwm_buffer[led.driver][led.b] == blue) {
             return;
         }
-        g_pwm_buffer_update_required[led.driver] = true;
-        g_pwm_buffer[led.driver][led.r]          = red;
-        g_pwm_buffer[led.driver][led.g]          = green;
-        g_pwm_buffer[led.driver][led.b]          = blue;
+        g_pwm_buffer[led.driver][led.r] = red;
+        g_pwm_buffer[led.driver][led.g] = green;
+        g_pwm_buffer[led.driver][led.b] = blue;
+
+        g_pwm_buffer_update_required[led.driver] |= IS31FL3741_PWM_CHUNK(led.r) | IS31FL3741_PWM_CHUNK(led.g) | IS31FL3741_PWM_CHUNK(led.b);
     }
 }
 
@@ -231,15 +316,19 @@ void is31fl3741_set_led_control_register(uint8_t index, bool red, bool green, bo
 }
 
 void is31fl3741_update_pwm_buffers(uint8_t addr, uint8_t index) {
+#ifdef I2C_ASYNC_ENABLE
+    is31fl3741_queue_pwm_buffer(addr, index);
+#else
     if (g_pwm_buffer_update_required[index]) {
         // unlock the command register and select PG2
         is31fl3741_write_register(addr, IS31FL3741_REG_COMMAND_WRITE_LOCK, IS31FL3741_COMMAND_WRITE_LOCK_MAGIC);
         is31fl3741_write_register(addr, IS31FL3741_REG_COMMAND, IS31FL3741_COMMAND_PWM_0);
 
-        is31fl3741_write_pwm_buffer(addr, g_pwm_buffer[index]);
+        is31fl3741_write_pwm_chunks(addr, g_pwm_buffer[index], g_pwm_buffer_update_required[index]);
     }
 
-    g_pwm_buffer_update_required[index] = false;
+    g_pwm_buffer_update_required[index] = 0;
+#endif
 }
 
 void is31fl3741_set_pwm_buffer(const is31fl3741_led_t *pled, uint8_t red, uint8_t green, uint8_t blue) {
@@ -247,7 +336,7 @@ void is31fl3741_set_pwm_buffer(const is31fl3741_led_t *pled, uint8_t red, uint8_
     g_pwm_buffer[pled->driver][pled->g] = green;
     g_pwm_buffer[pled->driver][pled->b] = blue;
 
-    g_pwm_buffer_update_required[pled->driver] = true;
+    g_pwm_buffer_update_required[pled->driver] |= IS31FL3741_PWM_CHUNK(pled->r) | IS31FL3741_PWM_CHUNK(pled->g) | IS31FL3741_PWM_CHUNK(pled->b);
 }
 
 void is31fl3741_update_led_control_registers(uint8_t addr, uint8_t index) {
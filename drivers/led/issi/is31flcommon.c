@@ -21,6 +21,7 @@
 #include "is31flcommon.h"
 #include "i2c_master.h"
 #include "wait.h"
+#include "util.h"
 #include <string.h>
 
 // Set defaults for Timeout and Persistence
@@ -31,13 +32,21 @@
 #    define ISSI_PERSISTENCE 0
 #endif
 
+#define ISSI_PWM_TRANSFER_COUNT ((ISSI_MAX_LEDS + ISSI_PWM_TRF_SIZE - 1) / ISSI_PWM_TRF_SIZE)
+
+// One dirty bit per ISSI_PWM_TRF_SIZE PWM registers, i.e. per I2C transfer
+#define ISSI_PWM_CHUNK(reg) ((uint16_t)1 << ((reg) / ISSI_PWM_TRF_SIZE))
+#define ISSI_PWM_CHUNK_ALL ((uint16_t)((1UL << ISSI_PWM_TRANSFER_COUNT) - 1))
+
 // Transfer buffer for TWITransmitData()
 uint8_t g_twi_transfer_buffer[20];
 
 // These buffers match the PWM & scaling registers.
 // Storing them like this is optimal for I2C transfers to the registers.
-uint8_t g_pwm_buffer[DRIVER_COUNT][ISSI_MAX_LEDS];
-bool    g_pwm_buffer_update_required[DRIVER_COUNT] = {false};
+// g_pwm_buffer_update_required has a bit set for every chunk of PWM registers
+// that changed since the last flush, so only those are sent.
+uint8_t  g_pwm_buffer[DRIVER_COUNT][ISSI_MAX_LEDS];
+uint16_t g_pwm_buffer_update_required[DRIVER_COUNT] = {0};
 
 uint8_t g_scaling_buffer[DRIVER_COUNT][ISSI_SCALING_SIZE];
 bool    g_scaling_buffer_update_required[DRIVER_COUNT] = {false};
@@ -57,28 +66,50 @@ void IS31FL_write_single_register(uint8_t addr, uint8_t reg, uint8_t data) {
 #endif
 }
 
+// For writing of a block of registers starting at reg
+static bool IS31FL_write_register_block(uint8_t addr, uint8_t reg, uint8_t *source_buffer, uint8_t transfer_size) {
+    // Set the first entry of transfer buffer to the first register we want to write
+    g_twi_transfer_buffer[0] = reg;
+    // Copy the section of our source buffer into the transfer buffer after first register address
+    memcpy(g_twi_transfer_buffer + 1, source_buffer, transfer_size);
+
+#if ISSI_PERSISTENCE > 0
+    for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
+        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, transfer_size + 1, ISSI_TIMEOUT) != 0) {
+            return false;
+        }
+    }
+#else
+    if (i2c_transmit(addr << 1, g_twi_transfer_buffer, transfer_size + 1, ISSI_TIMEOUT) != 0) {
+        return false;
+    }
+#endif
+    return true;
+}
+
 // For writing of mulitple register entries to make use of address auto increment
 // Once the controller has been called and we have written the first bit of data
 // the controller will move to the next register meaning we can write sequential blocks.
 bool IS31FL_write_multi_registers(uint8_t addr, uint8_t *source_buffer, uint8_t buffer_size, uint8_t transfer_size, uint8_t start_reg_addr) {
     // Split the buffer into chunks to transfer
     for (int i = 0; i < buffer_size; i += transfer_size) {
-        // Set the first entry of transfer buffer to the first register we want to write
-        g_twi_transfer_buffer[0] = i + start_reg_addr;
-        // Copy the section of our source buffer into the transfer buffer after first register address
-        memcpy(g_twi_transfer_buffer + 1, source_buffer + i, transfer_size);
+        if (!IS31FL_write_register_block(addr, i + start_reg_addr, source_buffer + i, transfer_size)) {
+            return false;
+        }
+    }
+    return true;
+}
 
-#if ISSI_PERSISTENCE > 0
-        for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
-            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, transfer_size + 1, ISSI_TIMEOUT) != 0) {
-                return false;
-            }
+// Same as IS31FL_write_multi_registers() for the PWM registers, but only
+// transfers the chunks that are set in chunks
+static bool IS31FL_write_pwm_chunks(uint8_t addr, uint8_t *pwm_buffer, uint16_t chunks) {
+    for (int i = 0; i < ISSI_MAX_LEDS; i += ISSI_PWM_TRF_SIZE) {
+        if (!(chunks & ISSI_PWM_CHUNK(i))) {
+            continue;
         }
-#else
-        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, transfer_size + 1, ISSI_TIMEOUT) != 0) {
+        if (!IS31FL_write_register_block(addr, i + ISSI_PWM_REG_1ST, pwm_buffer + i, ISSI_PWM_TRF_SIZE)) {
             return false;
         }
-#endif
     }
     return true;
 }
@@ -120,15 +151,83 @@ void IS31FL_common_init(uint8_t addr, uint8_t ssr) {
     wait_ms(10);
 }
 
+#ifdef I2C_ASYNC_ENABLE
+static const uint8_t IS31FL_unlock_command[2]     = {ISSI_COMMANDREGISTER_WRITELOCK, ISSI_REGISTER_UNLOCK};
+static const uint8_t IS31FL_select_pwm_command[2] = {ISSI_COMMANDREGISTER, ISSI_PAGE_PWM};
+
+// Copy of g_pwm_buffer that is being sent in the background, as the register
+// address followed by ISSI_PWM_TRF_SIZE PWM values for each transfer.
+// Rendering carries on writing to g_pwm_buffer while the previous frame goes out.
+static uint8_t          g_pwm_transfer_buffer[DRIVER_COUNT][ISSI_PWM_TRANSFER_COUNT][ISSI_PWM_TRF_SIZE + 1];
+static volatile uint8_t g_pwm_transfers_pending[DRIVER_COUNT] = {0};
+static volatile bool    g_pwm_transfer_failed[DRIVER_COUNT]   = {false};
+
+static void IS31FL_pwm_transfer_done(i2c_status_t status, void *arg) {
+    uint8_t index = (uintptr_t)arg;
+
+    if (status != I2C_STATUS_SUCCESS) {
+        g_pwm_transfer_failed[index] = true;
+    }
+    g_pwm_transfers_pending[index]--;
+}
+
+static void IS31FL_queue_transfer(uint8_t addr, uint8_t index, const uint8_t *data, uint16_t length) {
+    i2c_transmit_async(addr << 1, data, length, ISSI_TIMEOUT, ISSI_PERSISTENCE, IS31FL_pwm_transfer_done, (void *)(uintptr_t)index);
+}
+
+static void IS31FL_common_queue_pwm_register(uint8_t addr, uint8_t index) {
+    // Leave the buffer dirty while the previous frame is still being sent,
+    // the next flush picks it up.
+    if (g_pwm_transfers_pending[index] > 0) {
+        return;
+    }
+
+    if (g_pwm_transfer_failed[index]) {
+        g_pwm_transfer_failed[index]        = false;
+        g_pwm_buffer_update_required[index] = ISSI_PWM_CHUNK_ALL;
+    }
+
+    // Only the chunks that changed since the last flush are sent
+    uint16_t chunks = g_pwm_buffer_update_required[index];
+    uint8_t  count  = __builtin_popcount(chunks);
+    if (chunks == 0 || i2c_async_space() < count + 2) {
+        return;
+    }
+
+    g_pwm_transfers_pending[index] = count + 2;
+
+    // Queue up the correct page
+    IS31FL_queue_transfer(addr, index, IS31FL_unlock_command, sizeof(IS31FL_unlock_command));
+    IS31FL_queue_transfer(addr, index, IS31FL_select_pwm_command, sizeof(IS31FL_select_pwm_command));
+
+    for (uint16_t i = 0, t = 0; i < ISSI_MAX_LEDS; i += ISSI_PWM_TRF_SIZE, t++) {
+        uint8_t length = MIN(ISSI_MAX_LEDS - i, ISSI_PWM_TRF_SIZE);
+
+        if (!(chunks & ISSI_PWM_CHUNK(i))) {
+            continue;
+        }
+
+        g_pwm_transfer_buffer[index][t][0] = i + ISSI_PWM_REG_1ST;
+        memcpy(&g_pwm_transfer_buffer[index][t][1], &g_pwm_buffer[index][i], length);
+        IS31FL_queue_transfer(addr, index, g_pwm_transfer_buffer[index][t], length + 1);
+    }
+    g_pwm_buffer_update_required[index] = 0;
+}
+#endif
+
 void IS31FL_common_update_pwm_register(uint8_t addr, uint8_t index) {
+#ifdef I2C_ASYNC_ENABLE
+    IS31FL_common_queue_pwm_register(addr, index);
+#else
     if (g_pwm_buffer_update_required[index]) {
         // Queue up the correct page
         IS31FL_unlock_register(addr, ISSI_PAGE_PWM);
-        // Hand off the update to IS31FL_write_multi_registers
-        IS31FL_write_multi_registers(addr, g_pwm_buffer[index], ISSI_MAX_LEDS, ISSI_PWM_TRF_SIZE, ISSI_PWM_REG_1ST);
+        // Hand off the update of the dirty chunks to IS31FL_write_pwm_chunks
+        IS31FL_write_pwm_chunks(addr, g_pwm_buffer[index], g_pwm_buffer_update_required[index]);
         // Update flags that pwm_buffer has been updated
-        g_pwm_buffer_update_required[index] = false;
+        g_pwm_buffer_update_required[index] = 0;
     }
+#endif
 }
 
 #ifdef ISSI_MANUAL_SCALING
@@ -229,10 +328,14 @@ void IS31FL_RGB_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
         is31_led led;
         memcpy_P(&led, (&g_is31_leds[index]), sizeof(led));
 
-        g_pwm_buffer[led.driver][led.r]          = red;
-        g_pwm_buffer[led.driver][led.g]          = green;
-        g_pwm_buffer[led.driver][led.b]          = blue;
-        g_pwm_buffer_update_required[led.driver] = true;
+        if (g_pwm_buffer[led.driver][led.r] == red && g_pwm_buffer[led.driver][led.g] == green && g_pwm_buffer[led.driver][led.b] == blue) {
+            return;
+        }
+        g_pwm_buffer[led.driver][led.r] = red;
+        g_pwm_buffer[led.driver][led.g] = green;
+        g_pwm_buffer[led.driver][led.b] = blue;
+
+        g_pwm_buffer_update_required[led.driver] |= ISSI_PWM_CHUNK(led.r) | ISSI_PWM_CHUNK(led.g) | ISSI_PWM_CHUNK(led.b);
     }
 }
 
@@ -317,8 +420,12 @@ void IS31FL_simple_set_brightness(int index, uint8_t value) {
         is31_led led;
         memcpy_P(&led, (&g_is31_leds[index]), sizeof(led));
 
+        if (g_pwm_buffer[led.driver][led.v] == value) {
+            return;
+        }
         g_pwm_buffer[led.driver][led.v] = value;
-        g_pwm_buffer_update_required[led.driver] = true;
+
+        g_pwm_buffer_update_required[led.driver] |= ISSI_PWM_CHUNK(led.v);
     }
 }
 
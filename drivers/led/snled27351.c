@@ -20,6 +20,10 @@
 #define SNLED27351_PWM_REGISTER_COUNT 192
 #define SNLED27351_LED_CONTROL_REGISTER_COUNT 24
 
+// One dirty bit per 16 PWM registers
+#define SNLED27351_PWM_CHUNK(reg) ((uint16_t)1 << ((reg) / 16))
+#define SNLED27351_PWM_CHUNK_ALL ((uint16_t)((1UL << (SNLED27351_PWM_REGISTER_COUNT / 16)) - 1))
+
 #ifndef SNLED27351_I2C_TIMEOUT
 #    define SNLED27351_I2C_TIMEOUT 100
 #endif
@@ -46,8 +50,10 @@ uint8_t g_twi_transfer_buffer[65];
 // We could optimize this and take out the unused registers from these
 // buffers and the transfers in snled27351_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
-uint8_t g_pwm_buffer[SNLED27351_DRIVER_COUNT][SNLED27351_PWM_REGISTER_COUNT];
-bool    g_pwm_buffer_update_required[SNLED27351_DRIVER_COUNT] = {false};
+// g_pwm_buffer_update_required has a bit set for every chunk of 16 PWM
+// registers that changed since the last flush, so only those are sent.
+uint8_t  g_pwm_buffer[SNLED27351_DRIVER_COUNT][SNLED27351_PWM_REGISTER_COUNT];
+uint16_t g_pwm_buffer_update_required[SNLED27351_DRIVER_COUNT] = {0};
 
 uint8_t g_led_control_registers[SNLED27351_DRIVER_COUNT][SNLED27351_LED_CONTROL_REGISTER_COUNT] = {0};
 bool    g_led_control_registers_update_required[SNLED27351_DRIVER_COUNT]                        = {false};
@@ -71,36 +77,51 @@ bool snled27351_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
     return true;
 }
 
-bool snled27351_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+static bool snled27351_write_pwm_chunks(uint8_t addr, uint8_t *pwm_buffer, uint16_t chunks) {
     // Assumes PG1 is already selected.
     // If any of the transactions fails function returns false.
-    // Transmit PWM registers in 3 transfers of 64 bytes.
+    // Runs of consecutive dirty chunks are merged into transfers of up to
+    // 64 bytes, so a full update is still 3 transfers of 64 bytes.
+
+    for (uint8_t i = 0; i < SNLED27351_PWM_REGISTER_COUNT;) {
+        if (!(chunks & SNLED27351_PWM_CHUNK(i))) {
+            i += 16;
+            continue;
+        }
+
+        uint8_t length = 0;
+        while (length < 64 && i + length < SNLED27351_PWM_REGISTER_COUNT && (chunks & SNLED27351_PWM_CHUNK(i + length))) {
+            length += 16;
+        }
 
-    // Iterate over the pwm_buffer contents at 64 byte intervals.
-    for (uint8_t i = 0; i < SNLED27351_PWM_REGISTER_COUNT; i += 64) {
         g_twi_transfer_buffer[0] = i;
-        // Copy the data from i to i+63.
+        // Copy the data from i to i+length-1.
         // Device will auto-increment register for data after the first byte
         // Thus this sets registers 0x00-0x0F, 0x10-0x1F, etc. in one transfer.
-        for (uint8_t j = 0; j < 64; j++) {
+        for (uint8_t j = 0; j < length; j++) {
             g_twi_transfer_buffer[1 + j] = pwm_buffer[i + j];
         }
 
 #if SNLED27351_I2C_PERSISTENCE > 0
         for (uint8_t i = 0; i < SNLED27351_I2C_PERSISTENCE; i++) {
-            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 65, SNLED27351_I2C_TIMEOUT) != 0) {
+            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, SNLED27351_I2C_TIMEOUT) != 0) {
                 return false;
             }
         }
 #else
-        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 65, SNLED27351_I2C_TIMEOUT) != 0) {
+        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, SNLED27351_I2C_TIMEOUT) != 0) {
             return false;
         }
 #endif
+        i += length;
     }
     return true;
 }
 
+bool snled27351_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+    return snled27351_write_pwm_chunks(addr, pwm_buffer, SNLED27351_PWM_CHUNK_ALL);
+}
+
 void snled27351_init_drivers(void) {
     i2c_init();
 
@@ -185,10 +206,11 @@ void snled27351_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
         if (g_pwm_buffer[led.driver][led.r] == red && g_pwm_buffer[led.driver][led.g] == green && g_pwm_buffer[led.driver][led.b] == blue) {
             return;
         }
-        g_pwm_buffer[led.driver][led.r]          = red;
-        g_pwm_buffer[led.driver][led.g]          = green;
-        g_pwm_buffer[led.driver][led.b]          = blue;
-        g_pwm_buffer_update_required[led.driver] = true;
+        g_pwm_buffer[led.driver][led.r] = red;
+        g_pwm_buffer[led.driver][led.g] = green;
+        g_pwm_buffer[led.driver][led.b] = blue;
+
+        g_pwm_buffer_update_required[led.driver] |= SNLED27351_PWM_CHUNK(led.r) | SNLED27351_PWM_CHUNK(led.g) | SNLED27351_PWM_CHUNK(led.b);
     }
 }
 
@@ -234,11 +256,11 @@ void snled27351_update_pwm_buffers(uint8_t addr, uint8_t index) {
 
         // If any of the transactions fail we risk writing dirty PG0,
         // refresh page 0 just in case.
-        if (!snled27351_write_pwm_buffer(addr, g_pwm_buffer[index])) {
+        if (!snled27351_write_pwm_chunks(addr, g_pwm_buffer[index], g_pwm_buffer_update_required[index])) {
             g_led_control_registers_update_required[index] = true;
         }
     }
-    g_pwm_buffer_update_required[index] = false;
+    g_pwm_buffer_update_required[index] = 0;
 }
 
 void snled27351_update_led_control_registers(uint8_t addr, uint8_t index) {
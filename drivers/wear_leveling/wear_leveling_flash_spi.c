@@ -41,6 +41,21 @@ bool backing_store_erase(void) {
     return ret;
 }
 
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+bool backing_store_erase_partial(uint32_t address, uint32_t end, uint32_t *next) {
+    if ((address % (EXTERNAL_FLASH_SECTOR_SIZE)) != 0 || address + (EXTERNAL_FLASH_SECTOR_SIZE) > end) {
+        return false;
+    }
+
+    if (flash_erase_sector((WEAR_LEVELING_EXTERNAL_FLASH_BLOCK_OFFSET) * (EXTERNAL_FLASH_BLOCK_SIZE) + address) != FLASH_STATUS_SUCCESS) {
+        return false;
+    }
+
+    *next = address + (EXTERNAL_FLASH_SECTOR_SIZE);
+    return true;
+}
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
 bool backing_store_write(uint32_t address, backing_store_int_t value) {
     return backing_store_write_bulk(address, &value, 1);
 }
@@ -74,3 +74,10 @@
  *         - Wait 50us to reset the LEDs
  */
 void ws2812_setleds(rgb_led_t *ledarray, uint16_t number_of_leds);
+
+/*
+ * Invoked from interrupt context by the SPI driver once a frame, including its
+ * reset period, has been shifted out. Does nothing by default; may only use
+ * functions which are safe to call from an ISR.
+ */
+void ws2812_frame_sent_cb(void);
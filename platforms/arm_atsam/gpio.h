@@ -79,3 +79,7 @@ typedef uint8_t pin_t;
 #define readPin(pin) ((PORT->Group[SAMD_PORT(pin)].IN.reg & SAMD_PIN_MASK(pin)) != 0)
 
 #define togglePin(pin) (PORT->Group[SAMD_PORT(pin)].OUTTGL.reg = SAMD_PIN_MASK(pin))
+
+/* Not implemented, idle_sleep() returns straight away. */
+#define enablePinWakeup(pin) true
+#define disablePinWakeup(pin)
@@ -0,0 +1,9 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "idle_sleep.h"
+
+// Not implemented, the matrix is polled instead
+void idle_sleep(uint16_t timeout_ms) {}
+
+void idle_sleep_wakeup_from_isr(void) {}
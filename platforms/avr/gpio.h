@@ -36,3 +36,7 @@ typedef uint8_t pin_t;
 #define readPin(pin) ((bool)(PINx_ADDRESS(pin) & _BV((pin)&0xF)))
 
 #define togglePin(pin) (PORTx_ADDRESS(pin) ^= _BV((pin)&0xF))
+
+/* Pin change interrupt routing differs between AVR parts, idle_sleep() is woken up by the timer instead. */
+#define enablePinWakeup(pin) true
+#define disablePinWakeup(pin)
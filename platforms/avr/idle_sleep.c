@@ -0,0 +1,23 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include "idle_sleep.h"
+
+// No pins are armed on AVR. The millisecond timer interrupt is the timer
+// wakeup, it ends the sleep within 1ms and so within any non-zero timeout.
+// The caller then checks the matrix with a single read.
+void idle_sleep(uint16_t timeout_ms) {
+    if (timeout_ms == 0) {
+        return;
+    }
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    sleep_enable();
+    sei();
+    sleep_cpu();
+    sleep_disable();
+}
+
+// Any interrupt ends the sleep by itself
+void idle_sleep_wakeup_from_isr(void) {}
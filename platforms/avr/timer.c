@@ -134,6 +134,34 @@ inline uint32_t timer_elapsed32(uint32_t last) {
     return TIMER_DIFF_32(t, last);
 }
 
+#if defined(__AVR_ATmega32A__)
+#    define TIMER_COMPARE_PENDING() (TIFR & _BV(OCF0))
+#elif defined(__AVR_ATtiny85__)
+#    define TIMER_COMPARE_PENDING() (TIFR & _BV(OCF0A))
+#else
+#    define TIMER_COMPARE_PENDING() (TIFR0 & _BV(OCF0A))
+#endif
+
+/** \brief timer read raw32
+ *
+ * Milliseconds and the timer0 count combined, in timer0 ticks.
+ */
+uint32_t timer_read_raw32(void) {
+    uint32_t ms;
+    uint8_t  raw;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ms  = timer_count;
+        raw = TIMER_RAW;
+        // The counter wrapped but the interrupt that counts the millisecond hasn't run yet
+        if (TIMER_COMPARE_PENDING() && raw < (TIMER_RAW_TOP / 2)) {
+            ms++;
+        }
+    }
+
+    return ms * (TIMER_RAW_TOP + 1) + raw;
+}
+
 // excecuted once per 1ms.(excess for just timer count?)
 #ifndef __AVR_ATmega32A__
 #    define TIMER_INTERRUPT_VECTOR TIMER0_COMPA_vect
@@ -124,12 +124,133 @@ static i2c_status_t i2c_epilogue(const msg_t status) {
 
     // From ChibiOS HAL: "After a timeout the driver must be stopped and
     // restarted because the bus is in an uncertain state." We also issue that
-    // hard stop in case of any error.
-    i2c_stop();
+    // hard stop in case of any error. This also runs on the async thread, so
+    // it must not go through i2c_stop(), which waits for the queue to drain.
+    i2cStop(&I2C_DRIVER);
 
     return status == MSG_TIMEOUT ? I2C_STATUS_TIMEOUT : I2C_STATUS_ERROR;
 }
 
+static i2c_status_t i2c_transmit_now(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    i2c_address = address;
+    i2cStart(&I2C_DRIVER, &i2cconfig);
+    msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), data, length, 0, 0, TIME_MS2I(timeout));
+    return i2c_epilogue(status);
+}
+
+#ifdef I2C_ASYNC_ENABLE
+#    ifndef I2C_ASYNC_THREAD_PRIORITY
+#        define I2C_ASYNC_THREAD_PRIORITY (NORMALPRIO + 1)
+#    endif
+
+#    if I2C_ASYNC_QUEUE_SIZE < 2 || I2C_ASYNC_QUEUE_SIZE > 255
+#        error I2C_ASYNC_QUEUE_SIZE must be between 2 and 255
+#    endif
+
+typedef struct {
+    const uint8_t*       data;
+    i2c_async_callback_t callback;
+    void*                arg;
+    uint16_t             length;
+    uint16_t             timeout;
+    uint8_t              address;
+    uint8_t              persistence;
+} i2c_async_transfer_t;
+
+// Filled by the caller at the head, drained by the thread from the tail. The
+// tail only moves on once the transfer has finished, so an empty queue means
+// the bus is free.
+static i2c_async_transfer_t i2c_async_queue[I2C_ASYNC_QUEUE_SIZE];
+static volatile uint8_t     i2c_async_head = 0;
+static volatile uint8_t     i2c_async_tail = 0;
+static semaphore_t          i2c_async_pending;
+
+// Every thread blocked in i2c_async_wait(), woken together once the queue is empty
+static threads_queue_t i2c_async_waiters;
+
+/**
+ * @brief Sends the queued transfers one at a time. The I2C LLD suspends this
+ * thread while the transfer is running, so the CPU is free for keyboard_task.
+ */
+static THD_WORKING_AREA(waI2cAsyncThread, 256);
+static THD_FUNCTION(I2cAsyncThread, arg) {
+    (void)arg;
+    chRegSetThreadName("i2c_async");
+
+    while (true) {
+        chSemWait(&i2c_async_pending);
+
+        i2c_async_transfer_t* transfer = &i2c_async_queue[i2c_async_tail];
+        i2c_status_t          status;
+        // Retried straight away, so the transfers queued after it still go out in order
+        uint8_t attempt = 0;
+        do {
+            status = i2c_transmit_now(transfer->address, transfer->data, transfer->length, transfer->timeout);
+        } while (status != I2C_STATUS_SUCCESS && ++attempt < transfer->persistence);
+        if (transfer->callback) {
+            transfer->callback(status, transfer->arg);
+        }
+
+        chSysLock();
+        i2c_async_tail = (i2c_async_tail + 1) % I2C_ASYNC_QUEUE_SIZE;
+        if (i2c_async_tail == i2c_async_head) {
+            chThdDequeueAllI(&i2c_async_waiters, MSG_OK);
+        }
+        chSysUnlock();
+    }
+}
+
+bool i2c_transmit_async(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout, uint8_t persistence, i2c_async_callback_t callback, void* arg) {
+    static bool thread_started = false;
+    if (!thread_started) {
+        thread_started = true;
+        chSemObjectInit(&i2c_async_pending, 0);
+        chThdQueueObjectInit(&i2c_async_waiters);
+        chThdCreateStatic(waI2cAsyncThread, sizeof(waI2cAsyncThread), I2C_ASYNC_THREAD_PRIORITY, I2cAsyncThread, NULL);
+    }
+
+    // Several threads may be queueing, so the slot is claimed and filled in one go
+    chSysLock();
+    if (i2c_async_space() == 0) {
+        chSysUnlock();
+        return false;
+    }
+
+    i2c_async_transfer_t* transfer = &i2c_async_queue[i2c_async_head];
+    transfer->address              = address;
+    transfer->data                 = data;
+    transfer->length               = length;
+    transfer->timeout              = timeout;
+    transfer->persistence          = persistence;
+    transfer->callback             = callback;
+    transfer->arg                  = arg;
+
+    i2c_async_head = (i2c_async_head + 1) % I2C_ASYNC_QUEUE_SIZE;
+    chSemSignalI(&i2c_async_pending);
+    chSchRescheduleS();
+    chSysUnlock();
+    return true;
+}
+
+uint8_t i2c_async_space(void) {
+    return (I2C_ASYNC_QUEUE_SIZE - 1) - ((i2c_async_head - i2c_async_tail + I2C_ASYNC_QUEUE_SIZE) % I2C_ASYNC_QUEUE_SIZE);
+}
+
+bool i2c_async_busy(void) {
+    return i2c_async_head != i2c_async_tail;
+}
+
+void i2c_async_wait(void) {
+    chSysLock();
+    while (i2c_async_head != i2c_async_tail) {
+        chThdEnqueueTimeoutS(&i2c_async_waiters, TIME_INFINITE);
+    }
+    chSysUnlock();
+}
+#else
+static inline void i2c_async_wait(void) {}
+#endif
+
 __attribute__((weak)) void i2c_init(void) {
     static bool is_initialised = false;
     if (!is_initialised) {
@@ -151,19 +272,19 @@ __attribute__((weak)) void i2c_init(void) {
 }
 
 i2c_status_t i2c_start(uint8_t address) {
+    i2c_async_wait();
     i2c_address = address;
     i2cStart(&I2C_DRIVER, &i2cconfig);
     return I2C_STATUS_SUCCESS;
 }
 
 i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
-    i2c_address = address;
-    i2cStart(&I2C_DRIVER, &i2cconfig);
-    msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), data, length, 0, 0, TIME_MS2I(timeout));
-    return i2c_epilogue(status);
+    i2c_async_wait();
+    return i2c_transmit_now(address, data, length, timeout);
 }
 
 i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout) {
+    i2c_async_wait();
     i2c_address = address;
     i2cStart(&I2C_DRIVER, &i2cconfig);
     msg_t status = i2cMasterReceiveTimeout(&I2C_DRIVER, (i2c_address >> 1), data, length, TIME_MS2I(timeout));
@@ -171,6 +292,7 @@ i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16
 }
 
 i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    i2c_async_wait();
     i2c_address = devaddr;
     i2cStart(&I2C_DRIVER, &i2cconfig);
 
@@ -185,6 +307,7 @@ i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data,
 }
 
 i2c_status_t i2c_writeReg16(uint8_t devaddr, uint16_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    i2c_async_wait();
     i2c_address = devaddr;
     i2cStart(&I2C_DRIVER, &i2cconfig);
 
@@ -200,6 +323,7 @@ i2c_status_t i2c_writeReg16(uint8_t devaddr, uint16_t regaddr, const uint8_t* da
 }
 
 i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
+    i2c_async_wait();
     i2c_address = devaddr;
     i2cStart(&I2C_DRIVER, &i2cconfig);
     msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), &regaddr, 1, data, length, TIME_MS2I(timeout));
@@ -207,6 +331,7 @@ i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16
 }
 
 i2c_status_t i2c_readReg16(uint8_t devaddr, uint16_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
+    i2c_async_wait();
     i2c_address = devaddr;
     i2cStart(&I2C_DRIVER, &i2cconfig);
     uint8_t register_packet[2] = {regaddr >> 8, regaddr & 0xFF};
@@ -215,5 +340,6 @@ i2c_status_t i2c_readReg16(uint8_t devaddr, uint16_t regaddr, uint8_t* data, uin
 }
 
 void i2c_stop(void) {
+    i2c_async_wait();
     i2cStop(&I2C_DRIVER);
 }
@@ -24,6 +24,7 @@
  */
 #pragma once
 
+#include <stdbool.h>
 #include <stdint.h>
 
 typedef int16_t i2c_status_t;
@@ -41,3 +42,21 @@ i2c_status_t i2c_writeReg16(uint8_t devaddr, uint16_t regaddr, const uint8_t* da
 i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout);
 i2c_status_t i2c_readReg16(uint8_t devaddr, uint16_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout);
 void         i2c_stop(void);
+
+#ifdef I2C_ASYNC_ENABLE
+#    ifndef I2C_ASYNC_QUEUE_SIZE
+#        define I2C_ASYNC_QUEUE_SIZE 64
+#    endif
+
+typedef void (*i2c_async_callback_t)(i2c_status_t status, void* arg);
+
+/* Queues a transmit that is carried out by a background thread. The data must
+ * stay valid until the callback has run. The callback, if any, runs on the
+ * background thread. A failed transfer is tried up to `persistence` times in
+ * all before the callback sees the error. Returns false if the queue is full.
+ */
+bool    i2c_transmit_async(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout, uint8_t persistence, i2c_async_callback_t callback, void* arg);
+uint8_t i2c_async_space(void);
+bool    i2c_async_busy(void);
+void    i2c_async_wait(void);
+#endif
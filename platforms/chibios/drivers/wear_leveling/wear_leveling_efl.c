@@ -120,6 +120,37 @@ bool backing_store_erase(void) {
     return ret;
 }
 
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+bool backing_store_erase_partial(uint32_t address, uint32_t end, uint32_t *next) {
+    for (int i = 0; i < sector_count; ++i) {
+        if (flashGetSectorOffset(flash, first_sector + i) != base_offset + address) {
+            continue;
+        }
+
+        // Sectors may differ in size, so make sure this one stays within the requested bank
+        uint32_t sector_size = flashGetSectorSize(flash, first_sector + i);
+        if (address + sector_size > end) {
+            return false;
+        }
+
+        flash_error_t status = flashStartEraseSector(flash, first_sector + i);
+        if (status != FLASH_NO_ERROR && status != FLASH_BUSY_ERASING) {
+            return false;
+        }
+        status = flashWaitErase(flash);
+        if (status != FLASH_NO_ERROR && status != FLASH_BUSY_ERASING) {
+            return false;
+        }
+
+        *next = address + sector_size;
+        return true;
+    }
+
+    // Not the start of a sector
+    return false;
+}
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
 bool backing_store_write(uint32_t address, backing_store_int_t value) {
     uint32_t offset = (base_offset + address);
     bs_dprintf("Write ");
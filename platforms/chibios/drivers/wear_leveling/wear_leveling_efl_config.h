@@ -43,12 +43,20 @@
 #    endif
 #endif
 
-// 2kB backing space allocated
+// 2kB backing space allocated, 4kB for two banks when consolidating incrementally
 #ifndef WEAR_LEVELING_BACKING_SIZE
-#    define WEAR_LEVELING_BACKING_SIZE 2048
+#    ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+#        define WEAR_LEVELING_BACKING_SIZE 4096
+#    else
+#        define WEAR_LEVELING_BACKING_SIZE 2048
+#    endif
 #endif // WEAR_LEVELING_BACKING_SIZE
 
 // 1kB logical EEPROM
 #ifndef WEAR_LEVELING_LOGICAL_SIZE
-#    define WEAR_LEVELING_LOGICAL_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 2)
+#    ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+#        define WEAR_LEVELING_LOGICAL_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 4)
+#    else
+#        define WEAR_LEVELING_LOGICAL_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 2)
+#    endif
 #endif // WEAR_LEVELING_LOGICAL_SIZE
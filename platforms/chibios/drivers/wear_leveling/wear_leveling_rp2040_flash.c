@@ -187,6 +187,21 @@ bool backing_store_erase(void) {
     return true;
 }
 
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+bool backing_store_erase_partial(uint32_t address, uint32_t end, uint32_t *next) {
+    if ((address % (FLASH_SECTOR_SIZE)) != 0 || address + (FLASH_SECTOR_SIZE) > end) {
+        return false;
+    }
+
+    interrupts = save_and_disable_interrupts();
+    flash_range_erase((WEAR_LEVELING_RP2040_FLASH_BASE) + address, (FLASH_SECTOR_SIZE));
+    restore_interrupts(interrupts);
+
+    *next = address + (FLASH_SECTOR_SIZE);
+    return true;
+}
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
 bool backing_store_write(uint32_t address, backing_store_int_t value) {
     return backing_store_write_bulk(address, &value, 1);
 }
@@ -11,14 +11,22 @@
 #    define BACKING_STORE_WRITE_SIZE 2
 #endif
 
-// 64kB backing space allocated
+// 64kB backing space allocated, twice that for two banks when consolidating incrementally
 #ifndef WEAR_LEVELING_BACKING_SIZE
-#    define WEAR_LEVELING_BACKING_SIZE 8192
+#    ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+#        define WEAR_LEVELING_BACKING_SIZE 16384
+#    else
+#        define WEAR_LEVELING_BACKING_SIZE 8192
+#    endif
 #endif // WEAR_LEVELING_BACKING_SIZE
 
 // 32kB logical EEPROM
 #ifndef WEAR_LEVELING_LOGICAL_SIZE
-#    define WEAR_LEVELING_LOGICAL_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 2)
+#    ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+#        define WEAR_LEVELING_LOGICAL_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 4)
+#    else
+#        define WEAR_LEVELING_LOGICAL_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 2)
+#    endif
 #endif // WEAR_LEVELING_LOGICAL_SIZE
 
 // Define how much flash space we have (defaults to lib/pico-sdk/src/boards/include/boards/***)
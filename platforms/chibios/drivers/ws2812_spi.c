@@ -86,27 +86,40 @@
 #define RESET_SIZE (1000 * WS2812_TRST_US / (2 * WS2812_TIMING))
 #define PREAMBLE_SIZE 4
 
-static uint8_t txbuf[PREAMBLE_SIZE + DATA_SIZE + RESET_SIZE] = {0};
+#define TXBUF_SIZE (PREAMBLE_SIZE + DATA_SIZE + RESET_SIZE)
+
+// Frames are sent in the background, so unless the same buffer is sent over and over (circular) or the send is
+// synchronous, the next frame is encoded into a second buffer while the current one is still being shifted out.
+#if !defined(WS2812_SPI_USE_CIRCULAR_BUFFER) && !defined(WS2812_SPI_SYNC)
+#    define WS2812_SPI_DOUBLE_BUFFER
+#    define TXBUF_COUNT 2
+#else
+#    define TXBUF_COUNT 1
+#endif
+
+static uint8_t txbufs[TXBUF_COUNT][TXBUF_SIZE] = {0};
+
+#ifdef WS2812_SPI_DOUBLE_BUFFER
+static uint8_t       tx_front   = 0;     // buffer being sent, or last sent
+static volatile bool tx_busy    = false; // a transfer is in progress
+static volatile bool tx_pending = false; // the other buffer holds a frame waiting to be sent
+
+__attribute__((weak)) void ws2812_frame_sent_cb(void) {}
+#endif
 
 /*
  * As the trick here is to use the SPI to send a huge pattern of 0 and 1 to
  * the ws2812b protocol, we use this helper function to translate bytes into
- * 0s and 1s for the LED (with the appropriate timing).
+ * 0s and 1s for the LED (with the appropriate timing). Each output byte covers
+ * two bits of the input, so a lookup of the four possible patterns does it.
  */
-static uint8_t get_protocol_eq(uint8_t data, int pos) {
-    uint8_t eq = 0;
-    if (data & (1 << (2 * (3 - pos))))
-        eq = 0b1110;
-    else
-        eq = 0b1000;
-    if (data & (2 << (2 * (3 - pos))))
-        eq += 0b11100000;
-    else
-        eq += 0b10000000;
-    return eq;
+static const uint8_t protocol_eq[4] = {0b10001000, 0b10001110, 0b11101000, 0b11101110};
+
+static inline uint8_t get_protocol_eq(uint8_t data, int pos) {
+    return protocol_eq[(data >> (2 * (3 - pos))) & 0b11];
 }
 
-static void set_led_color_rgb(rgb_led_t color, int pos) {
+static void set_led_color_rgb(uint8_t* txbuf, rgb_led_t color, int pos) {
     uint8_t* tx_start = &txbuf[PREAMBLE_SIZE];
 
 #if (WS2812_BYTE_ORDER == WS2812_BYTE_ORDER_GRB)
@@ -133,10 +146,38 @@ static void set_led_color_rgb(rgb_led_t color, int pos) {
 #endif
 #ifdef RGBW
     for (int j = 0; j < 4; j++)
-        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 4 + j] = get_protocol_eq(color.w, j);
+        tx_start[BYTES_FOR_LED * pos + BYTES_FOR_LED_BYTE * 3 + j] = get_protocol_eq(color.w, j);
 #endif
 }
 
+#ifdef WS2812_SPI_DOUBLE_BUFFER
+static void ws2812_start_send_i(uint8_t index) {
+    tx_front = index;
+    tx_busy  = true;
+    spiStartSendI(&WS2812_SPI_DRIVER, TXBUF_SIZE, txbufs[index]);
+}
+
+/*
+ * Runs in interrupt context once a frame, including its trailing reset period,
+ * has been shifted out. Chains straight on to the next frame if one is waiting.
+ */
+static void ws2812_spi_end_cb(SPIDriver* spip) {
+    (void)spip;
+    osalSysLockFromISR();
+    if (tx_pending) {
+        tx_pending = false;
+        ws2812_start_send_i(tx_front ^ 1);
+    } else {
+        tx_busy = false;
+    }
+    osalSysUnlockFromISR();
+    ws2812_frame_sent_cb();
+}
+#    define WS2812_SPI_END_CB ws2812_spi_end_cb
+#else
+#    define WS2812_SPI_END_CB NULL
+#endif
+
 void ws2812_init(void) {
     palSetLineMode(WS2812_DI_PIN, WS2812_MOSI_OUTPUT_MODE);
 
@@ -151,7 +192,7 @@ void ws2812_init(void) {
 #    if SPI_SUPPORTS_CIRCULAR == TRUE
         WS2812_SPI_BUFFER_MODE,
 #    endif
-        NULL, // end_cb
+        WS2812_SPI_END_CB, // end_cb
         PAL_PORT(WS2812_DI_PIN),
         PAL_PAD(WS2812_DI_PIN),
 #    if defined(WB32F3G71xx) || defined(WB32FQ95xx)
@@ -170,8 +211,8 @@ void ws2812_init(void) {
 #    if SPI_SUPPORTS_SLAVE_MODE == TRUE
         false,
 #    endif
-        NULL, // data_cb
-        NULL, // error_cb
+        WS2812_SPI_END_CB, // data_cb
+        NULL,              // error_cb
         PAL_PORT(WS2812_DI_PIN),
         PAL_PAD(WS2812_DI_PIN),
         WS2812_SPI_DIVISOR_CR1_BR_X,
@@ -183,7 +224,7 @@ void ws2812_init(void) {
     spiStart(&WS2812_SPI_DRIVER, &spicfg); /* Setup transfer parameters.       */
     spiSelect(&WS2812_SPI_DRIVER);         /* Slave Select assertion.          */
 #ifdef WS2812_SPI_USE_CIRCULAR_BUFFER
-    spiStartSend(&WS2812_SPI_DRIVER, ARRAY_SIZE(txbuf), txbuf);
+    spiStartSend(&WS2812_SPI_DRIVER, TXBUF_SIZE, txbufs[0]);
 #endif
 }
 
@@ -194,17 +235,33 @@ void ws2812_setleds(rgb_led_t* ledarray, uint16_t leds) {
         s_init = true;
     }
 
-    for (uint8_t i = 0; i < leds; i++) {
-        set_led_color_rgb(ledarray[i], i);
+#ifdef WS2812_SPI_DOUBLE_BUFFER
+    // Drop a frame that is still waiting to be sent, so the end callback leaves the back buffer alone while it's
+    // being encoded. The new frame supersedes it anyway.
+    osalSysLock();
+    tx_pending   = false;
+    uint8_t back = tx_busy ? tx_front ^ 1 : tx_front;
+    osalSysUnlock();
+
+    for (uint16_t i = 0; i < leds; i++) {
+        set_led_color_rgb(txbufs[back], ledarray[i], i);
+    }
+
+    // Send now if the line is idle, otherwise the end callback of the current frame picks it up
+    osalSysLock();
+    if (tx_busy) {
+        tx_pending = true;
+    } else {
+        ws2812_start_send_i(back);
+    }
+    osalSysUnlock();
+#else
+    for (uint16_t i = 0; i < leds; i++) {
+        set_led_color_rgb(txbufs[0], ledarray[i], i);
     }
 
-    // Send async - each led takes ~0.03ms, 50 leds ~1.5ms, animations flushing faster than send will cause issues.
-    // Instead spiSend can be used to send synchronously (or the thread logic can be added back).
-#ifndef WS2812_SPI_USE_CIRCULAR_BUFFER
 #    ifdef WS2812_SPI_SYNC
-    spiSend(&WS2812_SPI_DRIVER, ARRAY_SIZE(txbuf), txbuf);
-#    else
-    spiStartSend(&WS2812_SPI_DRIVER, ARRAY_SIZE(txbuf), txbuf);
+    spiSend(&WS2812_SPI_DRIVER, TXBUF_SIZE, txbufs[0]);
 #    endif
 #endif
 }
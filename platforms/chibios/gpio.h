@@ -43,3 +43,8 @@ typedef ioline_t pin_t;
 #define readPin(pin) palReadLine(pin)
 
 #define togglePin(pin) palToggleLine(pin)
+
+/* Wake up idle_sleep() on any edge, requires MATRIX_IDLE_SLEEP_ENABLE.
+ * Returns false if another pin already uses the same line event. */
+bool enablePinWakeup(pin_t pin);
+void disablePinWakeup(pin_t pin);
@@ -0,0 +1,52 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <ch.h>
+#include <hal.h>
+#include "idle_sleep.h"
+#include "gpio.h"
+
+#if !defined(PAL_USE_CALLBACKS) || (PAL_USE_CALLBACKS != TRUE)
+#    error "MATRIX_IDLE_SLEEP_ENABLE requires PAL_USE_CALLBACKS to be enabled in halconf.h"
+#endif
+
+static BSEMAPHORE_DECL(idle_wakeup, true);
+
+void idle_sleep_wakeup_from_isr(void) {
+    chSysLockFromISR();
+    chBSemSignalI(&idle_wakeup);
+    chSysUnlockFromISR();
+}
+
+static void idle_wakeup_callback(void *arg) {
+    (void)arg;
+    idle_sleep_wakeup_from_isr();
+}
+
+// Line events are shared by pad number across ports on some MCUs (EXTI on STM32), so each pad can only
+// wake up one pin; the owner is tracked so that no pin relies on, or disables, a line that isn't its own
+static pin_t wakeup_owner[PAL_IOPORTS_WIDTH] = {[0 ... PAL_IOPORTS_WIDTH - 1] = NO_PIN};
+
+bool enablePinWakeup(pin_t pin) {
+    pin_t *owner = &wakeup_owner[PAL_PAD(pin)];
+    if (*owner != NO_PIN && *owner != pin) {
+        return false;
+    }
+    *owner = pin;
+    palEnableLineEvent(pin, PAL_EVENT_MODE_BOTH_EDGES);
+    palSetLineCallback(pin, idle_wakeup_callback, NULL);
+    return true;
+}
+
+void disablePinWakeup(pin_t pin) {
+    pin_t *owner = &wakeup_owner[PAL_PAD(pin)];
+    if (*owner == pin) {
+        palDisableLineEvent(pin);
+        *owner = NO_PIN;
+    }
+}
+
+void idle_sleep(uint16_t timeout_ms) {
+    // While this thread is blocked, the idle thread puts the core to sleep with WFI
+    chBSemWaitTimeout(&idle_wakeup, TIME_MS2I(timeout_ms));
+}
@@ -105,3 +105,11 @@ uint16_t timer_elapsed(uint16_t last) {
 uint32_t timer_elapsed32(uint32_t last) {
     return TIMER_DIFF_32(timer_read32(), last);
 }
+
+uint32_t timer_read_raw32(void) {
+#if (PORT_SUPPORTS_RT == TRUE)
+    return chSysGetRealtimeCounterX();
+#else
+    return timer_read32() * 1000;
+#endif
+}
@@ -0,0 +1,21 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * \brief Puts the MCU into a low power state for up to `timeout_ms` milliseconds.
+ *
+ * Returns early on an edge of a pin passed to `enablePinWakeup()`, where the platform
+ * supports it, and may also return early on any other interrupt.
+ */
+void idle_sleep(uint16_t timeout_ms);
+
+/**
+ * \brief Ends an ongoing `idle_sleep()` early. Safe to call from an interrupt.
+ *
+ * For pin callbacks that replace the one installed by `enablePinWakeup()`.
+ */
+void idle_sleep_wakeup_from_isr(void);
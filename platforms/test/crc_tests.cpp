@@ -0,0 +1,121 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "crc.h"
+}
+
+static const char check_input[] = "123456789";
+
+#if defined(CRC8_USE_TABLE) || defined(CRC8_USE_SLICING)
+// The table driven variants have always used polynomial 0x07, both halves of a split keyboard are built alike
+static const uint8_t crc8_poly  = 0x07;
+static const uint8_t crc8_check = 0xfb;
+#else
+static const uint8_t crc8_poly  = 0x31;
+static const uint8_t crc8_check = 0xf7;
+#endif
+
+static uint8_t crc8_reference(const std::vector<uint8_t> &data) {
+    uint8_t crc = 0xff;
+    for (uint8_t byte : data) {
+        crc ^= byte;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ crc8_poly) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint16_t crc16_reference(const std::vector<uint8_t> &data) {
+    uint16_t crc = 0xffff;
+    for (uint8_t byte : data) {
+        crc ^= (uint16_t)byte << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static uint32_t crc32_reference(const std::vector<uint8_t> &data) {
+    uint32_t crc = 0xffffffff;
+    for (uint8_t byte : data) {
+        crc ^= byte;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xedb88320 : crc >> 1;
+        }
+    }
+    return ~crc;
+}
+
+static std::vector<uint8_t> pattern(size_t length, uint32_t seed) {
+    std::vector<uint8_t> data(length);
+    for (auto &byte : data) {
+        seed = seed * 1103515245 + 12345;
+        byte = seed >> 16;
+    }
+    return data;
+}
+
+class CRC : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        crc_init();
+    }
+};
+
+TEST_F(CRC, CheckValues) {
+    EXPECT_EQ(crc8(check_input, sizeof(check_input) - 1), crc8_check);
+    EXPECT_EQ(crc16(check_input, sizeof(check_input) - 1), 0x29b1);
+    EXPECT_EQ(crc32(check_input, sizeof(check_input) - 1), 0xcbf43926);
+}
+
+TEST_F(CRC, EmptyInput) {
+    EXPECT_EQ(crc8(check_input, 0), 0xff);
+    EXPECT_EQ(crc16(check_input, 0), 0xffff);
+    EXPECT_EQ(crc32(check_input, 0), 0);
+}
+
+TEST_F(CRC, MatchesReferenceForEveryLength) {
+    for (size_t length = 0; length <= 70; length++) {
+        auto data = pattern(length, length);
+        EXPECT_EQ(crc8(data.data(), length), crc8_reference(data)) << "length " << length;
+        EXPECT_EQ(crc16(data.data(), length), crc16_reference(data)) << "length " << length;
+        EXPECT_EQ(crc32(data.data(), length), crc32_reference(data)) << "length " << length;
+    }
+}
+
+TEST_F(CRC, MatchesReferenceAtEveryAlignment) {
+    auto data = pattern(64, 42);
+    for (size_t offset = 0; offset < 4; offset++) {
+        std::vector<uint8_t> slice(data.begin() + offset, data.begin() + offset + 33);
+        EXPECT_EQ(crc8(&data[offset], slice.size()), crc8_reference(slice)) << "offset " << offset;
+    }
+}
+
+template <typename F>
+static double nanoseconds_per_byte(F &&checksum, const std::vector<uint8_t> &data) {
+    const int         iterations = 20000;
+    volatile uint32_t sink       = 0;
+    auto              start      = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        sink = sink + checksum(data.data(), data.size());
+    }
+    auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return elapsed / ((double)iterations * data.size());
+}
+
+// Not an assertion, prints the throughput of this build's variant so the crc_* tests can be compared
+TEST_F(CRC, Benchmark) {
+    for (size_t length : {8, 32, 256}) {
+        auto data = pattern(length, 7);
+        std::printf("crc length %3zu: crc8 %6.2f ns/B, crc16 %6.2f ns/B, crc32 %6.2f ns/B\n", length, nanoseconds_per_byte(crc8, data), nanoseconds_per_byte(crc16, data), nanoseconds_per_byte(crc32, data));
+    }
+}
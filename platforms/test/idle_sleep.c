@@ -0,0 +1,12 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "idle_sleep.h"
+#include "wait.h"
+
+// Sleeping simply lets the simulated time pass
+void idle_sleep(uint16_t timeout_ms) {
+    wait_ms(timeout_ms);
+}
+
+void idle_sleep_wakeup_from_isr(void) {}
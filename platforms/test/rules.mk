@@ -23,3 +23,11 @@ eeprom_legacy_emulated_flash_SRC := \
 	$(PLATFORM_PATH)/chibios/drivers/eeprom/eeprom_legacy_emulated_flash.c
 eeprom_legacy_emulated_flash_tiny_SRC := $(eeprom_legacy_emulated_flash_SRC)
 eeprom_legacy_emulated_flash_large_SRC := $(eeprom_legacy_emulated_flash_SRC)
+
+crc_bitwise_SRC := \
+	$(QUANTUM_PATH)/crc.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/crc_tests.cpp
+crc_table_DEFS := -DCRC8_USE_TABLE
+crc_table_SRC := $(crc_bitwise_SRC)
+crc_slicing_DEFS := -DCRC8_USE_SLICING
+crc_slicing_SRC := $(crc_bitwise_SRC)
@@ -68,6 +68,10 @@ uint32_t timer_elapsed32(uint32_t last) {
     return TIMER_DIFF_32(timer_read32(), last);
 }
 
+uint32_t timer_read_raw32(void) {
+    return current_time * 1000;
+}
+
 void set_time(uint32_t t) {
     current_time   = t;
     access_counter = 0;
@@ -43,6 +43,13 @@ uint32_t timer_read32(void);
 uint16_t timer_elapsed(uint16_t last);
 uint32_t timer_elapsed32(uint32_t last);
 
+/**
+ * High resolution timestamp for timing short stretches of code, in platform ticks: the realtime counter on ChibiOS
+ * (CPU cycles on Cortex-M3 and up), timer0 ticks (`F_CPU / TIMER_PRESCALER`) on AVR, and microseconds in steps of a
+ * millisecond otherwise. Only differences between two readings are meaningful.
+ */
+uint32_t timer_read_raw32(void);
+
 // Utility functions to check if a future time has expired & autmatically handle time wrapping if checked / reset frequently (half of max value)
 #define timer_expired(current, future) ((uint16_t)(current - future) < UINT16_MAX / 2)
 #define timer_expired32(current, future) ((uint32_t)(current - future) < UINT32_MAX / 2)
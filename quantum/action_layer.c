@@ -1,11 +1,13 @@
 #include <limits.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "keyboard.h"
 #include "action.h"
 #include "encoder.h"
 #include "util.h"
 #include "action_layer.h"
+#include "keymap_common.h"
 
 /** \brief Default Layer State
  */
@@ -316,16 +318,15 @@ action_t store_or_get_action(bool pressed, keypos_t key) {
 #endif
 }
 
-/** \brief Layer switch get layer
+#ifndef NO_ACTION_LAYER
+/** \brief Layer switch resolve layer
  *
- * Gets the layer based on key info
+ * Walks the active layers from the top and returns the first one where the key isn't transparent
  */
-uint8_t layer_switch_get_layer(keypos_t key) {
-#ifndef NO_ACTION_LAYER
+static uint8_t layer_switch_resolve_layer(layer_state_t layers, keypos_t key) {
     action_t action;
     action.code = ACTION_TRANSPARENT;
 
-    layer_state_t layers = layer_state | default_layer_state;
     /* check top layer first */
     for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
         if (layers & ((layer_state_t)1 << i)) {
@@ -337,6 +338,89 @@ uint8_t layer_switch_get_layer(keypos_t key) {
     }
     /* fall back to layer 0 */
     return 0;
+}
+#endif
+
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_LOOKUP_CACHE)
+/** \brief resolved layer cache
+ *
+ * Per-key effective layer and keycode for the layer state in `layer_lookup_cache_state`.
+ * Entries are filled lazily and dropped whenever the layer state or the keymap changes.
+ */
+static uint8_t       layer_lookup_cache_layer[MATRIX_ROWS * MATRIX_COLS];
+static uint16_t      layer_lookup_cache_keycode[MATRIX_ROWS * MATRIX_COLS];
+static uint8_t       layer_lookup_cache_valid[((MATRIX_ROWS * MATRIX_COLS) + (CHAR_BIT)-1) / (CHAR_BIT)];
+static layer_state_t layer_lookup_cache_state = 0;
+
+/** \brief Invalidate resolved layer cache
+ *
+ * Drops every cached entry. Call this if keymap_key_to_keycode() results change outside of dynamic keymap writes.
+ */
+void layer_lookup_cache_invalidate(void) {
+    memset(layer_lookup_cache_valid, 0, sizeof(layer_lookup_cache_valid));
+}
+
+/** \brief Invalidate resolved layer cache entry
+ *
+ * Drops the cached entry of a single key, e.g. after its keycode was changed on any layer.
+ */
+void layer_lookup_cache_invalidate_key(uint8_t row, uint8_t col) {
+    if (row < MATRIX_ROWS && col < MATRIX_COLS) {
+        const uint16_t entry_number = (uint16_t)(row * MATRIX_COLS) + col;
+        layer_lookup_cache_valid[entry_number / (CHAR_BIT)] &= ~(1U << (entry_number % (CHAR_BIT)));
+    }
+}
+
+/** \brief Resolved layer cache lookup
+ *
+ * Returns the cache entry of a matrix key, resolving and storing it first if needed.
+ */
+static uint16_t layer_lookup_cache_entry(keypos_t key) {
+    const layer_state_t layers = layer_state | default_layer_state;
+    if (layers != layer_lookup_cache_state) {
+        layer_lookup_cache_invalidate();
+        layer_lookup_cache_state = layers;
+    }
+
+    const uint16_t entry_number = (uint16_t)(key.row * MATRIX_COLS) + key.col;
+    const uint16_t storage_idx  = entry_number / (CHAR_BIT);
+    const uint8_t  storage_bit  = entry_number % (CHAR_BIT);
+    if (!(layer_lookup_cache_valid[storage_idx] & (1U << storage_bit))) {
+        const uint8_t layer                      = layer_switch_resolve_layer(layers, key);
+        layer_lookup_cache_layer[entry_number]   = layer;
+        layer_lookup_cache_keycode[entry_number] = keymap_key_to_keycode(layer, key);
+        layer_lookup_cache_valid[storage_idx] |= 1U << storage_bit;
+    }
+    return entry_number;
+}
+
+/** \brief Resolved layer cache keycode
+ *
+ * Gets the keycode of a key on the given layer, from the cache when that layer is the one the key resolves to.
+ */
+uint16_t layer_lookup_cache_get_keycode(uint8_t layer, keypos_t key) {
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        const uint16_t entry_number = layer_lookup_cache_entry(key);
+        if (layer_lookup_cache_layer[entry_number] == layer) {
+            return layer_lookup_cache_keycode[entry_number];
+        }
+    }
+    return keymap_key_to_keycode(layer, key);
+}
+#endif
+
+/** \brief Layer switch get layer
+ *
+ * Gets the layer based on key info
+ */
+uint8_t layer_switch_get_layer(keypos_t key) {
+#ifndef NO_ACTION_LAYER
+#    ifdef LAYER_LOOKUP_CACHE
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        return layer_lookup_cache_layer[layer_lookup_cache_entry(key)];
+    }
+#    endif
+    return layer_switch_resolve_layer(layer_state | default_layer_state, key);
 #else
     return get_highest_layer(default_layer_state);
 #endif
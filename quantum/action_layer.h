@@ -166,5 +166,16 @@ action_t store_or_get_action(bool pressed, keypos_t key);
 /* return the topmost non-transparent layer currently associated with key */
 uint8_t layer_switch_get_layer(keypos_t key);
 
+/* resolved layer/keycode cache, see LAYER_LOOKUP_CACHE */
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_LOOKUP_CACHE)
+void     layer_lookup_cache_invalidate(void);
+void     layer_lookup_cache_invalidate_key(uint8_t row, uint8_t col);
+uint16_t layer_lookup_cache_get_keycode(uint8_t layer, keypos_t key);
+#else
+#    define layer_lookup_cache_invalidate()
+#    define layer_lookup_cache_invalidate_key(row, col)
+#    define layer_lookup_cache_get_keycode(layer, key) keymap_key_to_keycode(layer, key)
+#endif
+
 /* return action depending on current layer status */
 action_t layer_switch_get_action(keypos_t key);
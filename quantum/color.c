@@ -19,6 +19,48 @@
 #include "progmem.h"
 #include "util.h"
 
+#ifdef HSV_TO_RGB_USE_TABLE
+// Hue sector (0-6) of every hue, h * 6 / 255
+static const uint8_t HUE_SECTOR[256] PROGMEM = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+      1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,
+      2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,
+      2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,   2,
+      3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
+      3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   3,
+      3,   3,   3,   3,   3,   3,   3,   3,   3,   3,   4,   4,   4,   4,   4,   4,
+      4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
+      4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,   4,
+      4,   4,   4,   4,   4,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,
+      5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   5,   6,
+};
+
+// Position within the hue sector of every hue, scaled to 0-255
+static const uint8_t HUE_REMAINDER[256] PROGMEM = {
+      0,   6,  12,  18,  24,  30,  36,  42,  48,  54,  60,  66,  72,  78,  84,  90,
+     96, 102, 108, 114, 120, 126, 132, 138, 144, 150, 156, 162, 168, 174, 180, 186,
+    192, 198, 204, 210, 216, 222, 228, 234, 240, 246, 252,   3,   9,  15,  21,  27,
+     33,  39,  45,  51,  57,  63,  69,  75,  81,  87,  93,  99, 105, 111, 117, 123,
+    129, 135, 141, 147, 153, 159, 165, 171, 177, 183, 189, 195, 201, 207, 213, 219,
+    225, 231, 237, 243, 249,   0,   6,  12,  18,  24,  30,  36,  42,  48,  54,  60,
+     66,  72,  78,  84,  90,  96, 102, 108, 114, 120, 126, 132, 138, 144, 150, 156,
+    162, 168, 174, 180, 186, 192, 198, 204, 210, 216, 222, 228, 234, 240, 246, 252,
+      3,   9,  15,  21,  27,  33,  39,  45,  51,  57,  63,  69,  75,  81,  87,  93,
+     99, 105, 111, 117, 123, 129, 135, 141, 147, 153, 159, 165, 171, 177, 183, 189,
+    195, 201, 207, 213, 219, 225, 231, 237, 243, 249,   0,   6,  12,  18,  24,  30,
+     36,  42,  48,  54,  60,  66,  72,  78,  84,  90,  96, 102, 108, 114, 120, 126,
+    132, 138, 144, 150, 156, 162, 168, 174, 180, 186, 192, 198, 204, 210, 216, 222,
+    228, 234, 240, 246, 252,   3,   9,  15,  21,  27,  33,  39,  45,  51,  57,  63,
+     69,  75,  81,  87,  93,  99, 105, 111, 117, 123, 129, 135, 141, 147, 153, 159,
+    165, 171, 177, 183, 189, 195, 201, 207, 213, 219, 225, 231, 237, 243, 249,   0,
+};
+#endif
+
 RGB hsv_to_rgb_impl(HSV hsv, bool use_cie) {
     RGB      rgb;
     uint8_t  region, remainder, p, q, t;
@@ -53,8 +95,13 @@ RGB hsv_to_rgb_impl(HSV hsv, bool use_cie) {
     v = hsv.v;
 #endif
 
+#ifdef HSV_TO_RGB_USE_TABLE
+    region    = pgm_read_byte(&HUE_SECTOR[h]);
+    remainder = pgm_read_byte(&HUE_REMAINDER[h]);
+#else
     region    = h * 6 / 255;
     remainder = (h * 2 - region * 85) * 3;
+#endif
 
     p = (v * (255 - s)) >> 8;
     q = (v * (255 - ((s * remainder) >> 8))) >> 8;
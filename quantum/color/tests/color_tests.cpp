@@ -0,0 +1,100 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "color.h"
+#include "led_tables.h"
+}
+
+// The original arithmetic conversion, which every variant has to match exactly
+static RGB hsv_to_rgb_reference(HSV hsv, bool use_cie) {
+    uint8_t v = hsv.v;
+#ifdef USE_CIE1931_CURVE
+    if (use_cie) {
+        v = CIE1931_CURVE[hsv.v];
+    }
+#endif
+    RGB rgb;
+    if (hsv.s == 0) {
+        rgb.r = rgb.g = rgb.b = v;
+        return rgb;
+    }
+
+    uint16_t h         = hsv.h;
+    uint16_t s         = hsv.s;
+    uint8_t  region    = h * 6 / 255;
+    uint8_t  remainder = (h * 2 - region * 85) * 3;
+    uint8_t  p         = (v * (255 - s)) >> 8;
+    uint8_t  q         = (v * (255 - ((s * remainder) >> 8))) >> 8;
+    uint8_t  t         = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+
+    const uint8_t sectors[7][3] = {{v, t, p}, {q, v, p}, {p, v, t}, {p, q, v}, {t, p, v}, {v, p, q}, {v, t, p}};
+    rgb.r                       = sectors[region][0];
+    rgb.g                       = sectors[region][1];
+    rgb.b                       = sectors[region][2];
+    return rgb;
+}
+
+static bool rgb_equal(const RGB &a, const RGB &b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+static std::vector<HSV> every_hsv(uint8_t v) {
+    std::vector<HSV> hsv;
+    for (int h = 0; h < 256; h++) {
+        for (int s = 0; s < 256; s++) {
+            hsv.push_back({(uint8_t)h, (uint8_t)s, v});
+        }
+    }
+    return hsv;
+}
+
+class Color : public ::testing::Test {};
+
+TEST_F(Color, MatchesReference) {
+    for (int v = 0; v < 256; v++) {
+        for (auto &hsv : every_hsv(v)) {
+            ASSERT_TRUE(rgb_equal(hsv_to_rgb_nocie(hsv), hsv_to_rgb_reference(hsv, false))) << "hsv " << (int)hsv.h << "," << (int)hsv.s << "," << (int)hsv.v;
+#ifdef USE_CIE1931_CURVE
+            ASSERT_TRUE(rgb_equal(hsv_to_rgb(hsv), hsv_to_rgb_reference(hsv, true))) << "hsv " << (int)hsv.h << "," << (int)hsv.s << "," << (int)hsv.v;
+#endif
+        }
+    }
+}
+
+template <typename F>
+static double nanoseconds_per_frame(F &&convert, const std::vector<HSV> &hsv, std::vector<RGB> &rgb) {
+    const int iterations = 20000;
+    auto      start      = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        convert(hsv, rgb);
+        asm volatile("" : : "r"(rgb.data()) : "memory");
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+// Not an assertion, prints the per-frame cost of this build's variant so the color_* tests can be compared
+TEST_F(Color, Benchmark) {
+    for (size_t leds : {50, 100, 200}) {
+        std::vector<HSV> hsv(leds);
+        std::vector<RGB> rgb(leds);
+        for (size_t i = 0; i < leds; i++) {
+            hsv[i] = {(uint8_t)(i * 37), (uint8_t)(255 - i), (uint8_t)(128 + i / 2)};
+        }
+
+        double ns = nanoseconds_per_frame(
+            [](const std::vector<HSV> &in, std::vector<RGB> &out) {
+                for (size_t i = 0; i < in.size(); i++) {
+                    out[i] = hsv_to_rgb(in[i]);
+                }
+            },
+            hsv, rgb);
+        std::printf("hsv_to_rgb %3zu leds: %8.1f ns/frame\n", leds, ns);
+    }
+}
@@ -0,0 +1,7 @@
+color_SRC := \
+	$(QUANTUM_PATH)/color.c \
+	$(QUANTUM_PATH)/color/tests/color_tests.cpp
+color_table_DEFS := -DHSV_TO_RGB_USE_TABLE -DUSE_CIE1931_CURVE
+color_table_SRC := \
+	$(color_SRC) \
+	$(QUANTUM_PATH)/led_tables.c
@@ -33,13 +33,45 @@ typedef uint_least8_t crc_t;
 /**
  * Initialize crc subsystem.
  */
-__attribute__((weak)) void crc_init(void);
+void crc_init(void);
 
 /**
  * Generate CRC8 value from given data.
  *
+ * Weakly defined as crc8_software(), `CRC_DRIVER = vendor` replaces it with
+ * the MCU's CRC peripheral where one can compute it.
+ *
+ * \param[in] data     Pointer to a buffer of \a data_len bytes.
+ * \param[in] data_len Number of bytes in the \a data buffer.
+ * \return             The calculated crc value.
+ */
+uint8_t crc8(const void *data, size_t data_len);
+
+/**
+ * Generate CRC-16/CCITT-FALSE value from given data.
+ *
  * \param[in] data     Pointer to a buffer of \a data_len bytes.
  * \param[in] data_len Number of bytes in the \a data buffer.
  * \return             The calculated crc value.
  */
-__attribute__((weak)) uint8_t crc8(const void *data, size_t data_len);
+uint16_t crc16(const void *data, size_t data_len);
+
+/**
+ * Generate CRC-32 (as used by zlib and Ethernet) value from given data.
+ *
+ * \param[in] data     Pointer to a buffer of \a data_len bytes.
+ * \param[in] data_len Number of bytes in the \a data buffer.
+ * \return             The calculated crc value.
+ */
+uint32_t crc32(const void *data, size_t data_len);
+
+/**
+ * Software implementations, always available so that hardware backends can
+ * fall back to them, e.g. for inputs too short to be worth the setup.
+ *
+ * crc8_software() is bit by bit by default, table driven with
+ * `CRC8_USE_TABLE` and takes four bytes per step with `CRC8_USE_SLICING`.
+ */
+uint8_t  crc8_software(const void *data, size_t data_len);
+uint16_t crc16_software(const void *data, size_t data_len);
+uint32_t crc32_software(const void *data, size_t data_len);
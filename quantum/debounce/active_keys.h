@@ -0,0 +1,46 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/*
+Shared bookkeeping for the per-key debounce algorithms.
+
+One bit per key records whether the debounce counter of that key is running.
+The algorithms compare raw and cooked rows a whole matrix_row_t at a time and
+only visit the counters of keys whose bit is set, so the cost of a scan grows
+with the number of keys bouncing rather than with the size of the matrix.
+
+The counter of a key is only meaningful while its active bit is set.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "matrix.h"
+
+static matrix_row_t *debounce_active_keys;
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+static inline void debounce_active_keys_init(uint8_t num_rows) {
+    debounce_active_keys = (matrix_row_t *)calloc(num_rows, sizeof(matrix_row_t));
+}
+
+static inline void debounce_active_keys_free(void) {
+    free(debounce_active_keys);
+    debounce_active_keys = NULL;
+}
+
+/**
+ * \brief Removes the lowest set bit from `bits` and returns its column.
+ *
+ * Used to walk the active keys of a row:
+ *   for (matrix_row_t bits = debounce_active_keys[row]; bits;) {
+ *       uint8_t col = debounce_active_keys_next(&bits);
+ *   }
+ */
+static inline uint8_t debounce_active_keys_next(matrix_row_t *bits) {
+    uint8_t col = __builtin_ctzl((unsigned long)*bits);
+    *bits &= *bits - 1;
+    return col;
+}
@@ -50,31 +50,27 @@ typedef struct {
 } debounce_counter_t;
 
 #if DEBOUNCE > 0
+#    include "active_keys.h"
+
 static debounce_counter_t *debounce_counters;
 static fast_timer_t        last_time;
 static bool                counters_need_update;
 static bool                matrix_need_update;
 static bool                cooked_changed;
 
-#    define DEBOUNCE_ELAPSED 0
-
 static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time);
 static void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows);
 
 // we use num_rows rather than MATRIX_ROWS to support split keyboards
 void debounce_init(uint8_t num_rows) {
     debounce_counters = malloc(num_rows * MATRIX_COLS * sizeof(debounce_counter_t));
-    int i             = 0;
-    for (uint8_t r = 0; r < num_rows; r++) {
-        for (uint8_t c = 0; c < MATRIX_COLS; c++) {
-            debounce_counters[i++].time = DEBOUNCE_ELAPSED;
-        }
-    }
+    debounce_active_keys_init(num_rows);
 }
 
 void debounce_free(void) {
     free(debounce_counters);
     debounce_counters = NULL;
+    debounce_active_keys_free();
 }
 
 bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
@@ -108,68 +104,75 @@ bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool
 }
 
 static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time) {
-    debounce_counter_t *debounce_pointer = debounce_counters;
-
     counters_need_update = false;
     matrix_need_update   = false;
 
     for (uint8_t row = 0; row < num_rows; row++) {
-        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            matrix_row_t col_mask = (ROW_SHIFTER << col);
-
-            if (debounce_pointer->time != DEBOUNCE_ELAPSED) {
-                if (debounce_pointer->time <= elapsed_time) {
-                    debounce_pointer->time = DEBOUNCE_ELAPSED;
-
-                    if (debounce_pointer->pressed) {
-                        // key-down: eager
-                        matrix_need_update = true;
-                    } else {
-                        // key-up: defer
-                        matrix_row_t cooked_next = (cooked[row] & ~col_mask) | (raw[row] & col_mask);
-                        cooked_changed |= cooked_next ^ cooked[row];
-                        cooked[row] = cooked_next;
-                    }
+        matrix_row_t expired  = 0;
+        matrix_row_t released = 0;
+
+        for (matrix_row_t bits = debounce_active_keys[row]; bits;) {
+            uint8_t             col              = debounce_active_keys_next(&bits);
+            debounce_counter_t *debounce_pointer = &debounce_counters[row * MATRIX_COLS + col];
+
+            if (debounce_pointer->time <= elapsed_time) {
+                expired |= (ROW_SHIFTER << col);
+
+                if (debounce_pointer->pressed) {
+                    // key-down: eager
+                    matrix_need_update = true;
                 } else {
-                    debounce_pointer->time -= elapsed_time;
-                    counters_need_update = true;
+                    // key-up: defer
+                    released |= (ROW_SHIFTER << col);
                 }
+            } else {
+                debounce_pointer->time -= elapsed_time;
+                counters_need_update = true;
             }
-            debounce_pointer++;
+        }
+
+        debounce_active_keys[row] &= ~expired;
+        if (released) {
+            matrix_row_t cooked_next = (cooked[row] & ~released) | (raw[row] & released);
+            cooked_changed |= cooked_next ^ cooked[row];
+            cooked[row] = cooked_next;
         }
     }
 }
 
 static void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
-    debounce_counter_t *debounce_pointer = debounce_counters;
-
     matrix_need_update = false;
 
     for (uint8_t row = 0; row < num_rows; row++) {
-        matrix_row_t delta = raw[row] ^ cooked[row];
-        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
-            matrix_row_t col_mask = (ROW_SHIFTER << col);
-
-            if (delta & col_mask) {
-                if (debounce_pointer->time == DEBOUNCE_ELAPSED) {
-                    debounce_pointer->pressed = (raw[row] & col_mask);
-                    debounce_pointer->time    = DEBOUNCE;
-                    counters_need_update      = true;
-
-                    if (debounce_pointer->pressed) {
-                        // key-down: eager
-                        cooked[row] ^= col_mask;
-                        cooked_changed = true;
-                    }
-                }
-            } else if (debounce_pointer->time != DEBOUNCE_ELAPSED) {
-                if (!debounce_pointer->pressed) {
-                    // key-up: defer
-                    debounce_pointer->time = DEBOUNCE_ELAPSED;
-                }
+        matrix_row_t delta   = raw[row] ^ cooked[row];
+        matrix_row_t started = delta & ~debounce_active_keys[row];
+
+        // key-up: defer, a release that went back to pressed is dropped
+        for (matrix_row_t bits = debounce_active_keys[row] & ~delta; bits;) {
+            uint8_t col = debounce_active_keys_next(&bits);
+
+            if (!debounce_counters[row * MATRIX_COLS + col].pressed) {
+                debounce_active_keys[row] &= ~(ROW_SHIFTER << col);
             }
-            debounce_pointer++;
         }
+
+        for (matrix_row_t bits = started; bits;) {
+            uint8_t             col              = debounce_active_keys_next(&bits);
+            matrix_row_t        col_mask         = (ROW_SHIFTER << col);
+            debounce_counter_t *debounce_pointer = &debounce_counters[row * MATRIX_COLS + col];
+
+            debounce_pointer->pressed = (raw[row] & col_mask);
+            debounce_pointer->time    = DEBOUNCE;
+            counters_need_update      = true;
+
+            if (debounce_pointer->pressed) {
+                // key-down: eager
+                cooked[row] ^= col_mask;
+                cooked_changed = true;
+            }
+        }
+
+        debounce_active_keys[row] |= started;
     }
 }
 
@@ -256,3 +256,16 @@ TEST_F(DebounceTest, AsyncTickOneKeyShort1) {
     async_time_jumps_ = DEBOUNCE;
     runEvents();
 }
+
+TEST_F(DebounceTest, ManyKeysAcrossRows) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {{0, 0, DOWN}, {1, 5, DOWN}, {3, 9, DOWN}}, {}},
+        /* Bounce one key back while another one starts */
+        {2, {{1, 5, UP}, {2, 3, DOWN}}, {}},
+
+        {5, {}, {{0, 0, DOWN}, {3, 9, DOWN}}},
+        {7, {}, {{2, 3, DOWN}}},
+    });
+    runEvents();
+}
@@ -269,3 +269,15 @@ TEST_F(DebounceTest, AsyncTickOneKeyShort1) {
     async_time_jumps_ = DEBOUNCE;
     runEvents();
 }
+
+TEST_F(DebounceTest, ManyKeysAcrossRows) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {{0, 0, DOWN}, {1, 5, DOWN}, {3, 9, DOWN}}, {{0, 0, DOWN}, {1, 5, DOWN}, {3, 9, DOWN}}},
+        /* Release one key while it is still debouncing and press another one */
+        {2, {{1, 5, UP}, {2, 3, DOWN}}, {{2, 3, DOWN}}},
+
+        {5, {}, {{1, 5, UP}}},
+    });
+    runEvents();
+}
@@ -9,34 +9,112 @@
 #    define MAX_DEFERRED_EXECUTORS 8
 #endif
 
+#if MAX_DEFERRED_EXECUTORS > 255
+#    error MAX_DEFERRED_EXECUTORS must be no more than 255
+#endif
+
 //------------------------------------
 // Helpers
 //
+// Each table is an indexed binary min-heap keyed on trigger time, stored within the entries themselves so that existing
+// zero-initialised tables keep working. Entry `i`'s `heap_slot` holds the slot at heap position `i`, and its
+// `heap_position` holds where slot `i` sits in the heap. The first `heap_count` positions (kept in the first entry) are
+// the queued executors in heap order, the remaining positions are the free slots. Tokens encode their slot, so lookups
+// and allocation don't need to search the table.
+//
 
-static deferred_token current_token = 0;
+#define HEAP_COUNT(table) ((table)[0].heap_count)
+#define HEAP_ENTRY(table, position) (&(table)[(table)[position].heap_slot])
 
-static inline bool token_can_be_used(deferred_executor_t *table, size_t table_count, deferred_token token) {
-    if (token == INVALID_DEFERRED_TOKEN) {
-        return false;
-    }
-    for (int i = 0; i < table_count; ++i) {
-        if (table[i].token == token) {
-            return false;
+static inline bool table_is_valid(deferred_executor_t *table, size_t table_count) {
+    // Slot indices and tokens are 8-bit
+    return table && table_count > 0 && table_count <= UINT8_MAX;
+}
+
+static inline bool trigger_before(uint32_t a, uint32_t b) {
+    return ((int32_t)TIMER_DIFF_32(a, b)) < 0;
+}
+
+static inline void heap_swap(deferred_executor_t *table, uint8_t a, uint8_t b) {
+    uint8_t slot_a              = table[a].heap_slot;
+    uint8_t slot_b              = table[b].heap_slot;
+    table[a].heap_slot          = slot_b;
+    table[b].heap_slot          = slot_a;
+    table[slot_a].heap_position = b;
+    table[slot_b].heap_position = a;
+}
+
+static void heap_sift_up(deferred_executor_t *table, uint8_t position) {
+    while (position > 0) {
+        uint8_t parent = (position - 1) / 2;
+        if (!trigger_before(HEAP_ENTRY(table, position)->trigger_time, HEAP_ENTRY(table, parent)->trigger_time)) {
+            break;
         }
+        heap_swap(table, position, parent);
+        position = parent;
     }
-    return true;
 }
 
-static inline deferred_token allocate_token(deferred_executor_t *table, size_t table_count) {
-    deferred_token first = ++current_token;
-    while (!token_can_be_used(table, table_count, current_token)) {
-        ++current_token;
-        if (current_token == first) {
-            // If we've looped back around to the first, everything is already allocated (yikes!). Need to exit with a failure.
-            return INVALID_DEFERRED_TOKEN;
+static void heap_sift_down(deferred_executor_t *table, uint8_t position) {
+    uint8_t count = HEAP_COUNT(table);
+    while (true) {
+        uint8_t earliest = position;
+        uint8_t left     = 2 * position + 1;
+        uint8_t right    = left + 1;
+        if (left < count && trigger_before(HEAP_ENTRY(table, left)->trigger_time, HEAP_ENTRY(table, earliest)->trigger_time)) {
+            earliest = left;
+        }
+        if (right < count && trigger_before(HEAP_ENTRY(table, right)->trigger_time, HEAP_ENTRY(table, earliest)->trigger_time)) {
+            earliest = right;
         }
+        if (earliest == position) {
+            break;
+        }
+        heap_swap(table, position, earliest);
+        position = earliest;
     }
-    return current_token;
+}
+
+static inline void heap_update(deferred_executor_t *table, uint8_t position) {
+    // Only one of these moves it, depending on whether the trigger time went up or down
+    uint8_t slot = table[position].heap_slot;
+    heap_sift_up(table, position);
+    heap_sift_down(table, table[slot].heap_position);
+}
+
+static void heap_remove(deferred_executor_t *table, deferred_executor_t *entry) {
+    // Swap the last queued entry into the hole, leaving the removed slot as the first free one
+    uint8_t position = entry->heap_position;
+    uint8_t last     = --HEAP_COUNT(table);
+    heap_swap(table, position, last);
+    if (position < last) {
+        heap_update(table, position);
+    }
+
+    // The token is kept, so that the next allocation of this slot moves on to a new one
+    entry->trigger_time = 0;
+    entry->callback     = NULL;
+    entry->cb_arg       = NULL;
+}
+
+static inline deferred_executor_t *find_entry(deferred_executor_t *table, size_t table_count, deferred_token token) {
+    if (token == INVALID_DEFERRED_TOKEN) {
+        return NULL;
+    }
+    uint8_t              slot  = (token - 1) % table_count;
+    deferred_executor_t *entry = &table[slot];
+    if (entry->heap_position >= HEAP_COUNT(table) || entry->token != token) {
+        return NULL;
+    }
+    return entry;
+}
+
+static inline deferred_token allocate_token(deferred_executor_t *entry, uint8_t slot, size_t table_count) {
+    // Tokens for a slot step through slot+1, slot+1+table_count, ... so recently cancelled tokens aren't reused straight away
+    if (entry->token == INVALID_DEFERRED_TOKEN || entry->token > UINT8_MAX - table_count) {
+        return slot + 1;
+    }
+    return entry->token + table_count;
 }
 
 //------------------------------------
@@ -45,112 +123,121 @@ static inline deferred_token allocate_token(deferred_executor_t *table, size_t t
 
 deferred_token defer_exec_advanced(deferred_executor_t *table, size_t table_count, uint32_t delay_ms, deferred_exec_callback callback, void *cb_arg) {
     // Ignore queueing if the table isn't valid, it's a zero-time delay, or the token is not valid
-    if (!table || table_count == 0 || delay_ms == 0 || !callback) {
+    if (!table_is_valid(table, table_count) || delay_ms == 0 || !callback) {
         return INVALID_DEFERRED_TOKEN;
     }
 
-    // Find an unused slot and claim it
-    for (int i = 0; i < table_count; ++i) {
-        deferred_executor_t *entry = &table[i];
-        if (entry->token == INVALID_DEFERRED_TOKEN) {
-            // Work out the new token value, dropping out if none were available
-            deferred_token token = allocate_token(table, table_count);
-            if (token == INVALID_DEFERRED_TOKEN) {
-                return false;
-            }
+    // None available
+    uint8_t position = HEAP_COUNT(table);
+    if (position >= table_count) {
+        return INVALID_DEFERRED_TOKEN;
+    }
 
-            // Set up the executor table entry
-            entry->token        = current_token;
-            entry->trigger_time = timer_read32() + delay_ms;
-            entry->callback     = callback;
-            entry->cb_arg       = cb_arg;
-            return current_token;
+    // An empty table may not have been set up yet, start from the identity permutation
+    if (position == 0) {
+        for (uint8_t i = 0; i < table_count; ++i) {
+            table[i].heap_slot     = i;
+            table[i].heap_position = i;
         }
     }
 
-    // None available
-    return INVALID_DEFERRED_TOKEN;
+    // Claim the first free slot, and set up the executor table entry
+    uint8_t              slot  = table[position].heap_slot;
+    deferred_executor_t *entry = &table[slot];
+    entry->token               = allocate_token(entry, slot, table_count);
+    entry->trigger_time        = timer_read32() + delay_ms;
+    entry->callback            = callback;
+    entry->cb_arg              = cb_arg;
+    ++HEAP_COUNT(table);
+    heap_sift_up(table, position);
+    return entry->token;
 }
 
 bool extend_deferred_exec_advanced(deferred_executor_t *table, size_t table_count, deferred_token token, uint32_t delay_ms) {
     // Ignore queueing if the table isn't valid, it's a zero-time delay, or the token is not valid
-    if (!table || table_count == 0 || delay_ms == 0 || token == INVALID_DEFERRED_TOKEN) {
+    if (!table_is_valid(table, table_count) || delay_ms == 0) {
         return false;
     }
 
     // Find the entry corresponding to the token
-    for (int i = 0; i < table_count; ++i) {
-        deferred_executor_t *entry = &table[i];
-        if (entry->token == token) {
-            // Found it, extend the delay
-            entry->trigger_time = timer_read32() + delay_ms;
-            return true;
-        }
+    deferred_executor_t *entry = find_entry(table, table_count, token);
+    if (!entry) {
+        return false;
     }
 
-    // Not found
-    return false;
+    // Found it, extend the delay
+    entry->trigger_time = timer_read32() + delay_ms;
+    heap_update(table, entry->heap_position);
+    return true;
 }
 
 bool cancel_deferred_exec_advanced(deferred_executor_t *table, size_t table_count, deferred_token token) {
     // Ignore request if the table/token are not valid
-    if (!table || table_count == 0 || token == INVALID_DEFERRED_TOKEN) {
+    if (!table_is_valid(table, table_count)) {
         return false;
     }
 
     // Find the entry corresponding to the token
-    for (int i = 0; i < table_count; ++i) {
-        deferred_executor_t *entry = &table[i];
-        if (entry->token == token) {
-            // Found it, cancel and clear the table entry
-            entry->token        = INVALID_DEFERRED_TOKEN;
-            entry->trigger_time = 0;
-            entry->callback     = NULL;
-            entry->cb_arg       = NULL;
-            return true;
-        }
+    deferred_executor_t *entry = find_entry(table, table_count, token);
+    if (!entry) {
+        return false;
     }
 
-    // Not found
-    return false;
+    // Found it, cancel and clear the table entry
+    heap_remove(table, entry);
+    return true;
+}
+
+bool deferred_exec_advanced_next_trigger(deferred_executor_t *table, size_t table_count, uint32_t *trigger_time) {
+    if (!table_is_valid(table, table_count) || HEAP_COUNT(table) == 0) {
+        return false;
+    }
+    *trigger_time = HEAP_ENTRY(table, 0)->trigger_time;
+    return true;
 }
 
 void deferred_exec_advanced_task(deferred_executor_t *table, size_t table_count, uint32_t *last_execution_time) {
+    if (!table_is_valid(table, table_count)) {
+        return;
+    }
+
     uint32_t now = timer_read32();
 
     // Throttle only once per millisecond
     if (((int32_t)TIMER_DIFF_32(now, (*last_execution_time))) > 0) {
         *last_execution_time = now;
 
-        // Run through each of the executors
-        for (int i = 0; i < table_count; ++i) {
-            deferred_executor_t *entry      = &table[i];
+        // Run the earliest executor for as long as it's due. Bounded by the number queued up front, so an executor that
+        // is falling behind can't starve the main loop by being requeued in the past over and over.
+        for (uint8_t remaining = HEAP_COUNT(table); remaining > 0 && HEAP_COUNT(table) > 0; --remaining) {
+            deferred_executor_t *entry      = HEAP_ENTRY(table, 0);
             deferred_token       curr_token = entry->token;
 
-            // Check if we're supposed to execute this entry
-            if (curr_token != INVALID_DEFERRED_TOKEN && ((int32_t)TIMER_DIFF_32(entry->trigger_time, now)) <= 0) {
-                // Invoke the callback and work work out if we should be requeued
-                uint32_t delay_ms = entry->callback(entry->trigger_time, entry->cb_arg);
-
-                // If the token has changed, then the callback has canceled and re-queued. Skip further processing.
-                if (entry->token != curr_token) {
-                    continue;
-                }
-
-                // Update the trigger time if we have to repeat, otherwise clear it out
-                if (delay_ms > 0) {
-                    // Intentionally add just the delay to the existing trigger time -- this ensures the next
-                    // invocation is with respect to the previous trigger, rather than when it got to execution. Under
-                    // normal circumstances this won't cause issue, but if another executor is invoked that takes a
-                    // considerable length of time, then this ensures best-effort timing between invocations.
-                    entry->trigger_time += delay_ms;
-                } else {
-                    // If it was zero, then the callback is cancelling repeated execution. Free up the slot.
-                    entry->token        = INVALID_DEFERRED_TOKEN;
-                    entry->trigger_time = 0;
-                    entry->callback     = NULL;
-                    entry->cb_arg       = NULL;
-                }
+            // Nothing else is due if the earliest one isn't
+            if (((int32_t)TIMER_DIFF_32(entry->trigger_time, now)) > 0) {
+                break;
+            }
+
+            // Invoke the callback and work work out if we should be requeued
+            uint32_t delay_ms = entry->callback(entry->trigger_time, entry->cb_arg);
+
+            // If the entry was cancelled or the token has changed, then the callback has canceled and/or re-queued.
+            // Skip further processing.
+            if (entry->heap_position >= HEAP_COUNT(table) || entry->token != curr_token) {
+                continue;
+            }
+
+            // Update the trigger time if we have to repeat, otherwise clear it out
+            if (delay_ms > 0) {
+                // Intentionally add just the delay to the existing trigger time -- this ensures the next
+                // invocation is with respect to the previous trigger, rather than when it got to execution. Under
+                // normal circumstances this won't cause issue, but if another executor is invoked that takes a
+                // considerable length of time, then this ensures best-effort timing between invocations.
+                entry->trigger_time += delay_ms;
+                heap_update(table, entry->heap_position);
+            } else {
+                // If it was zero, then the callback is cancelling repeated execution. Free up the slot.
+                heap_remove(table, entry);
             }
         }
     }
@@ -172,6 +259,9 @@ bool extend_deferred_exec(deferred_token token, uint32_t delay_ms) {
 bool cancel_deferred_exec(deferred_token token) {
     return cancel_deferred_exec_advanced(basic_executors, MAX_DEFERRED_EXECUTORS, token);
 }
+bool deferred_exec_next_trigger(uint32_t *trigger_time) {
+    return deferred_exec_advanced_next_trigger(basic_executors, MAX_DEFERRED_EXECUTORS, trigger_time);
+}
 void deferred_exec_task(void) {
     deferred_exec_advanced_task(basic_executors, MAX_DEFERRED_EXECUTORS, &last_deferred_exec_check);
 }
@@ -0,0 +1,249 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "timer.h"
+#include "deferred_exec.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+#define TABLE_SIZE 8
+
+struct invocation {
+    int      id;
+    uint32_t trigger_time;
+    uint32_t now;
+};
+
+static std::vector<invocation> invocations;
+static std::map<int, uint32_t> repeat;
+
+static uint32_t record_callback(uint32_t trigger_time, void *cb_arg) {
+    int id = (int)(intptr_t)cb_arg;
+    invocations.push_back({id, trigger_time, timer_read32()});
+    return repeat.count(id) ? repeat[id] : 0;
+}
+
+class DeferredExec : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(1000);
+        std::fill(std::begin(table), std::end(table), deferred_executor_t{});
+        last_execution = 0;
+        invocations.clear();
+        repeat.clear();
+    }
+
+    deferred_token defer(uint32_t delay_ms, int id) {
+        return defer_exec_advanced(table, TABLE_SIZE, delay_ms, record_callback, (void *)(intptr_t)id);
+    }
+
+    void run_for(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; ++i) {
+            advance_time(1);
+            deferred_exec_advanced_task(table, TABLE_SIZE, &last_execution);
+        }
+    }
+
+    std::vector<int> invoked_ids() {
+        std::vector<int> ids;
+        for (auto &inv : invocations) {
+            ids.push_back(inv.id);
+        }
+        return ids;
+    }
+
+    deferred_executor_t table[TABLE_SIZE];
+    uint32_t            last_execution;
+};
+
+/**
+ * This test verifies that executors queued out of order run in trigger order, each on time.
+ */
+TEST_F(DeferredExec, RunsInTriggerOrder) {
+    const uint32_t delays[] = {50, 10, 40, 20, 30};
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_NE(defer(delays[i], i), INVALID_DEFERRED_TOKEN);
+    }
+
+    run_for(100);
+    EXPECT_EQ(invoked_ids(), (std::vector<int>{1, 3, 4, 2, 0}));
+    for (auto &inv : invocations) {
+        EXPECT_EQ(inv.now, inv.trigger_time) << "Executor " << inv.id << " ran late";
+    }
+}
+
+/**
+ * This test verifies that a repeating executor keeps its cadence relative to the previous trigger time.
+ */
+TEST_F(DeferredExec, RepeatKeepsCadence) {
+    repeat[7] = 25;
+    defer(25, 7);
+    run_for(100);
+    ASSERT_EQ(invocations.size(), 4);
+    for (size_t i = 0; i < invocations.size(); ++i) {
+        EXPECT_EQ(invocations[i].trigger_time, 1000 + 25 * (i + 1));
+    }
+}
+
+/**
+ * This test verifies that an executor which has fallen behind runs at most once per queued executor per task call.
+ */
+TEST_F(DeferredExec, LateRepeatDoesNotStarve) {
+    repeat[0] = 1;
+    defer(1, 0);
+    advance_time(100);
+    deferred_exec_advanced_task(table, TABLE_SIZE, &last_execution);
+    EXPECT_EQ(invocations.size(), 1);
+}
+
+/**
+ * This test verifies extending and cancelling, and that a cancelled token can't touch the executor that reuses its slot.
+ */
+TEST_F(DeferredExec, ExtendAndCancel) {
+    deferred_token a = defer(10, 0);
+    deferred_token b = defer(20, 1);
+    EXPECT_TRUE(extend_deferred_exec_advanced(table, TABLE_SIZE, a, 30));
+    EXPECT_TRUE(cancel_deferred_exec_advanced(table, TABLE_SIZE, b));
+    EXPECT_FALSE(cancel_deferred_exec_advanced(table, TABLE_SIZE, b)) << "Token should no longer be valid";
+
+    deferred_token c = defer(5, 2);
+    EXPECT_NE(c, b) << "Cancelled token was handed out again";
+    EXPECT_FALSE(cancel_deferred_exec_advanced(table, TABLE_SIZE, b));
+    EXPECT_FALSE(extend_deferred_exec_advanced(table, TABLE_SIZE, b, 10));
+
+    run_for(50);
+    EXPECT_EQ(invoked_ids(), (std::vector<int>{2, 0}));
+    EXPECT_EQ(invocations[1].trigger_time, 1030);
+}
+
+/**
+ * This test verifies that a full table refuses new executors until one completes.
+ */
+TEST_F(DeferredExec, TableFull) {
+    for (int i = 0; i < TABLE_SIZE; ++i) {
+        EXPECT_NE(defer(10 + i, i), INVALID_DEFERRED_TOKEN);
+    }
+    EXPECT_EQ(defer(5, 99), INVALID_DEFERRED_TOKEN);
+
+    run_for(10);
+    EXPECT_NE(defer(5, 99), INVALID_DEFERRED_TOKEN);
+    run_for(20);
+    EXPECT_EQ(invocations.size(), TABLE_SIZE + 1);
+}
+
+/**
+ * This test verifies that the earliest trigger time is reported, and nothing once the table is empty.
+ */
+TEST_F(DeferredExec, NextTrigger) {
+    uint32_t next = 0;
+    EXPECT_FALSE(deferred_exec_advanced_next_trigger(table, TABLE_SIZE, &next));
+
+    defer(30, 0);
+    deferred_token t = defer(10, 1);
+    EXPECT_TRUE(deferred_exec_advanced_next_trigger(table, TABLE_SIZE, &next));
+    EXPECT_EQ(next, 1010);
+
+    cancel_deferred_exec_advanced(table, TABLE_SIZE, t);
+    EXPECT_TRUE(deferred_exec_advanced_next_trigger(table, TABLE_SIZE, &next));
+    EXPECT_EQ(next, 1030);
+
+    run_for(30);
+    EXPECT_FALSE(deferred_exec_advanced_next_trigger(table, TABLE_SIZE, &next));
+}
+
+static deferred_executor_t *requeue_table;
+static deferred_token       requeue_token;
+
+static uint32_t requeue_callback(uint32_t trigger_time, void *cb_arg) {
+    cancel_deferred_exec_advanced(requeue_table, TABLE_SIZE, requeue_token);
+    requeue_token = defer_exec_advanced(requeue_table, TABLE_SIZE, 15, record_callback, cb_arg);
+    return 10;
+}
+
+/**
+ * This test verifies that a callback cancelling and requeueing itself gets the new delay rather than its return value.
+ */
+TEST_F(DeferredExec, CallbackRequeuesItself) {
+    requeue_table = table;
+    requeue_token = defer_exec_advanced(table, TABLE_SIZE, 5, requeue_callback, (void *)(intptr_t)3);
+    run_for(30);
+    ASSERT_EQ(invocations.size(), 1);
+    EXPECT_EQ(invocations[0].trigger_time, 1020);
+}
+
+/**
+ * This test verifies random schedules against a straightforward model, including timer wraparound.
+ */
+TEST_F(DeferredExec, MatchesModel) {
+    set_time(UINT32_MAX - 500);
+    last_execution = UINT32_MAX - 501;
+    std::map<int, std::pair<deferred_token, uint32_t>> model;
+    std::vector<std::pair<int, uint32_t>>             expected;
+    uint32_t                                          seed = 12345;
+    auto                                              rnd  = [&](uint32_t n) {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) % n;
+    };
+
+    for (int step = 0; step < 2000; ++step) {
+        int id = rnd(12);
+        switch (rnd(4)) {
+            case 0:
+            case 1:
+                if (!model.count(id)) {
+                    uint32_t       delay = 1 + rnd(40);
+                    deferred_token token = defer(delay, id);
+                    if (model.size() < TABLE_SIZE) {
+                        ASSERT_NE(token, INVALID_DEFERRED_TOKEN);
+                        model[id] = {token, timer_read32() + delay};
+                    } else {
+                        ASSERT_EQ(token, INVALID_DEFERRED_TOKEN);
+                    }
+                }
+                break;
+            case 2:
+                if (model.count(id)) {
+                    uint32_t delay = 1 + rnd(40);
+                    ASSERT_TRUE(extend_deferred_exec_advanced(table, TABLE_SIZE, model[id].first, delay));
+                    model[id].second = timer_read32() + delay;
+                }
+                break;
+            case 3:
+                if (model.count(id)) {
+                    ASSERT_TRUE(cancel_deferred_exec_advanced(table, TABLE_SIZE, model[id].first));
+                    model.erase(id);
+                }
+                break;
+        }
+
+        advance_time(1);
+        uint32_t now = timer_read32();
+        for (auto it = model.begin(); it != model.end();) {
+            if ((int32_t)(it->second.second - now) <= 0) {
+                expected.push_back({it->first, it->second.second});
+                it = model.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        deferred_exec_advanced_task(table, TABLE_SIZE, &last_execution);
+    }
+
+    std::vector<std::pair<int, uint32_t>> actual;
+    for (auto &inv : invocations) {
+        actual.push_back({inv.id, inv.trigger_time});
+    }
+    EXPECT_GT(expected.size(), 200) << "Model didn't exercise enough executions";
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    EXPECT_EQ(actual, expected);
+}
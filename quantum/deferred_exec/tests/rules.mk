@@ -0,0 +1,4 @@
+deferred_exec_SRC := \
+	$(QUANTUM_PATH)/deferred_exec.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(QUANTUM_PATH)/deferred_exec/tests/deferred_exec_tests.cpp
@@ -14,13 +14,17 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
 #include "dynamic_keymap.h"
 #include "keymap_introspection.h"
 #include "action.h"
+#include "action_layer.h"
 #include "eeprom.h"
 #include "progmem.h"
 #include "send_string.h"
 #include "keycodes.h"
+#include "timer.h"
+#include "util.h"
 
 #ifdef VIA_ENABLE
 #    include "via.h"
@@ -101,6 +105,115 @@ _Static_assert((DYNAMIC_KEYMAP_EEPROM_MAX_ADDR) - (DYNAMIC_KEYMAP_MACRO_EEPROM_A
 #    define DYNAMIC_KEYMAP_MACRO_DELAY TAP_CODE_DELAY
 #endif
 
+#ifdef DYNAMIC_KEYMAP_RAM_MIRROR
+#    ifndef DYNAMIC_KEYMAP_WRITE_BACK_DELAY
+#        define DYNAMIC_KEYMAP_WRITE_BACK_DELAY 1000
+#    endif
+
+#    ifndef DYNAMIC_KEYMAP_WRITE_BACK_BLOCK_SIZE
+#        define DYNAMIC_KEYMAP_WRITE_BACK_BLOCK_SIZE 16
+#    endif
+
+// Some EEPROM drivers put a copy of the whole write on the stack, so long runs are split up
+#    ifndef DYNAMIC_KEYMAP_WRITE_BACK_CHUNK_SIZE
+#        define DYNAMIC_KEYMAP_WRITE_BACK_CHUNK_SIZE 64
+#    endif
+
+// The mirror spans keymaps, encoder maps and macros in one go
+#    define DYNAMIC_KEYMAP_MIRROR_SIZE ((DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR) + (DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) - (DYNAMIC_KEYMAP_EEPROM_ADDR))
+#    define DYNAMIC_KEYMAP_MIRROR_BLOCKS (((DYNAMIC_KEYMAP_MIRROR_SIZE) + (DYNAMIC_KEYMAP_WRITE_BACK_BLOCK_SIZE)-1) / (DYNAMIC_KEYMAP_WRITE_BACK_BLOCK_SIZE))
+
+_Static_assert((DYNAMIC_KEYMAP_EEPROM_ADDR) <= (DYNAMIC_KEYMAP_ENCODER_EEPROM_ADDR) && (DYNAMIC_KEYMAP_ENCODER_EEPROM_ADDR) <= (DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR), "DYNAMIC_KEYMAP_RAM_MIRROR requires keymaps, encoder maps and macros to be stored in that order.");
+
+static uint8_t  dynamic_keymap_mirror[DYNAMIC_KEYMAP_MIRROR_SIZE];
+static uint8_t  dynamic_keymap_mirror_dirty[((DYNAMIC_KEYMAP_MIRROR_BLOCKS) + 7) / 8];
+static bool     dynamic_keymap_mirror_loaded  = false;
+static bool     dynamic_keymap_mirror_pending = false;
+static uint32_t dynamic_keymap_last_write     = 0;
+
+static void dynamic_keymap_mirror_load(void) {
+    eeprom_read_block(dynamic_keymap_mirror, (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR), DYNAMIC_KEYMAP_MIRROR_SIZE);
+    dynamic_keymap_mirror_loaded = true;
+}
+
+static inline uint16_t dynamic_keymap_mirror_offset(const void *address) {
+    if (!dynamic_keymap_mirror_loaded) {
+        dynamic_keymap_mirror_load();
+    }
+    return (uintptr_t)address - (DYNAMIC_KEYMAP_EEPROM_ADDR);
+}
+
+static void dynamic_keymap_mirror_mark_dirty(uint16_t offset) {
+    const uint16_t block = offset / (DYNAMIC_KEYMAP_WRITE_BACK_BLOCK_SIZE);
+    dynamic_keymap_mirror_dirty[block / 8] |= 1 << (block % 8);
+    dynamic_keymap_mirror_pending = true;
+    dynamic_keymap_last_write     = timer_read32();
+}
+
+static uint8_t dynamic_keymap_read_byte(const void *address) {
+    return dynamic_keymap_mirror[dynamic_keymap_mirror_offset(address)];
+}
+
+static void dynamic_keymap_update_byte(void *address, uint8_t value) {
+    const uint16_t offset = dynamic_keymap_mirror_offset(address);
+    if (dynamic_keymap_mirror[offset] != value) {
+        dynamic_keymap_mirror[offset] = value;
+        dynamic_keymap_mirror_mark_dirty(offset);
+    }
+}
+
+static inline bool dynamic_keymap_mirror_block_dirty(uint16_t block) {
+    return dynamic_keymap_mirror_dirty[block / 8] & (1 << (block % 8));
+}
+
+// Forces the whole region to be written back, e.g. after the EEPROM was erased underneath the mirror
+static void dynamic_keymap_mirror_mark_all_dirty(void) {
+    memset(dynamic_keymap_mirror_dirty, 0xFF, sizeof(dynamic_keymap_mirror_dirty));
+    dynamic_keymap_mirror_pending = true;
+}
+
+void dynamic_keymap_flush(void) {
+    if (!dynamic_keymap_mirror_pending) {
+        return;
+    }
+
+    // Write back runs of consecutive dirty blocks as block updates of up to a chunk each
+    uint16_t block = 0;
+    while (block < DYNAMIC_KEYMAP_MIRROR_BLOCKS) {
+        if (!dynamic_keymap_mirror_block_dirty(block)) {
+            block++;
+            continue;
+        }
+        const uint16_t first = block;
+        while (block < DYNAMIC_KEYMAP_MIRROR_BLOCKS && dynamic_keymap_mirror_block_dirty(block)) {
+            block++;
+        }
+        const uint16_t end = MIN(block * (DYNAMIC_KEYMAP_WRITE_BACK_BLOCK_SIZE), DYNAMIC_KEYMAP_MIRROR_SIZE);
+        for (uint16_t start = first * (DYNAMIC_KEYMAP_WRITE_BACK_BLOCK_SIZE); start < end; start += (DYNAMIC_KEYMAP_WRITE_BACK_CHUNK_SIZE)) {
+            const uint16_t len = MIN(end - start, DYNAMIC_KEYMAP_WRITE_BACK_CHUNK_SIZE);
+            eeprom_update_block(&dynamic_keymap_mirror[start], (void *)(uintptr_t)(DYNAMIC_KEYMAP_EEPROM_ADDR + start), len);
+        }
+    }
+
+    memset(dynamic_keymap_mirror_dirty, 0, sizeof(dynamic_keymap_mirror_dirty));
+    dynamic_keymap_mirror_pending = false;
+}
+
+void dynamic_keymap_task(void) {
+    if (dynamic_keymap_mirror_pending && timer_elapsed32(dynamic_keymap_last_write) >= DYNAMIC_KEYMAP_WRITE_BACK_DELAY) {
+        dynamic_keymap_flush();
+    }
+}
+#else
+#    define dynamic_keymap_read_byte(address) eeprom_read_byte(address)
+#    define dynamic_keymap_update_byte(address, value) eeprom_update_byte(address, value)
+#    define dynamic_keymap_mirror_mark_all_dirty()
+
+void dynamic_keymap_flush(void) {}
+
+void dynamic_keymap_task(void) {}
+#endif // DYNAMIC_KEYMAP_RAM_MIRROR
+
 uint8_t dynamic_keymap_get_layer_count(void) {
     return DYNAMIC_KEYMAP_LAYER_COUNT;
 }
@@ -114,8 +227,8 @@ uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column)
     if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || row >= MATRIX_ROWS || column >= MATRIX_COLS) return KC_NO;
     void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
     // Big endian, so we can read/write EEPROM directly from host if we want
-    uint16_t keycode = eeprom_read_byte(address) << 8;
-    keycode |= eeprom_read_byte(address + 1);
+    uint16_t keycode = dynamic_keymap_read_byte(address) << 8;
+    keycode |= dynamic_keymap_read_byte(address + 1);
     return keycode;
 }
 
@@ -123,8 +236,9 @@ void dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint
     if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || row >= MATRIX_ROWS || column >= MATRIX_COLS) return;
     void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
     // Big endian, so we can read/write EEPROM directly from host if we want
-    eeprom_update_byte(address, (uint8_t)(keycode >> 8));
-    eeprom_update_byte(address + 1, (uint8_t)(keycode & 0xFF));
+    dynamic_keymap_update_byte(address, (uint8_t)(keycode >> 8));
+    dynamic_keymap_update_byte(address + 1, (uint8_t)(keycode & 0xFF));
+    layer_lookup_cache_invalidate_key(row, column);
 }
 
 #ifdef ENCODER_MAP_ENABLE
@@ -136,8 +250,8 @@ uint16_t dynamic_keymap_get_encoder(uint8_t layer, uint8_t encoder_id, bool cloc
     if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || encoder_id >= NUM_ENCODERS) return KC_NO;
     void *address = dynamic_keymap_encoder_to_eeprom_address(layer, encoder_id);
     // Big endian, so we can read/write EEPROM directly from host if we want
-    uint16_t keycode = ((uint16_t)eeprom_read_byte(address + (clockwise ? 0 : 2))) << 8;
-    keycode |= eeprom_read_byte(address + (clockwise ? 0 : 2) + 1);
+    uint16_t keycode = ((uint16_t)dynamic_keymap_read_byte(address + (clockwise ? 0 : 2))) << 8;
+    keycode |= dynamic_keymap_read_byte(address + (clockwise ? 0 : 2) + 1);
     return keycode;
 }
 
@@ -145,8 +259,8 @@ void dynamic_keymap_set_encoder(uint8_t layer, uint8_t encoder_id, bool clockwis
     if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || encoder_id >= NUM_ENCODERS) return;
     void *address = dynamic_keymap_encoder_to_eeprom_address(layer, encoder_id);
     // Big endian, so we can read/write EEPROM directly from host if we want
-    eeprom_update_byte(address + (clockwise ? 0 : 2), (uint8_t)(keycode >> 8));
-    eeprom_update_byte(address + (clockwise ? 0 : 2) + 1, (uint8_t)(keycode & 0xFF));
+    dynamic_keymap_update_byte(address + (clockwise ? 0 : 2), (uint8_t)(keycode >> 8));
+    dynamic_keymap_update_byte(address + (clockwise ? 0 : 2) + 1, (uint8_t)(keycode & 0xFF));
 }
 #endif // ENCODER_MAP_ENABLE
 
@@ -165,15 +279,17 @@ void dynamic_keymap_reset(void) {
         }
 #endif // ENCODER_MAP_ENABLE
     }
+    dynamic_keymap_mirror_mark_all_dirty();
+    dynamic_keymap_flush();
 }
 
 void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
     uint16_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
-    void *   source                     = (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
+    void *   source                     = (void *)(uintptr_t)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
     uint8_t *target                     = data;
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < dynamic_keymap_eeprom_size) {
-            *target = eeprom_read_byte(source);
+            *target = dynamic_keymap_read_byte(source);
         } else {
             *target = 0x00;
         }
@@ -184,15 +300,16 @@ void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
 
 void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
     uint16_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
-    void *   target                     = (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
+    void *   target                     = (void *)(uintptr_t)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
     uint8_t *source                     = data;
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < dynamic_keymap_eeprom_size) {
-            eeprom_update_byte(target, *source);
+            dynamic_keymap_update_byte(target, *source);
         }
         source++;
         target++;
     }
+    layer_lookup_cache_invalidate();
 }
 
 uint16_t keycode_at_keymap_location(uint8_t layer_num, uint8_t row, uint8_t column) {
@@ -220,11 +337,11 @@ uint16_t dynamic_keymap_macro_get_buffer_size(void) {
 }
 
 void dynamic_keymap_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    void *   source = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
+    void *   source = (void *)(uintptr_t)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
     uint8_t *target = data;
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
-            *target = eeprom_read_byte(source);
+            *target = dynamic_keymap_read_byte(source);
         } else {
             *target = 0x00;
         }
@@ -234,11 +351,11 @@ void dynamic_keymap_macro_get_buffer(uint16_t offset, uint16_t size, uint8_t *da
 }
 
 void dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
-    void *   target = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
+    void *   target = (void *)(uintptr_t)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + offset);
     uint8_t *source = data;
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE) {
-            eeprom_update_byte(target, *source);
+            dynamic_keymap_update_byte(target, *source);
         }
         source++;
         target++;
@@ -249,9 +366,11 @@ void dynamic_keymap_macro_reset(void) {
     void *p   = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR);
     void *end = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE);
     while (p != end) {
-        eeprom_update_byte(p, 0);
+        dynamic_keymap_update_byte(p, 0);
         ++p;
     }
+    dynamic_keymap_mirror_mark_all_dirty();
+    dynamic_keymap_flush();
 }
 
 void dynamic_keymap_macro_send(uint8_t id) {
@@ -264,7 +383,7 @@ void dynamic_keymap_macro_send(uint8_t id) {
     // of buffer writing, possibly an aborted buffer
     // write. So do nothing.
     void *p = (void *)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR + DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE - 1);
-    if (eeprom_read_byte(p) != 0) {
+    if (dynamic_keymap_read_byte(p) != 0) {
         return;
     }
 
@@ -278,7 +397,7 @@ void dynamic_keymap_macro_send(uint8_t id) {
         if (p == end) {
             return;
         }
-        if (eeprom_read_byte(p) == 0) {
+        if (dynamic_keymap_read_byte(p) == 0) {
             --id;
         }
         ++p;
@@ -289,7 +408,7 @@ void dynamic_keymap_macro_send(uint8_t id) {
     // We already checked there was a null at the end of
     // the buffer, so this cannot go past the end
     while (1) {
-        data[0] = eeprom_read_byte(p++);
+        data[0] = dynamic_keymap_read_byte(p++);
         data[1] = 0;
         // Stop at the null terminator of this macro string
         if (data[0] == 0) {
@@ -297,14 +416,14 @@ void dynamic_keymap_macro_send(uint8_t id) {
         }
         if (data[0] == SS_QMK_PREFIX) {
             // Get the code
-            data[1] = eeprom_read_byte(p++);
+            data[1] = dynamic_keymap_read_byte(p++);
             // Unexpected null, abort.
             if (data[1] == 0) {
                 return;
             }
             if (data[1] == SS_TAP_CODE || data[1] == SS_DOWN_CODE || data[1] == SS_UP_CODE) {
                 // Get the keycode
-                data[2] = eeprom_read_byte(p++);
+                data[2] = dynamic_keymap_read_byte(p++);
                 // Unexpected null, abort.
                 if (data[2] == 0) {
                     return;
@@ -316,7 +435,7 @@ void dynamic_keymap_macro_send(uint8_t id) {
                 // At most this is 4 digits plus '|'
                 uint8_t i = 2;
                 while (1) {
-                    data[i] = eeprom_read_byte(p++);
+                    data[i] = dynamic_keymap_read_byte(p++);
                     // Unexpected null, abort
                     if (data[i] == 0) {
                         return;
@@ -68,3 +68,10 @@ void     dynamic_keymap_macro_set_buffer(uint16_t offset, uint16_t size, uint8_t
 void     dynamic_keymap_macro_reset(void);
 
 void dynamic_keymap_macro_send(uint8_t id);
+
+// With DYNAMIC_KEYMAP_RAM_MIRROR, keymap and macro changes are made in a RAM copy
+// and written back to EEPROM once no further change happened for DYNAMIC_KEYMAP_WRITE_BACK_DELAY ms.
+// dynamic_keymap_flush() writes back all pending changes immediately.
+// Both are no-ops without DYNAMIC_KEYMAP_RAM_MIRROR.
+void dynamic_keymap_flush(void);
+void dynamic_keymap_task(void);
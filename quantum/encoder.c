@@ -257,6 +257,50 @@ bool encoder_read(void) {
     return changed;
 }
 
+#ifdef MATRIX_IDLE_SLEEP_ENABLE
+// Set once a pad can't get a wakeup of its own, the keyboard then stays awake so that no turn is missed
+static bool idle_wakeup_unavailable = false;
+
+/**
+ * @brief Arms both pads of every encoder to wake up idle sleep
+ *
+ * @return false if a pad shares its wakeup with a pin armed before it, nothing is left armed then
+ */
+bool encoder_idle_arm(void) {
+    if (idle_wakeup_unavailable) {
+        return false;
+    }
+    for (uint8_t i = 0; i < thisCount; i++) {
+        if (!enablePinWakeup(encoders_pad_a[i]) || !enablePinWakeup(encoders_pad_b[i])) {
+            idle_wakeup_unavailable = true;
+            encoder_idle_disarm();
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Checks whether any encoder moved since it was last read
+ */
+bool encoder_idle_moved(void) {
+    for (uint8_t i = 0; i < thisCount; i++) {
+        uint8_t new_status = (readPin(encoders_pad_a[i]) << 0) | (readPin(encoders_pad_b[i]) << 1);
+        if ((encoder_state[i] & 0x3) != new_status) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void encoder_idle_disarm(void) {
+    for (uint8_t i = 0; i < thisCount; i++) {
+        disablePinWakeup(encoders_pad_a[i]);
+        disablePinWakeup(encoders_pad_b[i]);
+    }
+}
+#endif // MATRIX_IDLE_SLEEP_ENABLE
+
 #ifdef SPLIT_KEYBOARD
 void last_encoder_activity_trigger(void);
 
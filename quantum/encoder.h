@@ -28,6 +28,12 @@ bool encoder_read(void);
 bool encoder_update_kb(uint8_t index, bool clockwise);
 bool encoder_update_user(uint8_t index, bool clockwise);
 
+#ifdef MATRIX_IDLE_SLEEP_ENABLE
+bool encoder_idle_arm(void);
+bool encoder_idle_moved(void);
+void encoder_idle_disarm(void);
+#endif // MATRIX_IDLE_SLEEP_ENABLE
+
 #ifdef SPLIT_KEYBOARD
 
 void encoder_state_raw(uint8_t* slave_state);
@@ -33,6 +33,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "sendchar.h"
 #include "eeconfig.h"
 #include "action_layer.h"
+#include "task_profiler.h"
 #ifdef AUDIO_ENABLE
 #    include "audio.h"
 #endif
@@ -102,6 +103,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef VIA_ENABLE
 #    include "via.h"
 #endif
+#ifdef DYNAMIC_KEYMAP_ENABLE
+#    include "dynamic_keymap.h"
+#endif
+#ifdef MATRIX_IDLE_SLEEP_ENABLE
+#    include "matrix_idle_sleep.h"
+#endif
 #ifdef DIP_SWITCH_ENABLE
 #    include "dip_switch.h"
 #endif
@@ -629,55 +636,68 @@ void quantum_task(void) {
 #ifdef SECURE_ENABLE
     secure_task();
 #endif
+
+#ifdef DYNAMIC_KEYMAP_ENABLE
+    dynamic_keymap_task();
+#endif
 }
 
 /** \brief Main task that is repeatedly called as fast as possible. */
 void keyboard_task(void) {
+#ifdef TASK_PROFILER_ENABLE
+    const uint32_t keyboard_task_start = task_profiler_timestamp();
+#endif
     __attribute__((unused)) bool activity_has_occurred = false;
-    if (matrix_task()) {
+    bool                         matrix_changed;
+    TASK_PROFILE(TASK_PROFILER_MATRIX_TASK, matrix_changed = matrix_task());
+    if (matrix_changed) {
         last_matrix_activity_trigger();
         activity_has_occurred = true;
     }
 
-    quantum_task();
+    TASK_PROFILE(TASK_PROFILER_QUANTUM_TASK, quantum_task());
 
 #if defined(SPLIT_WATCHDOG_ENABLE)
-    split_watchdog_task();
+    TASK_PROFILE(TASK_PROFILER_SPLIT_WATCHDOG_TASK, split_watchdog_task());
 #endif
 
 #if defined(RGBLIGHT_ENABLE)
-    rgblight_task();
+    TASK_PROFILE(TASK_PROFILER_RGBLIGHT_TASK, rgblight_task());
 #endif
 
 #ifdef LED_MATRIX_ENABLE
-    led_matrix_task();
+    TASK_PROFILE(TASK_PROFILER_LED_MATRIX_TASK, led_matrix_task());
 #endif
 #ifdef RGB_MATRIX_ENABLE
-    rgb_matrix_task();
+    TASK_PROFILE(TASK_PROFILER_RGB_MATRIX_TASK, rgb_matrix_task());
 #endif
 
 #if defined(BACKLIGHT_ENABLE)
 #    if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
-    backlight_task();
+    TASK_PROFILE(TASK_PROFILER_BACKLIGHT_TASK, backlight_task());
 #    endif
 #endif
 
 #ifdef ENCODER_ENABLE
-    if (encoder_read()) {
+    bool encoder_changed;
+    TASK_PROFILE(TASK_PROFILER_ENCODER_READ, encoder_changed = encoder_read());
+    if (encoder_changed) {
         last_encoder_activity_trigger();
         activity_has_occurred = true;
     }
 #endif
 
 #ifdef POINTING_DEVICE_ENABLE
-    if (pointing_device_task()) {
+    bool pointing_device_changed;
+    TASK_PROFILE(TASK_PROFILER_POINTING_DEVICE_TASK, pointing_device_changed = pointing_device_task());
+    if (pointing_device_changed) {
         last_pointing_device_activity_trigger();
         activity_has_occurred = true;
     }
 #endif
 
 #ifdef OLED_ENABLE
-    oled_task();
+    TASK_PROFILE(TASK_PROFILER_OLED_TASK, oled_task());
 #    if OLED_TIMEOUT > 0
     // Wake up oled if user is using those fabulous keys or spinning those encoders!
     if (activity_has_occurred) oled_on();
@@ -685,7 +705,7 @@ void keyboard_task(void) {
 #endif
 
 #ifdef ST7565_ENABLE
-    st7565_task();
+    TASK_PROFILE(TASK_PROFILER_ST7565_TASK, st7565_task());
 #    if ST7565_TIMEOUT > 0
     // Wake up display if user is using those fabulous keys or spinning those encoders!
     if (activity_has_occurred) st7565_on();
@@ -694,28 +714,41 @@ void keyboard_task(void) {
 
 #ifdef MOUSEKEY_ENABLE
     // mousekey repeat & acceleration
-    mousekey_task();
+    TASK_PROFILE(TASK_PROFILER_MOUSEKEY_TASK, mousekey_task());
 #endif
 
 #ifdef PS2_MOUSE_ENABLE
-    ps2_mouse_task();
+    TASK_PROFILE(TASK_PROFILER_PS2_MOUSE_TASK, ps2_mouse_task());
 #endif
 
 #ifdef MIDI_ENABLE
-    midi_task();
+    TASK_PROFILE(TASK_PROFILER_MIDI_TASK, midi_task());
 #endif
 
 #ifdef JOYSTICK_ENABLE
-    joystick_task();
+    TASK_PROFILE(TASK_PROFILER_JOYSTICK_TASK, joystick_task());
 #endif
 
 #ifdef BLUETOOTH_ENABLE
-    bluetooth_task();
+    TASK_PROFILE(TASK_PROFILER_BLUETOOTH_TASK, bluetooth_task());
 #endif
 
 #ifdef HAPTIC_ENABLE
-    haptic_task();
+    TASK_PROFILE(TASK_PROFILER_HAPTIC_TASK, haptic_task());
 #endif
 
-    led_task();
+    TASK_PROFILE(TASK_PROFILER_LED_TASK, led_task());
+
+#ifdef TASK_PROFILER_ENABLE
+    task_profiler_record(TASK_PROFILER_KEYBOARD_TASK, task_profiler_timestamp() - keyboard_task_start);
+    task_profiler_task();
+#endif
+
+#if defined(EEPROM_WEAR_LEVELING) && (defined(WEAR_LEVELING_WRITE_BACK) || defined(WEAR_LEVELING_INCREMENTAL_CONSOLIDATION))
+    eeprom_driver_task();
+#endif
+
+#ifdef MATRIX_IDLE_SLEEP_ENABLE
+    matrix_idle_sleep_task();
+#endif
 }
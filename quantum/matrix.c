@@ -22,6 +22,11 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "debounce.h"
 #include "atomic_util.h"
 
+#ifdef MATRIX_IDLE_SLEEP_ENABLE
+#    include "matrix_idle_sleep.h"
+#    include "idle_sleep.h"
+#endif
+
 #ifdef SPLIT_KEYBOARD
 #    include "split_common/split_util.h"
 #    include "split_common/transactions.h"
@@ -62,6 +67,28 @@ static SPLIT_MUTABLE_COL pin_t col_pins[MATRIX_COLS]   = MATRIX_COL_PINS;
 #    endif // MATRIX_COL_PINS
 #endif
 
+#if defined(MATRIX_IDLE_SLEEP_ENABLE) && (defined(DIRECT_PINS) || (defined(MATRIX_ROW_PINS) && defined(MATRIX_COL_PINS)))
+// Set once a pin can't get a wakeup of its own, e.g. A0 and B0 share EXTI line 0 on STM32. As that
+// won't change, idle sleep is left off and the matrix is simply polled from then on.
+static bool idle_wakeup_unavailable = false;
+
+static bool idle_wakeup_pins(const pin_t *pins, uint16_t count, bool enable) {
+    for (uint16_t i = 0; i < count; i++) {
+        if (pins[i] == NO_PIN) {
+            continue;
+        }
+        if (!enable) {
+            disablePinWakeup(pins[i]);
+        } else if (!enablePinWakeup(pins[i])) {
+            idle_wakeup_unavailable = true;
+            idle_wakeup_pins(pins, i, false);
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
 /* matrix state(1:on, 0:off) */
 extern matrix_row_t raw_matrix[MATRIX_ROWS]; // raw values
 extern matrix_row_t matrix[MATRIX_ROWS];     // debounced values
@@ -133,6 +160,27 @@ __attribute__((weak)) void matrix_read_cols_on_row(matrix_row_t current_matrix[]
     current_matrix[current_row] = current_row_value;
 }
 
+#    ifdef MATRIX_IDLE_SLEEP_ENABLE
+bool matrix_idle_arm(void) {
+    return !idle_wakeup_unavailable && idle_wakeup_pins(&direct_pins[0][0], ROWS_PER_HAND * MATRIX_COLS, true);
+}
+
+bool matrix_idle_key_pressed(void) {
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (!readMatrixPin(direct_pins[row][col])) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void matrix_idle_disarm(void) {
+    idle_wakeup_pins(&direct_pins[0][0], ROWS_PER_HAND * MATRIX_COLS, false);
+}
+#    endif // MATRIX_IDLE_SLEEP_ENABLE
+
 #elif defined(DIODE_DIRECTION)
 #    if defined(MATRIX_ROW_PINS) && defined(MATRIX_COL_PINS)
 #        if (DIODE_DIRECTION == COL2ROW)
@@ -198,6 +246,40 @@ __attribute__((weak)) void matrix_read_cols_on_row(matrix_row_t current_matrix[]
     current_matrix[current_row] = current_row_value;
 }
 
+#            ifdef MATRIX_IDLE_SLEEP_ENABLE
+// With every row selected at once, a key press on any row pulls its col low
+bool matrix_idle_arm(void) {
+    if (idle_wakeup_unavailable) {
+        return false;
+    }
+    for (uint8_t x = 0; x < ROWS_PER_HAND; x++) {
+        select_row(x);
+    }
+    matrix_output_select_delay();
+    if (!idle_wakeup_pins(col_pins, MATRIX_COLS, true)) {
+        unselect_rows();
+        matrix_output_unselect_delay(0, true);
+        return false;
+    }
+    return true;
+}
+
+bool matrix_idle_key_pressed(void) {
+    for (uint8_t x = 0; x < MATRIX_COLS; x++) {
+        if (!readMatrixPin(col_pins[x])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void matrix_idle_disarm(void) {
+    idle_wakeup_pins(col_pins, MATRIX_COLS, false);
+    unselect_rows();
+    matrix_output_unselect_delay(0, true);
+}
+#            endif // MATRIX_IDLE_SLEEP_ENABLE
+
 #        elif (DIODE_DIRECTION == ROW2COL)
 
 static bool select_col(uint8_t col) {
@@ -262,6 +344,40 @@ __attribute__((weak)) void matrix_read_rows_on_col(matrix_row_t current_matrix[]
     matrix_output_unselect_delay(current_col, key_pressed); // wait for all Row signals to go HIGH
 }
 
+#            ifdef MATRIX_IDLE_SLEEP_ENABLE
+// With every col selected at once, a key press on any col pulls its row low
+bool matrix_idle_arm(void) {
+    if (idle_wakeup_unavailable) {
+        return false;
+    }
+    for (uint8_t x = 0; x < MATRIX_COLS; x++) {
+        select_col(x);
+    }
+    matrix_output_select_delay();
+    if (!idle_wakeup_pins(row_pins, ROWS_PER_HAND, true)) {
+        unselect_cols();
+        matrix_output_unselect_delay(0, true);
+        return false;
+    }
+    return true;
+}
+
+bool matrix_idle_key_pressed(void) {
+    for (uint8_t x = 0; x < ROWS_PER_HAND; x++) {
+        if (!readMatrixPin(row_pins[x])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void matrix_idle_disarm(void) {
+    idle_wakeup_pins(row_pins, ROWS_PER_HAND, false);
+    unselect_cols();
+    matrix_output_unselect_delay(0, true);
+}
+#            endif // MATRIX_IDLE_SLEEP_ENABLE
+
 #        else
 #            error DIODE_DIRECTION must be one of COL2ROW or ROW2COL!
 #        endif
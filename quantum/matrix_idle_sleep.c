@@ -0,0 +1,103 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "matrix_idle_sleep.h"
+#include "idle_sleep.h"
+#include "matrix.h"
+#include "keyboard.h"
+#include "timer.h"
+
+#ifdef POINTING_DEVICE_ENABLE
+#    include "pointing_device.h"
+#endif
+
+#ifdef ENCODER_ENABLE
+#    include "encoder.h"
+#endif
+
+#ifdef SPLIT_KEYBOARD
+#    error "MATRIX_IDLE_SLEEP_ENABLE is not supported on split keyboards"
+#endif
+
+__attribute__((weak)) bool matrix_idle_arm(void) {
+    return false;
+}
+
+__attribute__((weak)) bool matrix_idle_key_pressed(void) {
+    return true;
+}
+
+__attribute__((weak)) void matrix_idle_disarm(void) {}
+
+__attribute__((weak)) bool matrix_idle_sleep_allowed_user(void) {
+    return true;
+}
+
+__attribute__((weak)) bool matrix_idle_sleep_allowed_kb(void) {
+    return matrix_idle_sleep_allowed_user();
+}
+
+static bool matrix_is_idle(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        if (matrix_get_row(row)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Sensors with a motion pin wake up idle sleep on motion, any other sensor has to be polled
+static bool pointing_device_is_idle(void) {
+#ifdef POINTING_DEVICE_ENABLE
+    return !pointing_device_motion_pending();
+#else
+    return true;
+#endif
+}
+
+// Encoder pads are armed next to the matrix, a turn wakes up idle sleep and is then read as usual
+static bool arm_encoders(void) {
+#ifdef ENCODER_ENABLE
+    return encoder_idle_arm();
+#else
+    return true;
+#endif
+}
+
+static bool encoders_are_idle(void) {
+#ifdef ENCODER_ENABLE
+    return !encoder_idle_moved();
+#else
+    return true;
+#endif
+}
+
+static void disarm_encoders(void) {
+#ifdef ENCODER_ENABLE
+    encoder_idle_disarm();
+#endif
+}
+
+void matrix_idle_sleep_task(void) {
+    if (last_matrix_activity_elapsed() < MATRIX_IDLE_SLEEP_DELAY || !matrix_is_idle() || !pointing_device_is_idle() || !matrix_idle_sleep_allowed_kb()) {
+        return;
+    }
+
+    if (!matrix_idle_arm()) {
+        return;
+    }
+    if (!arm_encoders()) {
+        matrix_idle_disarm();
+        return;
+    }
+
+    // Wakeups may be spurious (bouncing contacts, unrelated interrupts), so check before going back to sleep
+    uint32_t start = timer_read32();
+    uint32_t elapsed;
+    while (!matrix_idle_key_pressed() && pointing_device_is_idle() && encoders_are_idle() && (elapsed = timer_elapsed32(start)) < MATRIX_IDLE_SLEEP_TIMEOUT) {
+        idle_sleep(MATRIX_IDLE_SLEEP_TIMEOUT - elapsed);
+    }
+
+    disarm_encoders();
+    matrix_idle_disarm();
+}
@@ -0,0 +1,60 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+
+/**
+ * \file
+ *
+ * \defgroup matrix_idle_sleep Matrix Idle Sleep
+ *
+ * Once every key has been released for `MATRIX_IDLE_SLEEP_DELAY` milliseconds,
+ * the matrix is armed so that a single read (or an edge interrupt, where the
+ * platform supports it) detects the next key press, and the MCU is put to sleep
+ * instead of running full matrix scans. The sleep lasts at most
+ * `MATRIX_IDLE_SLEEP_TIMEOUT` milliseconds so that timer driven tasks (RGB,
+ * OLED, deferred executors, ...) keep running at a reduced rate.
+ * \{
+ */
+
+#ifndef MATRIX_IDLE_SLEEP_DELAY
+#    define MATRIX_IDLE_SLEEP_DELAY 100
+#endif
+
+#ifndef MATRIX_IDLE_SLEEP_TIMEOUT
+#    define MATRIX_IDLE_SLEEP_TIMEOUT 10
+#endif
+
+/**
+ * \brief Sleeps until a key is pressed or the timeout expires, if the keyboard is idle.
+ */
+void matrix_idle_sleep_task(void);
+
+/**
+ * \brief Sets up the matrix so that `matrix_idle_key_pressed()` works, e.g. by selecting every row.
+ *
+ * Weakly defined to return false, so custom matrix implementations never sleep unless they implement this.
+ *
+ * \return false if the matrix cannot be armed
+ */
+bool matrix_idle_arm(void);
+
+/**
+ * \brief Whether any key is down, while the matrix is armed.
+ */
+bool matrix_idle_key_pressed(void);
+
+/**
+ * \brief Restores the matrix for regular scanning.
+ */
+void matrix_idle_disarm(void);
+
+/**
+ * \brief Allows the keyboard or keymap to keep scanning at full rate, e.g. while an animation is running.
+ */
+bool matrix_idle_sleep_allowed_kb(void);
+bool matrix_idle_sleep_allowed_user(void);
+
+/** \} */
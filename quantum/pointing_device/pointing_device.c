@@ -25,6 +25,20 @@
 #    include "mousekey.h"
 #endif
 
+#if defined(POINTING_DEVICE_ACCUMULATE_MOTION) && defined(PROTOCOL_CHIBIOS)
+#    include "usb_main.h"
+#    include "usb_device_state.h"
+#endif
+
+// On ChibiOS, edges of the motion pin are latched by a line event, so short pulses are not missed between reads
+#if defined(POINTING_DEVICE_MOTION_PIN) && defined(PROTOCOL_CHIBIOS) && defined(PAL_USE_CALLBACKS) && (PAL_USE_CALLBACKS == TRUE)
+#    define POINTING_DEVICE_MOTION_LATCH
+#    include "atomic_util.h"
+#    ifdef MATRIX_IDLE_SLEEP_ENABLE
+#        include "idle_sleep.h"
+#    endif
+#endif
+
 #if (defined(POINTING_DEVICE_ROTATION_90) + defined(POINTING_DEVICE_ROTATION_180) + defined(POINTING_DEVICE_ROTATION_270)) > 1
 #    error More than one rotation selected.  This is not supported.
 #endif
@@ -79,6 +93,27 @@ uint16_t pointing_device_get_shared_cpi(void) {
 static report_mouse_t local_mouse_report         = {};
 static bool           pointing_device_force_send = false;
 
+#if defined(POINTING_DEVICE_MOTION_PIN) && defined(MATRIX_IDLE_SLEEP_ENABLE)
+// False if the motion pin shares its wakeup line with a pin armed before it, so the sensor is polled instead
+static bool motion_pin_wakeup = false;
+#endif
+
+#ifdef POINTING_DEVICE_MOTION_LATCH
+static volatile bool motion_latched = true;
+#endif
+
+#ifdef POINTING_DEVICE_ACCUMULATE_MOTION
+typedef struct {
+    int32_t x;
+    int32_t y;
+    int32_t h;
+    int32_t v;
+    uint8_t buttons;
+} pointing_device_motion_t;
+
+static pointing_device_motion_t accumulated_motion = {};
+#endif
+
 extern const pointing_device_driver_t pointing_device_driver;
 
 /**
@@ -136,6 +171,37 @@ __attribute__((weak)) uint8_t pointing_device_handle_buttons(uint8_t buttons, bo
     return buttons;
 }
 
+#ifdef POINTING_DEVICE_MOTION_LATCH
+static void pointing_device_motion_callback(void *arg) {
+    (void)arg;
+    motion_latched = true;
+#    ifdef MATRIX_IDLE_SLEEP_ENABLE
+    idle_sleep_wakeup_from_isr();
+#    endif
+}
+
+/**
+ * @brief Latches edges of the motion pin from its line event
+ *
+ * With MATRIX_IDLE_SLEEP_ENABLE the line event belongs to the idle sleep wakeup, whose callback is replaced by one
+ * that also wakes up idle sleep. Without a line of its own, the sensor is polled instead.
+ */
+static void pointing_device_motion_latch_init(void) {
+#    ifdef MATRIX_IDLE_SLEEP_ENABLE
+    if (!motion_pin_wakeup) {
+        return;
+    }
+#    else
+#        ifdef POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW
+    palEnableLineEvent(POINTING_DEVICE_MOTION_PIN, PAL_EVENT_MODE_FALLING_EDGE);
+#        else
+    palEnableLineEvent(POINTING_DEVICE_MOTION_PIN, PAL_EVENT_MODE_RISING_EDGE);
+#        endif
+#    endif
+    palSetLineCallback(POINTING_DEVICE_MOTION_PIN, pointing_device_motion_callback, NULL);
+}
+#endif
+
 /**
  * @brief Initialises pointing device
  *
@@ -153,6 +219,13 @@ __attribute__((weak)) void pointing_device_init(void) {
 #    else
         setPinInput(POINTING_DEVICE_MOTION_PIN);
 #    endif
+#    ifdef MATRIX_IDLE_SLEEP_ENABLE
+        // wake up from idle sleep as soon as the sensor sees motion
+        motion_pin_wakeup = enablePinWakeup(POINTING_DEVICE_MOTION_PIN);
+#    endif
+#    ifdef POINTING_DEVICE_MOTION_LATCH
+        pointing_device_motion_latch_init();
+#    endif
 #endif
     }
 
@@ -160,6 +233,59 @@ __attribute__((weak)) void pointing_device_init(void) {
     pointing_device_init_user();
 }
 
+/**
+ * @brief Checks whether the sensor may have motion to report
+ *
+ * Without POINTING_DEVICE_MOTION_PIN, or with MATRIX_IDLE_SLEEP_ENABLE if the motion pin couldn't get a wakeup line
+ * of its own, the sensor has to be polled, so this is always true. Otherwise true while the pin is asserted, or on
+ * ChibiOS since an edge of the pin that was not read yet.
+ *
+ * @return false if reading the sensor can be skipped
+ */
+bool pointing_device_motion_pending(void) {
+#ifdef POINTING_DEVICE_MOTION_PIN
+#    ifdef MATRIX_IDLE_SLEEP_ENABLE
+    if (!motion_pin_wakeup) {
+        return true;
+    }
+#    endif
+#    ifdef POINTING_DEVICE_MOTION_LATCH
+    if (motion_latched) {
+        return true;
+    }
+#    endif
+#    ifdef POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW
+    return !readPin(POINTING_DEVICE_MOTION_PIN);
+#    else
+    return readPin(POINTING_DEVICE_MOTION_PIN);
+#    endif
+#else
+    return true;
+#endif
+}
+
+#ifdef POINTING_DEVICE_MOTION_PIN
+/**
+ * @brief Checks for motion to report, and clears the latched edge before the sensor is read
+ *
+ * Clearing it before the read latches motion that arrives during the read again.
+ *
+ * @return false if reading the sensor can be skipped
+ */
+static bool pointing_device_motion_take(void) {
+#    ifdef POINTING_DEVICE_MOTION_LATCH
+    bool latched;
+    ATOMIC_BLOCK_FORCEON {
+        latched        = motion_latched;
+        motion_latched = false;
+    }
+    return latched || pointing_device_motion_pending();
+#    else
+    return pointing_device_motion_pending();
+#    endif
+}
+#endif
+
 /**
  * @brief Sends processed mouse report to host
  *
@@ -218,6 +344,79 @@ report_mouse_t pointing_device_adjust_by_defines(report_mouse_t mouse_report) {
     return mouse_report;
 }
 
+#ifdef POINTING_DEVICE_ACCUMULATE_MOTION
+/**
+ * @brief Checks whether accumulated motion should be sent now
+ *
+ * Once per USB frame while the host is connected over ChibiOS USB, otherwise every POINTING_DEVICE_REPORT_INTERVAL_MS.
+ *
+ * @return true if a report is due
+ */
+static bool pointing_device_report_due(void) {
+    static uint32_t last_report = 0;
+#    ifdef PROTOCOL_CHIBIOS
+    static uint16_t last_frame = 0;
+
+    if (usb_device_state == USB_DEVICE_STATE_CONFIGURED) {
+        uint16_t frame = usb_get_frame_count();
+        if (frame == last_frame) {
+            return false;
+        }
+        last_frame = frame;
+        return true;
+    }
+#    endif
+    if (timer_elapsed32(last_report) < POINTING_DEVICE_REPORT_INTERVAL_MS) {
+        return false;
+    }
+    last_report = timer_read32();
+    return true;
+}
+
+/**
+ * @brief Removes as much of the accumulated motion as fits in [min, max]
+ *
+ * @param[in] motion accumulated motion, keeps what did not fit
+ * @param[in] min int32_t smallest value of the report field
+ * @param[in] max int32_t largest value of the report field
+ * @return int32_t value to report
+ */
+static int32_t pointing_device_take_motion(int32_t *motion, int32_t min, int32_t max) {
+    int32_t value = *motion < min ? min : (*motion > max ? max : *motion);
+    *motion -= value;
+    return value;
+}
+
+/**
+ * @brief Accumulates the motion of the report and replaces it with the motion to send now
+ *
+ * Motion read every task iteration is summed into wide integers. When a report is due, or the buttons changed, the sum
+ * is moved into the report saturated to the report range and the remainder is carried into the next report. Otherwise
+ * the report carries no motion, so nothing is sent.
+ *
+ * @param[in] mouse_report report_mouse_t to be adjusted
+ */
+static void pointing_device_accumulate_motion(report_mouse_t *mouse_report) {
+    accumulated_motion.x += mouse_report->x;
+    accumulated_motion.y += mouse_report->y;
+    accumulated_motion.h += mouse_report->h;
+    accumulated_motion.v += mouse_report->v;
+
+    if (pointing_device_report_due() || mouse_report->buttons != accumulated_motion.buttons) {
+        mouse_report->x            = pointing_device_take_motion(&accumulated_motion.x, XY_REPORT_MIN, XY_REPORT_MAX);
+        mouse_report->y            = pointing_device_take_motion(&accumulated_motion.y, XY_REPORT_MIN, XY_REPORT_MAX);
+        mouse_report->h            = pointing_device_take_motion(&accumulated_motion.h, INT8_MIN, INT8_MAX);
+        mouse_report->v            = pointing_device_take_motion(&accumulated_motion.v, INT8_MIN, INT8_MAX);
+        accumulated_motion.buttons = mouse_report->buttons;
+    } else {
+        mouse_report->x = 0;
+        mouse_report->y = 0;
+        mouse_report->h = 0;
+        mouse_report->v = 0;
+    }
+}
+#endif
+
 /**
  * @brief Retrieves and processes pointing device data.
  *
@@ -246,11 +445,7 @@ __attribute__((weak)) bool pointing_device_task(void) {
 #    if defined(SPLIT_POINTING_ENABLE)
 #        error POINTING_DEVICE_MOTION_PIN not supported when sharing the pointing device report between sides.
 #    endif
-#    ifdef POINTING_DEVICE_MOTION_PIN_ACTIVE_LOW
-    if (!readPin(POINTING_DEVICE_MOTION_PIN))
-#    else
-    if (readPin(POINTING_DEVICE_MOTION_PIN))
-#    endif
+    if (pointing_device_motion_take())
 #endif
 
 #if defined(SPLIT_POINTING_ENABLE)
@@ -291,6 +486,9 @@ __attribute__((weak)) bool pointing_device_task(void) {
     report_mouse_t mousekey_report = mousekey_get_report();
     local_mouse_report.buttons     = local_mouse_report.buttons | mousekey_report.buttons;
 #endif
+#ifdef POINTING_DEVICE_ACCUMULATE_MOTION
+    pointing_device_accumulate_motion(&local_mouse_report);
+#endif
 
     const bool send_report     = pointing_device_send() || pointing_device_force_send;
     pointing_device_force_send = false;
@@ -92,6 +92,12 @@ typedef enum {
     POINTING_DEVICE_BUTTON8,
 } pointing_device_buttons_t;
 
+#ifdef POINTING_DEVICE_ACCUMULATE_MOTION
+#    ifndef POINTING_DEVICE_REPORT_INTERVAL_MS
+#        define POINTING_DEVICE_REPORT_INTERVAL_MS 1
+#    endif
+#endif
+
 #ifdef MOUSE_EXTENDED_REPORT
 #    define XY_REPORT_MIN INT16_MIN
 #    define XY_REPORT_MAX INT16_MAX
@@ -105,6 +111,7 @@ typedef int16_t clamp_range_t;
 void           pointing_device_init(void);
 bool           pointing_device_task(void);
 bool           pointing_device_send(void);
+bool           pointing_device_motion_pending(void);
 report_mouse_t pointing_device_get_report(void);
 void           pointing_device_set_report(report_mouse_t mouse_report);
 uint16_t       pointing_device_get_cpi(void);
@@ -460,17 +460,41 @@ static uint16_t pmw33xx_get_cpi_wrapper(void) {
     return pmw33xx_get_cpi(0);
 }
 
+#    ifdef POINTING_DEVICE_ACCUMULATE_MOTION
+/**
+ * @brief Adds the sensor deltas to the motion not reported yet and reports what fits
+ */
+static report_mouse_t pmw33xx_carry_motion(report_mouse_t mouse_report, int16_t delta_x, int16_t delta_y) {
+    static int32_t carry_x = 0, carry_y = 0;
+
+    carry_x += delta_x;
+    carry_y += delta_y;
+
+    mouse_report.x = CONSTRAIN_HID_XY(carry_x);
+    mouse_report.y = CONSTRAIN_HID_XY(carry_y);
+
+    carry_x -= mouse_report.x;
+    carry_y -= mouse_report.y;
+    return mouse_report;
+}
+
+// still report what a fast flick left behind once the sensor stops
+#        define PMW33XX_REPORT_CARRY(mouse_report) pmw33xx_carry_motion(mouse_report, 0, 0)
+#    else
+#        define PMW33XX_REPORT_CARRY(mouse_report) (mouse_report)
+#    endif
+
 report_mouse_t pmw33xx_get_report(report_mouse_t mouse_report) {
     pmw33xx_report_t report    = pmw33xx_read_burst(0);
     static bool      in_motion = false;
 
     if (report.motion.b.is_lifted) {
-        return mouse_report;
+        return PMW33XX_REPORT_CARRY(mouse_report);
     }
 
     if (!report.motion.b.is_motion) {
         in_motion = false;
-        return mouse_report;
+        return PMW33XX_REPORT_CARRY(mouse_report);
     }
 
     if (!in_motion) {
@@ -478,9 +502,13 @@ report_mouse_t pmw33xx_get_report(report_mouse_t mouse_report) {
         pd_dprintf("PWM3360 (0): starting motion\n");
     }
 
+#    ifdef POINTING_DEVICE_ACCUMULATE_MOTION
+    return pmw33xx_carry_motion(mouse_report, report.delta_x, report.delta_y);
+#    else
     mouse_report.x = CONSTRAIN_HID_XY(report.delta_x);
     mouse_report.y = CONSTRAIN_HID_XY(report.delta_y);
     return mouse_report;
+#    endif
 }
 
 // clang-format off
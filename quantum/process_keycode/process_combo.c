@@ -16,6 +16,7 @@
 
 #include "process_combo.h"
 #include <stddef.h>
+#include <string.h>
 #include "process_auto_shift.h"
 #include "caps_word.h"
 #include "timer.h"
@@ -94,6 +95,116 @@ static queued_combo_t combo_buffer[COMBO_BUFFER_LENGTH];
 
 #define INCREMENT_MOD(i) i = (i + 1) % COMBO_BUFFER_LENGTH
 
+#ifdef COMBO_KEY_INDEX
+#    ifndef COMBO_KEY_INDEX_MAX_COMBOS
+#        define COMBO_KEY_INDEX_MAX_COMBOS 64
+#    endif
+#    ifndef COMBO_KEY_INDEX_MAX_KEYCODES
+#        define COMBO_KEY_INDEX_MAX_KEYCODES 64
+#    endif
+
+#    define COMBO_KEY_INDEX_COMBO_WORDS ((COMBO_KEY_INDEX_MAX_COMBOS + 31) / 32)
+#    define COMBO_KEY_INDEX_KEYCODE_WORDS ((COMBO_KEY_INDEX_MAX_KEYCODES + 31) / 32)
+
+typedef enum {
+    COMBO_KEY_INDEX_STALE,
+    COMBO_KEY_INDEX_VALID,
+    COMBO_KEY_INDEX_OVERFLOW, // too many combos or keycodes, fall back to scanning every combo
+} combo_key_index_status_t;
+
+static combo_key_index_status_t combo_key_index_status = COMBO_KEY_INDEX_STALE;
+static uint16_t                 combo_key_index_combo_count;
+static uint8_t                  combo_key_index_keycode_count;
+// sorted keycodes that take part in at least one combo
+static uint16_t combo_key_index_keycodes[COMBO_KEY_INDEX_MAX_KEYCODES];
+// for every keycode above, the set of combos containing it
+static uint32_t combo_key_index_combos[COMBO_KEY_INDEX_MAX_KEYCODES][COMBO_KEY_INDEX_COMBO_WORDS];
+// for every combo, the set of keycode slots it consists of
+static uint32_t combo_key_index_keys[COMBO_KEY_INDEX_MAX_COMBOS][COMBO_KEY_INDEX_KEYCODE_WORDS];
+static uint8_t  combo_key_index_key_count[COMBO_KEY_INDEX_MAX_COMBOS];
+
+#    define BITSET_SET(set, bit) ((set)[(bit) / 32] |= (1UL << ((bit) % 32)))
+
+static int16_t combo_key_index_find(uint16_t keycode) {
+    uint8_t low = 0, high = combo_key_index_keycode_count;
+    while (low < high) {
+        uint8_t mid = (low + high) / 2;
+        if (combo_key_index_keycodes[mid] < keycode) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return (low < combo_key_index_keycode_count && combo_key_index_keycodes[low] == keycode) ? low : -1;
+}
+
+static bool combo_key_index_insert(uint16_t keycode) {
+    uint8_t slot = 0;
+    while (slot < combo_key_index_keycode_count && combo_key_index_keycodes[slot] < keycode) {
+        slot++;
+    }
+    if (slot < combo_key_index_keycode_count && combo_key_index_keycodes[slot] == keycode) {
+        return true;
+    }
+    if (combo_key_index_keycode_count >= COMBO_KEY_INDEX_MAX_KEYCODES) {
+        return false;
+    }
+    memmove(&combo_key_index_keycodes[slot + 1], &combo_key_index_keycodes[slot], (combo_key_index_keycode_count - slot) * sizeof(combo_key_index_keycodes[0]));
+    combo_key_index_keycodes[slot] = keycode;
+    combo_key_index_keycode_count++;
+    return true;
+}
+
+static void combo_key_index_build(void) {
+    combo_key_index_combo_count   = combo_count();
+    combo_key_index_keycode_count = 0;
+    memset(combo_key_index_combos, 0, sizeof(combo_key_index_combos));
+    memset(combo_key_index_keys, 0, sizeof(combo_key_index_keys));
+
+    if (combo_key_index_combo_count > COMBO_KEY_INDEX_MAX_COMBOS) {
+        combo_key_index_status = COMBO_KEY_INDEX_OVERFLOW;
+        return;
+    }
+
+    // first pass collects the sorted keycodes, so slots don't move while the bitsets are filled
+    for (uint16_t idx = 0; idx < combo_key_index_combo_count; ++idx) {
+        const uint16_t *keys = combo_get(idx)->keys;
+        uint16_t        key;
+        for (uint8_t i = 0; (key = pgm_read_word(&keys[i])) != COMBO_END; i++) {
+            if (!combo_key_index_insert(key)) {
+                combo_key_index_status = COMBO_KEY_INDEX_OVERFLOW;
+                return;
+            }
+        }
+    }
+
+    for (uint16_t idx = 0; idx < combo_key_index_combo_count; ++idx) {
+        const uint16_t *keys = combo_get(idx)->keys;
+        uint16_t        key;
+        uint8_t         i;
+        for (i = 0; (key = pgm_read_word(&keys[i])) != COMBO_END; i++) {
+            uint8_t slot = combo_key_index_find(key);
+            BITSET_SET(combo_key_index_combos[slot], idx);
+            BITSET_SET(combo_key_index_keys[idx], slot);
+        }
+        combo_key_index_key_count[idx] = i;
+    }
+
+    combo_key_index_status = COMBO_KEY_INDEX_VALID;
+}
+
+static inline bool combo_key_index_ready(void) {
+    if (combo_key_index_status == COMBO_KEY_INDEX_STALE || combo_key_index_combo_count != combo_count()) {
+        combo_key_index_build();
+    }
+    return combo_key_index_status == COMBO_KEY_INDEX_VALID;
+}
+
+void combo_key_index_invalidate(void) {
+    combo_key_index_status = COMBO_KEY_INDEX_STALE;
+}
+#endif // COMBO_KEY_INDEX
+
 #ifndef EXTRA_SHORT_COMBOS
 /* flags are their own elements in combo_t struct. */
 #    define COMBO_ACTIVE(combo) (combo->active)
@@ -256,7 +367,6 @@ static inline void dump_key_buffer(void) {
     key_buffer_next = key_buffer_size = 0;
 }
 
-#define NO_COMBO_KEYS_ARE_DOWN (0 == COMBO_STATE(combo))
 #define ALL_COMBO_KEYS_ARE_DOWN(state, key_count) (((1 << key_count) - 1) == state)
 #define ONLY_ONE_KEY_IS_DOWN(state) !(state & (state - 1))
 #define KEY_NOT_YET_RELEASED(state, key_index) ((1 << key_index) & state)
@@ -392,6 +502,26 @@ combo_t *overlaps(combo_t *combo1, combo_t *combo2) {
     return combo1;
 }
 
+static inline combo_t *overlapping_combo(uint16_t index1, combo_t *combo1, uint16_t index2, combo_t *combo2) {
+#ifdef COMBO_KEY_INDEX
+    if (combo_key_index_ready()) {
+        /* Same as overlaps(), but intersects the keycode sets of both combos. */
+        bool overlaps = false;
+        for (uint8_t i = 0; i < COMBO_KEY_INDEX_KEYCODE_WORDS; i++) {
+            if (combo_key_index_keys[index1][i] & combo_key_index_keys[index2][i]) {
+                overlaps = true;
+                break;
+            }
+        }
+
+        if (!overlaps) return NULL;
+        if (combo_key_index_key_count[index2] < combo_key_index_key_count[index1]) return combo2;
+        return combo1;
+    }
+#endif
+    return overlaps(combo1, combo2);
+}
+
 #if defined(COMBO_MUST_PRESS_IN_ORDER) || defined(COMBO_MUST_PRESS_IN_ORDER_PER_COMBO)
 static bool keys_pressed_in_order(uint16_t combo_index, combo_t *combo, uint16_t key_index, uint16_t keycode, keyrecord_t *record) {
 #    ifdef COMBO_MUST_PRESS_IN_ORDER_PER_COMBO
@@ -460,7 +590,7 @@ static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *
                     queued_combo_t *qcombo         = &combo_buffer[combo_buffer_i];
                     combo_t *       buffered_combo = combo_get(qcombo->combo_index);
 
-                    if ((drop = overlaps(buffered_combo, combo))) {
+                    if ((drop = overlapping_combo(qcombo->combo_index, buffered_combo, combo_index, combo))) {
                         DISABLE_COMBO(drop);
                         if (drop == combo) {
                             // stop checking for overlaps if dropped combo was current combo.
@@ -535,8 +665,7 @@ static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *
 }
 
 bool process_combo(uint16_t keycode, keyrecord_t *record) {
-    bool is_combo_key          = false;
-    bool no_combo_keys_pressed = true;
+    bool is_combo_key = false;
 
     if (keycode == QK_COMBO_ON && record->event.pressed) {
         combo_enable();
@@ -564,10 +693,27 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
     }
 #endif
 
-    for (uint16_t idx = 0; idx < combo_count(); ++idx) {
-        combo_t *combo = combo_get(idx);
-        is_combo_key |= process_single_combo(combo, keycode, record, idx);
-        no_combo_keys_pressed = no_combo_keys_pressed && (NO_COMBO_KEYS_ARE_DOWN || COMBO_ACTIVE(combo) || COMBO_DISABLED(combo));
+#ifdef COMBO_KEY_INDEX
+    /* COMBO_END matches every combo's terminator, so it always takes the slow path. */
+    if (keycode != COMBO_END && combo_key_index_ready()) {
+        /* Only visit the combos that contain this keycode, in index order. */
+        int16_t slot = combo_key_index_find(keycode);
+        if (slot >= 0) {
+            for (uint8_t word = 0; word < COMBO_KEY_INDEX_COMBO_WORDS; word++) {
+                uint32_t candidates = combo_key_index_combos[slot][word];
+                while (candidates) {
+                    uint16_t idx = word * 32 + __builtin_ctzl(candidates);
+                    candidates &= candidates - 1;
+                    is_combo_key |= process_single_combo(combo_get(idx), keycode, record, idx);
+                }
+            }
+        }
+    } else
+#endif
+    {
+        for (uint16_t idx = 0; idx < combo_count(); ++idx) {
+            is_combo_key |= process_single_combo(combo_get(idx), keycode, record, idx);
+        }
     }
 
     if (record->event.pressed && is_combo_key) {
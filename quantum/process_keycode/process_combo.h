@@ -77,6 +77,11 @@ bool process_combo(uint16_t keycode, keyrecord_t *record);
 void combo_task(void);
 void process_combo_event(uint16_t combo_index, bool pressed);
 
+#ifdef COMBO_KEY_INDEX
+/* Rebuild the keycode to combo index before the next key event, e.g. after changing key_combos[] at runtime. */
+void combo_key_index_invalidate(void);
+#endif
+
 void combo_enable(void);
 void combo_disable(void);
 void combo_toggle(void);
@@ -68,6 +68,10 @@
 #    include "process_unicode_common.h"
 #endif
 
+#if defined(EEPROM_WEAR_LEVELING) && defined(WEAR_LEVELING_WRITE_BACK)
+#    include "eeprom_driver.h"
+#endif
+
 #ifdef AUDIO_ENABLE
 #    ifndef GOODBYE_SONG
 #        define GOODBYE_SONG SONG(GOODBYE_SOUND)
@@ -194,6 +198,12 @@ void shutdown_quantum(bool jump_to_bootloader) {
 #ifdef HAPTIC_ENABLE
     haptic_shutdown();
 #endif
+#ifdef DYNAMIC_KEYMAP_ENABLE
+    dynamic_keymap_flush();
+#endif
+#if defined(EEPROM_WEAR_LEVELING) && defined(WEAR_LEVELING_WRITE_BACK)
+    eeprom_driver_flush();
+#endif
 }
 
 void reset_keyboard(void) {
@@ -234,10 +244,10 @@ uint16_t get_event_keycode(keyevent_t event, bool update_layer_cache) {
         } else {
             layer = read_source_layers_cache(event.key);
         }
-        return keymap_key_to_keycode(layer, event.key);
+        return layer_lookup_cache_get_keycode(layer, event.key);
     } else
 #endif
-        return keymap_key_to_keycode(layer_switch_get_layer(event.key), event.key);
+        return layer_lookup_cache_get_keycode(layer_switch_get_layer(event.key), event.key);
 }
 
 /* Get keycode, and then process pre tapping functionality */
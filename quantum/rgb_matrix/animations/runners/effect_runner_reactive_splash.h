@@ -4,15 +4,45 @@
 
 typedef HSV (*reactive_splash_f)(HSV hsv, int16_t dx, int16_t dy, uint8_t dist, uint16_t tick);
 
-bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, reactive_splash_f effect_func) {
+// Distances from a hit that can be lit at `tick`, returns false if none can.
+// Used with RGB_MATRIX_NEIGHBOR_TABLE to only render the LEDs near a hit, the
+// range may be wider than needed but must cover every LED the effect lights.
+typedef bool (*reactive_splash_reach_f)(uint16_t tick, uint8_t *min_dist, uint8_t *max_dist);
+
+bool effect_runner_reactive_splash_reach(uint8_t start, effect_params_t* params, reactive_splash_f effect_func, reactive_splash_reach_f reach_func) {
     RGB_MATRIX_USE_LIMITS(led_min, led_max);
 
     uint8_t count = g_last_hit_tracker.count;
+#    ifdef RGB_MATRIX_NEIGHBOR_TABLE
+    // Mark the LEDs some hit can reach, the effect is skipped for the others
+    uint8_t reached[(RGB_MATRIX_LED_COUNT + 7) / 8] = {0};
+    for (uint8_t j = start; reach_func && j < count; j++) {
+        uint16_t tick = scale16by8(g_last_hit_tracker.tick[j], qadd8(rgb_matrix_config.speed, 1));
+        uint8_t  min_dist;
+        uint8_t  max_dist;
+        if (!reach_func(tick, &min_dist, &max_dist)) {
+            continue;
+        }
+
+        uint8_t               neighbor_count;
+        const led_neighbor_t* neighbors = rgb_matrix_get_neighbors(g_last_hit_tracker.index[j], min_dist, max_dist, &neighbor_count);
+        for (uint8_t k = 0; k < neighbor_count; k++) {
+            reached[neighbors[k].index / 8] |= 1 << (neighbors[k].index % 8);
+        }
+    }
+#    endif
     for (uint8_t i = led_min; i < led_max; i++) {
         RGB_MATRIX_TEST_LED_FLAGS();
+        uint8_t hits = count;
+#    ifdef RGB_MATRIX_NEIGHBOR_TABLE
+        // Unreached LEDs keep v = 0, which still goes through rgb_matrix_hsv_to_rgb() like any other
+        if (reach_func && !(reached[i / 8] & (1 << (i % 8)))) {
+            hits = start;
+        }
+#    endif
         HSV hsv = rgb_matrix_config.hsv;
         hsv.v   = 0;
-        for (uint8_t j = start; j < count; j++) {
+        for (uint8_t j = start; j < hits; j++) {
             int16_t  dx   = g_led_config.point[i].x - g_last_hit_tracker.x[j];
             int16_t  dy   = g_led_config.point[i].y - g_last_hit_tracker.y[j];
             uint8_t  dist = sqrt16(dx * dx + dy * dy);
@@ -26,4 +56,18 @@ bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, react
     return rgb_matrix_check_finished_leds(led_max);
 }
 
+bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, reactive_splash_f effect_func) {
+    return effect_runner_reactive_splash_reach(start, params, effect_func, NULL);
+}
+
+// Reach of effects that light a ring where tick - dist < 255
+bool reactive_splash_ring_reach(uint16_t tick, uint8_t* min_dist, uint8_t* max_dist) {
+    if (tick > 254 + UINT8_MAX) {
+        return false;
+    }
+    *min_dist = tick > 254 ? tick - 254 : 0;
+    *max_dist = tick > UINT8_MAX ? UINT8_MAX : tick;
+    return true;
+}
+
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
@@ -26,15 +26,29 @@ static HSV SOLID_REACTIVE_CROSS_math(HSV hsv, int16_t dx, int16_t dy, uint8_t di
     return hsv;
 }
 
+static bool SOLID_REACTIVE_CROSS_reach(uint16_t tick, uint8_t* min_dist, uint8_t* max_dist) {
+    *min_dist = 0;
+    // tick + dist + offset wraps around for very old hits, which may light any LED
+    if (tick > UINT16_MAX - 2 * 255) {
+        *max_dist = 255;
+        return true;
+    }
+    if (tick > 254) {
+        return false;
+    }
+    *max_dist = 254 - tick;
+    return true;
+}
+
 #            ifdef ENABLE_RGB_MATRIX_SOLID_REACTIVE_CROSS
 bool SOLID_REACTIVE_CROSS(effect_params_t* params) {
-    return effect_runner_reactive_splash(qsub8(g_last_hit_tracker.count, 1), params, &SOLID_REACTIVE_CROSS_math);
+    return effect_runner_reactive_splash_reach(qsub8(g_last_hit_tracker.count, 1), params, &SOLID_REACTIVE_CROSS_math, &SOLID_REACTIVE_CROSS_reach);
 }
 #            endif
 
 #            ifdef ENABLE_RGB_MATRIX_SOLID_REACTIVE_MULTICROSS
 bool SOLID_REACTIVE_MULTICROSS(effect_params_t* params) {
-    return effect_runner_reactive_splash(0, params, &SOLID_REACTIVE_CROSS_math);
+    return effect_runner_reactive_splash_reach(0, params, &SOLID_REACTIVE_CROSS_math, &SOLID_REACTIVE_CROSS_reach);
 }
 #            endif
 
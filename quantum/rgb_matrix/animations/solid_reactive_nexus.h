@@ -25,15 +25,23 @@ static HSV SOLID_REACTIVE_NEXUS_math(HSV hsv, int16_t dx, int16_t dy, uint8_t di
     return hsv;
 }
 
+static bool SOLID_REACTIVE_NEXUS_reach(uint16_t tick, uint8_t* min_dist, uint8_t* max_dist) {
+    if (!reactive_splash_ring_reach(tick, min_dist, max_dist) || *min_dist > 72) {
+        return false;
+    }
+    if (*max_dist > 72) *max_dist = 72;
+    return true;
+}
+
 #            ifdef ENABLE_RGB_MATRIX_SOLID_REACTIVE_NEXUS
 bool SOLID_REACTIVE_NEXUS(effect_params_t* params) {
-    return effect_runner_reactive_splash(qsub8(g_last_hit_tracker.count, 1), params, &SOLID_REACTIVE_NEXUS_math);
+    return effect_runner_reactive_splash_reach(qsub8(g_last_hit_tracker.count, 1), params, &SOLID_REACTIVE_NEXUS_math, &SOLID_REACTIVE_NEXUS_reach);
 }
 #            endif
 
 #            ifdef ENABLE_RGB_MATRIX_SOLID_REACTIVE_MULTINEXUS
 bool SOLID_REACTIVE_MULTINEXUS(effect_params_t* params) {
-    return effect_runner_reactive_splash(0, params, &SOLID_REACTIVE_NEXUS_math);
+    return effect_runner_reactive_splash_reach(0, params, &SOLID_REACTIVE_NEXUS_math, &SOLID_REACTIVE_NEXUS_reach);
 }
 #            endif
 
@@ -21,13 +21,13 @@ HSV SPLASH_math(HSV hsv, int16_t dx, int16_t dy, uint8_t dist, uint16_t tick) {
 
 #            ifdef ENABLE_RGB_MATRIX_SPLASH
 bool SPLASH(effect_params_t* params) {
-    return effect_runner_reactive_splash(qsub8(g_last_hit_tracker.count, 1), params, &SPLASH_math);
+    return effect_runner_reactive_splash_reach(qsub8(g_last_hit_tracker.count, 1), params, &SPLASH_math, &reactive_splash_ring_reach);
 }
 #            endif
 
 #            ifdef ENABLE_RGB_MATRIX_MULTISPLASH
 bool MULTISPLASH(effect_params_t* params) {
-    return effect_runner_reactive_splash(0, params, &SPLASH_math);
+    return effect_runner_reactive_splash_reach(0, params, &SPLASH_math, &reactive_splash_ring_reach);
 }
 #            endif
 
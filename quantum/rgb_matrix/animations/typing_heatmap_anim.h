@@ -24,6 +24,24 @@ void process_rgb_matrix_typing_heatmap(uint8_t row, uint8_t col) {
     if (g_led_config.matrix_co[row][col] == NO_LED) { // skip as pressed key doesn't have an led position
         return;
     }
+#            ifdef RGB_MATRIX_NEIGHBOR_TABLE
+    g_rgb_frame_buffer[row][col] = qadd8(g_rgb_frame_buffer[row][col], RGB_MATRIX_TYPING_HEATMAP_INCREASE_STEP);
+
+    // Only visit the LEDs within the spread instead of the whole matrix
+    uint8_t               count;
+    const led_neighbor_t* neighbors = rgb_matrix_get_neighbors(g_led_config.matrix_co[row][col], 0, RGB_MATRIX_TYPING_HEATMAP_SPREAD, &count);
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t i_row, i_col;
+        if (!rgb_matrix_map_led_to_row_column(neighbors[i].index, &i_row, &i_col) || (i_row == row && i_col == col)) {
+            continue;
+        }
+        uint8_t amount = qsub8(RGB_MATRIX_TYPING_HEATMAP_SPREAD, neighbors[i].dist);
+        if (amount > RGB_MATRIX_TYPING_HEATMAP_AREA_LIMIT) {
+            amount = RGB_MATRIX_TYPING_HEATMAP_AREA_LIMIT;
+        }
+        g_rgb_frame_buffer[i_row][i_col] = qadd8(g_rgb_frame_buffer[i_row][i_col], amount);
+    }
+#            else
     for (uint8_t i_row = 0; i_row < MATRIX_ROWS; i_row++) {
         for (uint8_t i_col = 0; i_col < MATRIX_COLS; i_col++) {
             if (g_led_config.matrix_co[i_row][i_col] == NO_LED) { // skip as target key doesn't have an led position
@@ -32,9 +50,9 @@ void process_rgb_matrix_typing_heatmap(uint8_t row, uint8_t col) {
             if (i_row == row && i_col == col) {
                 g_rgb_frame_buffer[row][col] = qadd8(g_rgb_frame_buffer[row][col], RGB_MATRIX_TYPING_HEATMAP_INCREASE_STEP);
             } else {
-#            define LED_DISTANCE(led_a, led_b) sqrt16(((int16_t)(led_a.x - led_b.x) * (int16_t)(led_a.x - led_b.x)) + ((int16_t)(led_a.y - led_b.y) * (int16_t)(led_a.y - led_b.y)))
+#                define LED_DISTANCE(led_a, led_b) sqrt16(((int16_t)(led_a.x - led_b.x) * (int16_t)(led_a.x - led_b.x)) + ((int16_t)(led_a.y - led_b.y) * (int16_t)(led_a.y - led_b.y)))
                 uint8_t distance = LED_DISTANCE(g_led_config.point[g_led_config.matrix_co[row][col]], g_led_config.point[g_led_config.matrix_co[i_row][i_col]]);
-#            undef LED_DISTANCE
+#                undef LED_DISTANCE
                 if (distance <= RGB_MATRIX_TYPING_HEATMAP_SPREAD) {
                     uint8_t amount = qsub8(RGB_MATRIX_TYPING_HEATMAP_SPREAD, distance);
                     if (amount > RGB_MATRIX_TYPING_HEATMAP_AREA_LIMIT) {
@@ -45,6 +63,7 @@ void process_rgb_matrix_typing_heatmap(uint8_t row, uint8_t col) {
             }
         }
     }
+#            endif
 #        endif
 }
 
@@ -75,7 +94,7 @@ bool TYPING_HEATMAP(effect_params_t* params) {
 
     // Render heatmap & decrease
     uint8_t count = 0;
-    for (uint8_t row = 0; row < MATRIX_ROWS && count < RGB_MATRIX_LED_PROCESS_LIMIT; row++) {
+    for (uint8_t row = 0; row < MATRIX_ROWS && count < led_max - led_min; row++) {
         for (uint8_t col = 0; col < MATRIX_COLS && RGB_MATRIX_LED_PROCESS_LIMIT; col++) {
             if (g_led_config.matrix_co[row][col] >= led_min && g_led_config.matrix_co[row][col] < led_max) {
                 count++;
@@ -29,6 +29,18 @@
 
 #include <lib/lib8tion/lib8tion.h>
 
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+#    if defined(PROTOCOL_CHIBIOS) && (PORT_SUPPORTS_RT == TRUE)
+#        include <ch.h>
+#        define RGB_MATRIX_RENDER_BUDGET_TICKS US2RTC(REALTIME_COUNTER_CLOCK, RGB_MATRIX_RENDER_BUDGET_US)
+#    elif defined(__AVR__)
+#        include "timer_avr.h"
+#        define RGB_MATRIX_RENDER_BUDGET_TICKS ((uint32_t)(RGB_MATRIX_RENDER_BUDGET_US) * (TIMER_RAW_FREQ / 1000) / 1000)
+#    else
+#        define RGB_MATRIX_RENDER_BUDGET_TICKS ((uint32_t)(RGB_MATRIX_RENDER_BUDGET_US))
+#    endif
+#endif // RGB_MATRIX_RENDER_BUDGET_US
+
 #ifndef RGB_MATRIX_CENTER
 const led_point_t k_rgb_matrix_center = {112, 32};
 #else
@@ -44,7 +56,7 @@ __attribute__((weak)) RGB rgb_matrix_hsv_to_rgb(HSV hsv) {
 
 // ------------------------------------------
 // -----Begin rgb effect includes macros-----
-#define RGB_MATRIX_EFFECT(name)
+#define RGB_MATRIX_EFFECT(name, ...)
 #define RGB_MATRIX_CUSTOM_EFFECT_IMPLS
 
 #include "rgb_matrix_effects.inc"
@@ -86,6 +98,40 @@ static uint32_t rgb_timer_buffer;
 static last_hit_t last_hit_buffer;
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
 
+#if defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < RGB_MATRIX_LED_COUNT
+#    define RGB_MATRIX_DEFAULT_PROCESS_LIMIT RGB_MATRIX_LED_PROCESS_LIMIT
+#else
+#    define RGB_MATRIX_DEFAULT_PROCESS_LIMIT RGB_MATRIX_LED_COUNT
+#endif
+
+#ifdef RGB_MATRIX_SHADOW_BUFFER
+// Colours last handed to the driver, so unchanged LEDs and frames can be skipped
+static RGB  rgb_shadow[RGB_MATRIX_LED_COUNT];
+static bool rgb_shadow_dirty = true;
+// Output of the last full render of a static effect, without the indicators on top
+static RGB          rgb_static_frame[RGB_MATRIX_LED_COUNT];
+static rgb_config_t rgb_static_config;
+static bool         rgb_static_valid     = false;
+static bool         rgb_static_capturing = false;
+#endif // RGB_MATRIX_SHADOW_BUFFER
+
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+// LEDs rendered per iteration, fixed for the length of a frame
+static uint8_t rgb_process_limit = RGB_MATRIX_DEFAULT_PROCESS_LIMIT;
+// Moving average of the render time per LED, in 1/16 timestamp ticks, 0 until measured
+static uint32_t rgb_render_cost;
+#endif // RGB_MATRIX_RENDER_BUDGET_US
+
+#ifdef RGB_MATRIX_NEIGHBOR_TABLE
+// For every LED, all LEDs sorted by their distance to it, itself included. Takes
+// 2 * RGB_MATRIX_LED_COUNT^2 bytes of RAM, e.g. 20kB for 100 LEDs.
+_Static_assert(RGB_MATRIX_LED_COUNT <= 128, "RGB_MATRIX_NEIGHBOR_TABLE needs 2 * RGB_MATRIX_LED_COUNT^2 bytes of RAM, too much for more than 128 LEDs");
+static led_neighbor_t led_neighbor_table[RGB_MATRIX_LED_COUNT][RGB_MATRIX_LED_COUNT];
+// Matrix position of every LED, NO_LED if it has no key
+static uint8_t led_key_row[RGB_MATRIX_LED_COUNT];
+static uint8_t led_key_col[RGB_MATRIX_LED_COUNT];
+#endif // RGB_MATRIX_NEIGHBOR_TABLE
+
 // split rgb matrix
 #if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
 const uint8_t k_rgb_matrix_split[2] = RGB_MATRIX_SPLIT;
@@ -142,11 +188,86 @@ uint8_t rgb_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *l
     return led_count;
 }
 
+#ifdef RGB_MATRIX_NEIGHBOR_TABLE
+static int led_neighbor_compare(const void *a, const void *b) {
+    return (int)((const led_neighbor_t *)a)->dist - (int)((const led_neighbor_t *)b)->dist;
+}
+
+void rgb_matrix_update_neighbor_table(void) {
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        for (uint8_t j = 0; j < RGB_MATRIX_LED_COUNT; j++) {
+            // Same arithmetic as the effects, so the distances match exactly
+            int16_t dx = g_led_config.point[j].x - g_led_config.point[i].x;
+            int16_t dy = g_led_config.point[j].y - g_led_config.point[i].y;
+
+            led_neighbor_table[i][j].index = j;
+            led_neighbor_table[i][j].dist  = sqrt16(dx * dx + dy * dy);
+        }
+        qsort(led_neighbor_table[i], RGB_MATRIX_LED_COUNT, sizeof(led_neighbor_t), led_neighbor_compare);
+
+        led_key_row[i] = NO_LED;
+        led_key_col[i] = NO_LED;
+    }
+
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            uint8_t led = g_led_config.matrix_co[row][col];
+            if (led < RGB_MATRIX_LED_COUNT && led_key_row[led] == NO_LED) {
+                led_key_row[led] = row;
+                led_key_col[led] = col;
+            }
+        }
+    }
+}
+
+const led_neighbor_t *rgb_matrix_get_neighbors(uint8_t led, uint8_t min_dist, uint8_t max_dist, uint8_t *count) {
+    const led_neighbor_t *neighbors = led_neighbor_table[led];
+
+    // Binary search for the first neighbor at or beyond min_dist
+    uint8_t first = 0, last = RGB_MATRIX_LED_COUNT;
+    while (first < last) {
+        uint8_t mid = first + (last - first) / 2;
+        if (neighbors[mid].dist < min_dist) {
+            first = mid + 1;
+        } else {
+            last = mid;
+        }
+    }
+
+    last = first;
+    while (last < RGB_MATRIX_LED_COUNT && neighbors[last].dist <= max_dist) {
+        last++;
+    }
+
+    *count = last - first;
+    return &neighbors[first];
+}
+
+bool rgb_matrix_map_led_to_row_column(uint8_t led, uint8_t *row, uint8_t *column) {
+    if (led >= RGB_MATRIX_LED_COUNT || led_key_row[led] == NO_LED) {
+        return false;
+    }
+    *row    = led_key_row[led];
+    *column = led_key_col[led];
+    return true;
+}
+#endif // RGB_MATRIX_NEIGHBOR_TABLE
+
 void rgb_matrix_update_pwm_buffers(void) {
     rgb_matrix_driver.flush();
 }
 
 void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+#ifdef RGB_MATRIX_SHADOW_BUFFER
+    if (index >= 0 && index < RGB_MATRIX_LED_COUNT) {
+        RGB *shadow = &rgb_shadow[index];
+        if (shadow->r == red && shadow->g == green && shadow->b == blue) return;
+        shadow->r = red;
+        shadow->g = green;
+        shadow->b = blue;
+    }
+    rgb_shadow_dirty = true;
+#endif // RGB_MATRIX_SHADOW_BUFFER
     rgb_matrix_driver.set_color(index, red, green, blue);
 }
 
@@ -155,6 +276,19 @@ void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
     for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++)
         rgb_matrix_set_color(i, red, green, blue);
 #else
+#    ifdef RGB_MATRIX_SHADOW_BUFFER
+    bool changed = false;
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        if (rgb_shadow[i].r != red || rgb_shadow[i].g != green || rgb_shadow[i].b != blue) {
+            rgb_shadow[i].r = red;
+            rgb_shadow[i].g = green;
+            rgb_shadow[i].b = blue;
+            changed         = true;
+        }
+    }
+    if (!changed) return;
+    rgb_shadow_dirty = true;
+#    endif // RGB_MATRIX_SHADOW_BUFFER
     rgb_matrix_driver.set_color_all(red, green, blue);
 #endif
 }
@@ -245,6 +379,46 @@ static bool rgb_matrix_none(effect_params_t *params) {
     return false;
 }
 
+#ifdef RGB_MATRIX_SHADOW_BUFFER
+#    define RGB_MATRIX_EFFECT_IS_ false
+#    define RGB_MATRIX_EFFECT_IS_STATIC true
+
+// Effects declared as `RGB_MATRIX_EFFECT(name, STATIC)` only depend on the config, not on time or keypresses
+static bool rgb_matrix_effect_is_static(uint8_t effect) {
+    switch (effect) {
+#    define RGB_MATRIX_EFFECT(name, ...) \
+        case RGB_MATRIX_##name:          \
+            return RGB_MATRIX_EFFECT_IS_##__VA_ARGS__;
+#    include "rgb_matrix_effects.inc"
+#    undef RGB_MATRIX_EFFECT
+
+#    if defined(RGB_MATRIX_CUSTOM_KB) || defined(RGB_MATRIX_CUSTOM_USER)
+#        define RGB_MATRIX_EFFECT(name, ...) \
+            case RGB_MATRIX_CUSTOM_##name:   \
+                return RGB_MATRIX_EFFECT_IS_##__VA_ARGS__;
+#        ifdef RGB_MATRIX_CUSTOM_KB
+#            include "rgb_matrix_kb.inc"
+#        endif
+#        ifdef RGB_MATRIX_CUSTOM_USER
+#            include "rgb_matrix_user.inc"
+#        endif
+#        undef RGB_MATRIX_EFFECT
+#    endif
+        default:
+            return false;
+    }
+}
+
+// Stands in for a static effect whose config hasn't changed since its last full render
+static bool rgb_matrix_static_frame(effect_params_t *params) {
+    RGB_MATRIX_USE_LIMITS(led_min, led_max);
+    for (uint8_t i = led_min; i < led_max; i++) {
+        rgb_matrix_set_color(i, rgb_static_frame[i].r, rgb_static_frame[i].g, rgb_static_frame[i].b);
+    }
+    return rgb_matrix_check_finished_leds(led_max);
+}
+#endif // RGB_MATRIX_SHADOW_BUFFER
+
 static void rgb_task_timers(void) {
 #if defined(RGB_MATRIX_KEYREACTIVE_ENABLED) || RGB_MATRIX_TIMEOUT > 0
     uint32_t deltaTime = sync_timer_elapsed32(rgb_timer_buffer);
@@ -277,10 +451,49 @@ static void rgb_task_sync(void) {
     if (sync_timer_elapsed32(g_rgb_timer) >= RGB_MATRIX_LED_FLUSH_LIMIT) rgb_task_state = STARTING;
 }
 
-static void rgb_task_start(void) {
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+static void rgb_task_measure(uint32_t ticks) {
+    // Nothing was rendered, e.g. the factory test pattern
+    if (rgb_effect_params.iter == 0) return;
+    // Longer than every LED taking several times the whole budget, or a negative difference: a bad timestamp, not a slow slice
+    if (ticks > (uint32_t)RGB_MATRIX_RENDER_BUDGET_TICKS * RGB_MATRIX_LED_COUNT * 4) return;
+
+    RGB_MATRIX_USE_LIMITS_ITER(min, max, rgb_effect_params.iter - 1);
+    // Split halves skip the other half's slices, which cost next to nothing
+    if (max <= min) return;
+
+    // Never 0, so a slice too quick for the timestamp to see still counts as measured
+    uint32_t cost = (ticks << 4) / (max - min) + 1;
+    if (rgb_render_cost == 0) {
+        rgb_render_cost = cost;
+    } else {
+        rgb_render_cost = rgb_render_cost - (rgb_render_cost >> 2) + (cost >> 2);
+    }
+}
+
+static void rgb_task_adapt(uint8_t effect) {
+    // A new effect costs something else entirely, start over from the configured limit
+    if (effect != rgb_last_effect || rgb_render_cost == 0) {
+        rgb_render_cost   = 0;
+        rgb_process_limit = RGB_MATRIX_DEFAULT_PROCESS_LIMIT;
+        return;
+    }
+
+    uint32_t limit = (RGB_MATRIX_RENDER_BUDGET_TICKS << 4) / rgb_render_cost;
+    if (limit < 1) limit = 1;
+    if (limit > RGB_MATRIX_LED_COUNT) limit = RGB_MATRIX_LED_COUNT;
+    rgb_process_limit = limit;
+}
+#endif // RGB_MATRIX_RENDER_BUDGET_US
+
+static void rgb_task_start(uint8_t effect) {
     // reset iter
     rgb_effect_params.iter = 0;
 
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    rgb_task_adapt(effect);
+#endif // RGB_MATRIX_RENDER_BUDGET_US
+
     // update double buffers
     g_rgb_timer = rgb_timer_buffer;
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
@@ -299,13 +512,36 @@ static void rgb_task_render(uint8_t effect) {
         rgb_matrix_set_color_all(0, 0, 0);
     }
 
+#ifdef RGB_MATRIX_SHADOW_BUFFER
+    bool is_static = rgb_matrix_effect_is_static(effect);
+    bool replay    = is_static && rgb_static_valid && !rgb_effect_params.init && rgb_static_config.raw == rgb_matrix_config.raw;
+    if (rgb_effect_params.iter == 0) {
+        rgb_static_capturing = is_static && !replay;
+        if (rgb_static_capturing) {
+            rgb_static_valid  = false;
+            rgb_static_config = rgb_matrix_config;
+        }
+    }
+
+    // nothing to calculate if a static effect's config hasn't changed, put back its last full render instead
+    uint8_t render_effect = replay ? RGB_MATRIX_EFFECT_MAX : effect;
+#else
+    uint8_t render_effect = effect;
+#endif // RGB_MATRIX_SHADOW_BUFFER
+
     // each effect can opt to do calculations
     // and/or request PWM buffer updates.
-    switch (effect) {
+    switch (render_effect) {
         case RGB_MATRIX_NONE:
             rendering = rgb_matrix_none(&rgb_effect_params);
             break;
 
+#ifdef RGB_MATRIX_SHADOW_BUFFER
+        case RGB_MATRIX_EFFECT_MAX:
+            rendering = rgb_matrix_static_frame(&rgb_effect_params);
+            break;
+#endif // RGB_MATRIX_SHADOW_BUFFER
+
 // ---------------------------------------------
 // -----Begin rgb effect switch case macros-----
 #define RGB_MATRIX_EFFECT(name, ...)          \
@@ -339,6 +575,17 @@ static void rgb_task_render(uint8_t effect) {
             return;
     }
 
+#ifdef RGB_MATRIX_SHADOW_BUFFER
+    if (rgb_static_capturing && is_static) {
+        // keep this slice's output from before the indicators are drawn over it
+        RGB_MATRIX_USE_LIMITS_ITER(led_min, led_max, rgb_effect_params.iter);
+        if (led_max > led_min) {
+            memcpy(&rgb_static_frame[led_min], &rgb_shadow[led_min], (led_max - led_min) * sizeof(RGB));
+        }
+        rgb_static_valid = !rendering;
+    }
+#endif // RGB_MATRIX_SHADOW_BUFFER
+
     rgb_effect_params.iter++;
 
     // next task
@@ -357,7 +604,15 @@ static void rgb_task_flush(uint8_t effect) {
     rgb_last_enable = rgb_matrix_config.enable;
 
     // update pwm buffers
+#ifdef RGB_MATRIX_SHADOW_BUFFER
+    // skip the bus transfer if no LED changed since the last one
+    if (rgb_shadow_dirty) {
+        rgb_shadow_dirty = false;
+        rgb_matrix_update_pwm_buffers();
+    }
+#else
     rgb_matrix_update_pwm_buffers();
+#endif // RGB_MATRIX_SHADOW_BUFFER
 
     // next task
     rgb_task_state = SYNCING;
@@ -378,9 +633,12 @@ void rgb_matrix_task(void) {
 
     switch (rgb_task_state) {
         case STARTING:
-            rgb_task_start();
+            rgb_task_start(effect);
             break;
-        case RENDERING:
+        case RENDERING: {
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+            uint32_t render_start = timer_read_raw32();
+#endif // RGB_MATRIX_RENDER_BUDGET_US
             rgb_task_render(effect);
             if (effect) {
                 if (rgb_task_state == FLUSHING) { // ensure we only draw basic indicators once rendering is finished
@@ -388,7 +646,10 @@ void rgb_matrix_task(void) {
                 }
                 rgb_matrix_indicators_advanced(&rgb_effect_params);
             }
-            break;
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+            rgb_task_measure(timer_read_raw32() - render_start);
+#endif // RGB_MATRIX_RENDER_BUDGET_US
+        } break;
         case FLUSHING:
             rgb_task_flush(effect);
             break;
@@ -410,20 +671,27 @@ __attribute__((weak)) bool rgb_matrix_indicators_user(void) {
     return true;
 }
 
+uint8_t rgb_matrix_get_process_limit(void) {
+#ifdef RGB_MATRIX_RENDER_BUDGET_US
+    return rgb_process_limit;
+#else
+    return RGB_MATRIX_DEFAULT_PROCESS_LIMIT;
+#endif // RGB_MATRIX_RENDER_BUDGET_US
+}
+
 struct rgb_matrix_limits_t rgb_matrix_get_limits(uint8_t iter) {
     struct rgb_matrix_limits_t limits = {0};
-#if defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < RGB_MATRIX_LED_COUNT
+#if defined(RGB_MATRIX_RENDER_BUDGET_US) || RGB_MATRIX_DEFAULT_PROCESS_LIMIT < RGB_MATRIX_LED_COUNT
+    // The slice size can be anything up to the LED count, so the upper bound may not fit in 8 bits
+    uint8_t  process_limit = rgb_matrix_get_process_limit();
+    uint16_t led_min       = process_limit * (iter);
+    uint16_t led_max       = led_min + process_limit;
+    limits.led_min_index   = led_min < RGB_MATRIX_LED_COUNT ? led_min : RGB_MATRIX_LED_COUNT;
+    limits.led_max_index   = led_max < RGB_MATRIX_LED_COUNT ? led_max : RGB_MATRIX_LED_COUNT;
 #    if defined(RGB_MATRIX_SPLIT)
-    limits.led_min_index = RGB_MATRIX_LED_PROCESS_LIMIT * (iter);
-    limits.led_max_index = limits.led_min_index + RGB_MATRIX_LED_PROCESS_LIMIT;
-    if (limits.led_max_index > RGB_MATRIX_LED_COUNT) limits.led_max_index = RGB_MATRIX_LED_COUNT;
     uint8_t k_rgb_matrix_split[2] = RGB_MATRIX_SPLIT;
     if (is_keyboard_left() && (limits.led_max_index > k_rgb_matrix_split[0])) limits.led_max_index = k_rgb_matrix_split[0];
     if (!(is_keyboard_left()) && (limits.led_min_index < k_rgb_matrix_split[0])) limits.led_min_index = k_rgb_matrix_split[0];
-#    else
-    limits.led_min_index = RGB_MATRIX_LED_PROCESS_LIMIT * (iter);
-    limits.led_max_index = limits.led_min_index + RGB_MATRIX_LED_PROCESS_LIMIT;
-    if (limits.led_max_index > RGB_MATRIX_LED_COUNT) limits.led_max_index = RGB_MATRIX_LED_COUNT;
 #    endif
 #else
 #    if defined(RGB_MATRIX_SPLIT)
@@ -461,6 +729,10 @@ __attribute__((weak)) bool rgb_matrix_indicators_advanced_user(uint8_t led_min,
 void rgb_matrix_init(void) {
     rgb_matrix_driver.init();
 
+#ifdef RGB_MATRIX_NEIGHBOR_TABLE
+    rgb_matrix_update_neighbor_table();
+#endif // RGB_MATRIX_NEIGHBOR_TABLE
+
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
     g_last_hit_tracker.count = 0;
     for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
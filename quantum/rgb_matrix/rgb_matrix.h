@@ -113,6 +113,8 @@ struct rgb_matrix_limits_t {
 };
 
 struct rgb_matrix_limits_t rgb_matrix_get_limits(uint8_t iter);
+// Number of LEDs rendered per task iteration in the current frame
+uint8_t rgb_matrix_get_process_limit(void);
 
 #define RGB_MATRIX_USE_LIMITS_ITER(min, max, iter)                   \
     struct rgb_matrix_limits_t limits = rgb_matrix_get_limits(iter); \
@@ -162,6 +164,12 @@ void eeconfig_update_rgb_matrix(void);
 uint8_t rgb_matrix_map_row_column_to_led_kb(uint8_t row, uint8_t column, uint8_t *led_i);
 uint8_t rgb_matrix_map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *led_i);
 
+#ifdef RGB_MATRIX_NEIGHBOR_TABLE
+void                  rgb_matrix_update_neighbor_table(void);
+const led_neighbor_t *rgb_matrix_get_neighbors(uint8_t led, uint8_t min_dist, uint8_t max_dist, uint8_t *count);
+bool                  rgb_matrix_map_led_to_row_column(uint8_t led, uint8_t *row, uint8_t *column);
+#endif // RGB_MATRIX_NEIGHBOR_TABLE
+
 void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue);
 void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue);
 
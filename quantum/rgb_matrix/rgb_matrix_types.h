@@ -40,6 +40,13 @@ typedef struct PACKED {
 } last_hit_t;
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
 
+#ifdef RGB_MATRIX_NEIGHBOR_TABLE
+typedef struct PACKED {
+    uint8_t index;
+    uint8_t dist;
+} led_neighbor_t;
+#endif // RGB_MATRIX_NEIGHBOR_TABLE
+
 typedef enum rgb_task_states { STARTING, RENDERING, FLUSHING, SYNCING } rgb_task_states;
 
 typedef uint8_t led_flags_t;
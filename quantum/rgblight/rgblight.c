@@ -27,6 +27,11 @@
 #ifdef EEPROM_ENABLE
 #    include "eeprom.h"
 #endif
+#if defined(RGBLIGHT_TIMELINE_ENABLE) && (defined(RGBLIGHT_EFFECT_RAINBOW_MOOD) || defined(RGBLIGHT_EFFECT_RAINBOW_SWIRL) || defined(RGBLIGHT_EFFECT_SNAKE))
+#    define RGBLIGHT_USE_TIMELINE
+#    include "deferred_exec.h"
+#    include "rgblight_timeline.h"
+#endif
 
 #ifdef RGBLIGHT_SPLIT
 /* for split keyboard */
@@ -1040,6 +1045,150 @@ void rgblight_show_solid_color(uint8_t r, uint8_t g, uint8_t b) {
     rgblight_setrgb(r, g, b);
 }
 
+#    ifdef RGBLIGHT_USE_TIMELINE
+#        if defined(RGBLIGHT_EFFECT_RAINBOW_MOOD) || defined(RGBLIGHT_EFFECT_RAINBOW_SWIRL)
+static const rgblight_keyframe_t timeline_hue_up[] PROGMEM = {{0, 0, 255, 255}, {255, 255, 255, 255}};
+#        endif
+#        ifdef RGBLIGHT_EFFECT_RAINBOW_SWIRL
+static const rgblight_keyframe_t timeline_hue_down[] PROGMEM = {{0, 0, 255, 255}, {255, -255, 255, 255}};
+#        endif
+#        ifdef RGBLIGHT_EFFECT_SNAKE
+static const rgblight_keyframe_t timeline_snake[] PROGMEM = {{0, 0, 255, 255}, {RGBLIGHT_EFFECT_SNAKE_LENGTH, 0, 255, 0}};
+#        endif
+
+static deferred_executor_t timeline_executors[1] = {0};
+static uint32_t            timeline_last_exec    = 0;
+static uint32_t            timeline_due          = 0;
+static deferred_token      timeline_token        = INVALID_DEFERRED_TOKEN;
+static rgblight_timeline_t timeline              = {0};
+static uint32_t            timeline_anchor       = 0;
+static uint32_t            timeline_base         = 0;
+static uint8_t             timeline_interval     = 0;
+static uint8_t             timeline_ticks        = 1;
+static HSV                 timeline_rendered_hsv = {0};
+
+// Picks the timeline for the current mode, which advances `ticks` every `interval` ms, or returns false to leave it to the effect functions
+static bool timeline_for_mode(rgblight_timeline_t *tl, uint8_t *interval, uint8_t *ticks) {
+    uint8_t delta = rgblight_config.mode - rgblight_status.base_mode;
+    *ticks        = 1;
+    if (rgblight_ranges.effect_num_leds == 0) {
+        return false;
+    }
+    switch (rgblight_status.base_mode) {
+#        ifdef RGBLIGHT_EFFECT_RAINBOW_MOOD
+        case RGBLIGHT_MODE_RAINBOW_MOOD:
+            *tl       = (rgblight_timeline_t){timeline_hue_up, ARRAY_SIZE(timeline_hue_up), false, 256, 0};
+            *interval = get_interval_time(&RGBLED_RAINBOW_MOOD_INTERVALS[delta], 5, 100);
+            return true;
+#        endif
+#        ifdef RGBLIGHT_EFFECT_RAINBOW_SWIRL
+        case RGBLIGHT_MODE_RAINBOW_SWIRL:
+            // Going down, the hue still has to increase along the strip
+            if (delta % 2) {
+                *tl = (rgblight_timeline_t){timeline_hue_up, ARRAY_SIZE(timeline_hue_up), false, 256, RGBLIGHT_RAINBOW_SWIRL_RANGE / rgblight_ranges.effect_num_leds};
+            } else {
+                *tl = (rgblight_timeline_t){timeline_hue_down, ARRAY_SIZE(timeline_hue_down), false, 256, -(RGBLIGHT_RAINBOW_SWIRL_RANGE / rgblight_ranges.effect_num_leds)};
+            }
+            *interval = get_interval_time(&RGBLED_RAINBOW_SWIRL_INTERVALS[delta / 2], 1, 100);
+            return true;
+#        endif
+#        ifdef RGBLIGHT_EFFECT_SNAKE
+        case RGBLIGHT_MODE_SNAKE:
+            *tl       = (rgblight_timeline_t){timeline_snake, ARRAY_SIZE(timeline_snake), true, rgblight_ranges.effect_num_leds, delta % 2 ? -1 : 1};
+            *interval = get_interval_time(&RGBLED_SNAKE_INTERVALS[delta / 2], 1, 200);
+            *ticks    = RGBLIGHT_EFFECT_SNAKE_INCREMENT;
+            return true;
+#        endif
+        default:
+            return false;
+    }
+}
+
+static uint32_t timeline_render(uint32_t trigger_time, void *cb_arg) {
+    uint8_t interval, ticks;
+    if (!timeline_for_mode(&timeline, &interval, &ticks)) {
+        return 1000;
+    }
+
+    uint32_t now          = sync_timer_read32();
+    uint32_t cycle        = (uint32_t)timeline.duration * RGBLIGHT_TIMELINE_SUBTICKS;
+    uint32_t per_interval = (uint32_t)ticks * RGBLIGHT_TIMELINE_SUBTICKS;
+    if (interval != timeline_interval || ticks != timeline_ticks) {
+        // Velocikey changed the speed, carry on from where the old speed got to
+        if (timeline_interval) {
+            timeline_base = (timeline_base + (now - timeline_anchor) * ((uint32_t)timeline_ticks * RGBLIGHT_TIMELINE_SUBTICKS) / timeline_interval) % cycle;
+        }
+        timeline_anchor   = now;
+        timeline_interval = interval;
+        timeline_ticks    = ticks;
+    }
+
+    // Move the anchor on by whole intervals, so the elapsed time stays small and nothing drifts
+    uint32_t elapsed   = now - timeline_anchor;
+    uint32_t intervals = elapsed / interval;
+    if (intervals) {
+        uint32_t base = timeline_base + intervals % timeline.duration * per_interval;
+#        if defined(RGBLIGHT_SPLIT) && !defined(RGBLIGHT_SPLIT_NO_ANIMATION_SYNC)
+        // The unreduced position is timeline_base + intervals * per_interval, which wraps at least once whenever a
+        // whole duration of intervals went by, so that case can't hide behind the modulo above
+        static uint32_t report_last_timer = 0;
+        bool            wrapped           = intervals >= timeline.duration || base >= cycle;
+        if (wrapped && timer_expired32(now, report_last_timer)) {
+            report_last_timer = now + 30000;
+            dprintf("rgblight animation tick report to slave\n");
+            RGBLIGHT_SPLIT_ANIMATION_TICK;
+        }
+#        endif
+        timeline_base = base % cycle;
+        timeline_anchor += intervals * interval;
+        elapsed -= intervals * interval;
+    }
+    uint32_t position = timeline_base + elapsed * per_interval / interval;
+
+    rgblight_timeline_iter_t iter;
+    HSV                      hsv;
+    rgblight_timeline_begin(&iter, &timeline, position);
+    for (uint8_t i = 0; i < rgblight_ranges.effect_num_leds; i++) {
+        rgblight_timeline_eval_next(&iter, &hsv);
+        // A keyframe at 255 keeps the configured saturation and value as they are
+        sethsv(rgblight_config.hue + hsv.h, (uint16_t)rgblight_config.sat * (hsv.s + 1) >> 8, (uint16_t)rgblight_config.val * (hsv.v + 1) >> 8, (rgb_led_t *)&led[i + rgblight_ranges.effect_start_pos]);
+    }
+    rgblight_set();
+    timeline_rendered_hsv = (HSV){rgblight_config.hue, rgblight_config.sat, rgblight_config.val};
+
+    // The executor counts from when this was due rather than from now
+    return ((uint32_t)iter.next * interval + per_interval - 1) / per_interval + timer_elapsed32(trigger_time);
+}
+
+static void rgblight_timeline_task(void) {
+    rgblight_timeline_t tl;
+    uint8_t             interval, ticks;
+    if (rgblight_status.timer_enabled && timeline_for_mode(&tl, &interval, &ticks)) {
+        if (animation_status.restart || timeline_token == INVALID_DEFERRED_TOKEN) {
+            cancel_deferred_exec_advanced(timeline_executors, ARRAY_SIZE(timeline_executors), timeline_token);
+            timeline_anchor   = sync_timer_read32();
+            timeline_base     = 0;
+            timeline_interval = 0;
+            timeline_token    = defer_exec_advanced(timeline_executors, ARRAY_SIZE(timeline_executors), 1, timeline_render, NULL);
+            deferred_exec_advanced_next_trigger(timeline_executors, ARRAY_SIZE(timeline_executors), &timeline_due);
+        } else if (timeline_rendered_hsv.h != rgblight_config.hue || timeline_rendered_hsv.s != rgblight_config.sat || timeline_rendered_hsv.v != rgblight_config.val) {
+            // The timeline only wakes up when it changes by itself, so show a new colour straight away
+            timeline_rendered_hsv = (HSV){rgblight_config.hue, rgblight_config.sat, rgblight_config.val};
+            extend_deferred_exec_advanced(timeline_executors, ARRAY_SIZE(timeline_executors), timeline_token, 1);
+            deferred_exec_advanced_next_trigger(timeline_executors, ARRAY_SIZE(timeline_executors), &timeline_due);
+        }
+    } else if (timeline_token != INVALID_DEFERRED_TOKEN) {
+        cancel_deferred_exec_advanced(timeline_executors, ARRAY_SIZE(timeline_executors), timeline_token);
+        timeline_token = INVALID_DEFERRED_TOKEN;
+    }
+    // Only hand over to the executor once the next render is due, rather than on every loop
+    if (timeline_token != INVALID_DEFERRED_TOKEN && timer_expired32(timer_read32(), timeline_due)) {
+        deferred_exec_advanced_task(timeline_executors, ARRAY_SIZE(timeline_executors), &timeline_last_exec);
+        deferred_exec_advanced_next_trigger(timeline_executors, ARRAY_SIZE(timeline_executors), &timeline_due);
+    }
+}
+#    endif
+
 static void rgblight_effect_dummy(animation_status_t *anim) {
     // do nothing
     /********
@@ -1053,6 +1202,9 @@ static void rgblight_effect_dummy(animation_status_t *anim) {
 }
 
 void rgblight_timer_task(void) {
+#    ifdef RGBLIGHT_USE_TIMELINE
+    rgblight_timeline_task();
+#    endif
     if (rgblight_status.timer_enabled) {
         effect_func_t effect_func   = rgblight_effect_dummy;
         uint16_t      interval_time = 2000; // dummy interval
@@ -1069,21 +1221,21 @@ void rgblight_timer_task(void) {
             effect_func   = rgblight_effect_breathing;
         }
 #    endif
-#    ifdef RGBLIGHT_EFFECT_RAINBOW_MOOD
+#    if defined(RGBLIGHT_EFFECT_RAINBOW_MOOD) && !defined(RGBLIGHT_USE_TIMELINE)
         else if (rgblight_status.base_mode == RGBLIGHT_MODE_RAINBOW_MOOD) {
             // rainbow mood mode
             interval_time = get_interval_time(&RGBLED_RAINBOW_MOOD_INTERVALS[delta], 5, 100);
             effect_func   = rgblight_effect_rainbow_mood;
         }
 #    endif
-#    ifdef RGBLIGHT_EFFECT_RAINBOW_SWIRL
+#    if defined(RGBLIGHT_EFFECT_RAINBOW_SWIRL) && !defined(RGBLIGHT_USE_TIMELINE)
         else if (rgblight_status.base_mode == RGBLIGHT_MODE_RAINBOW_SWIRL) {
             // rainbow swirl mode
             interval_time = get_interval_time(&RGBLED_RAINBOW_SWIRL_INTERVALS[delta / 2], 1, 100);
             effect_func   = rgblight_effect_rainbow_swirl;
         }
 #    endif
-#    ifdef RGBLIGHT_EFFECT_SNAKE
+#    if defined(RGBLIGHT_EFFECT_SNAKE) && !defined(RGBLIGHT_USE_TIMELINE)
         else if (rgblight_status.base_mode == RGBLIGHT_MODE_SNAKE) {
             // snake mode
             interval_time = get_interval_time(&RGBLED_SNAKE_INTERVALS[delta / 2], 1, 200);
@@ -1221,10 +1373,6 @@ void rgblight_effect_rainbow_mood(animation_status_t *anim) {
 #endif
 
 #ifdef RGBLIGHT_EFFECT_RAINBOW_SWIRL
-#    ifndef RGBLIGHT_RAINBOW_SWIRL_RANGE
-#        define RGBLIGHT_RAINBOW_SWIRL_RANGE 255
-#    endif
-
 __attribute__((weak)) const uint8_t RGBLED_RAINBOW_SWIRL_INTERVALS[] PROGMEM = {100, 50, 20};
 
 void rgblight_effect_rainbow_swirl(animation_status_t *anim) {
@@ -105,6 +105,10 @@ enum RGBLIGHT_EFFECT_MODE {
 #    define RGBLIGHT_EFFECT_BREATHE_MAX 255 // 0-255
 #endif
 
+#ifndef RGBLIGHT_RAINBOW_SWIRL_RANGE
+#    define RGBLIGHT_RAINBOW_SWIRL_RANGE 255
+#endif
+
 #ifndef RGBLIGHT_EFFECT_SNAKE_LENGTH
 #    define RGBLIGHT_EFFECT_SNAKE_LENGTH 4
 #endif
@@ -0,0 +1,198 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "rgblight_timeline.h"
+#include "progmem.h"
+
+// Interpolates one channel at `pos` of `den` subticks, and lowers `next` to the subticks until its output changes
+static int16_t interpolate(int16_t from, int16_t to, uint32_t pos, uint32_t den, uint32_t *next) {
+    int32_t  delta     = (int32_t)to - from;
+    uint32_t magnitude = delta < 0 ? -delta : delta;
+    if (magnitude == 0) {
+        return from;
+    }
+
+    // The output moves by one every den/magnitude subticks, truncated towards `from`
+    uint32_t steps  = magnitude * pos / den;
+    uint32_t change = ((steps + 1) * den + magnitude - 1) / magnitude;
+    if (change - pos < *next) {
+        *next = change - pos;
+    }
+    return from + (delta < 0 ? -(int32_t)steps : (int32_t)steps);
+}
+
+uint32_t rgblight_timeline_eval(const rgblight_timeline_t *timeline, uint8_t led, uint32_t position, HSV *hsv) {
+    const uint32_t cycle = (uint32_t)timeline->duration * RGBLIGHT_TIMELINE_SUBTICKS;
+
+    int32_t  phase = ((int32_t)timeline->led_phase * led) % timeline->duration;
+    uint32_t local = (position + (uint32_t)(phase < 0 ? phase + timeline->duration : phase) * RGBLIGHT_TIMELINE_SUBTICKS) % cycle;
+
+    // Stepped timelines are evaluated at the start of the tick
+    uint32_t offset = 0;
+    if (timeline->step) {
+        offset = local % RGBLIGHT_TIMELINE_SUBTICKS;
+        local -= offset;
+    }
+
+    rgblight_keyframe_t from, to;
+    uint8_t             index = 0;
+    memcpy_P(&from, &timeline->keyframes[0], sizeof(from));
+    while (index + 1 < timeline->keyframe_count) {
+        memcpy_P(&to, &timeline->keyframes[index + 1], sizeof(to));
+        if ((uint32_t)to.time * RGBLIGHT_TIMELINE_SUBTICKS > local) break;
+        from = to;
+        index++;
+    }
+
+    uint32_t next;
+    if (index + 1 == timeline->keyframe_count) {
+        // Hold the last keyframe until the cycle starts over
+        hsv->h = from.hue;
+        hsv->s = from.sat;
+        hsv->v = from.val;
+        next   = cycle - local;
+    } else {
+        uint32_t start = (uint32_t)from.time * RGBLIGHT_TIMELINE_SUBTICKS;
+        uint32_t den   = (uint32_t)(to.time - from.time) * RGBLIGHT_TIMELINE_SUBTICKS;
+        uint32_t pos   = local - start;
+
+        next   = den - pos;
+        hsv->h = interpolate(from.hue, to.hue, pos, den, &next);
+        hsv->s = interpolate(from.sat, to.sat, pos, den, &next);
+        hsv->v = interpolate(from.val, to.val, pos, den, &next);
+    }
+
+    if (timeline->step) {
+        // The change shows at the first whole tick it has happened by
+        next = (next + RGBLIGHT_TIMELINE_SUBTICKS - 1) / RGBLIGHT_TIMELINE_SUBTICKS * RGBLIGHT_TIMELINE_SUBTICKS - offset;
+    }
+    return next;
+}
+
+// Lowers `iter->next` to `change` subticks from the start of the tick being evaluated, rounded up to a whole tick when stepped
+static void lower_next(rgblight_timeline_iter_t *iter, uint16_t change) {
+    if (iter->timeline->step) {
+        change = (change + RGBLIGHT_TIMELINE_SUBTICKS - 1) / RGBLIGHT_TIMELINE_SUBTICKS * RGBLIGHT_TIMELINE_SUBTICKS - iter->offset;
+    }
+    if (change < iter->next) {
+        iter->next = change;
+    }
+}
+
+// Sets up one channel for the LED at `pos` of the segment, and lowers `iter->next` to the subticks until its output changes
+static void enter_channel(rgblight_timeline_iter_t *iter, rgblight_timeline_channel_t *channel, int16_t from, int16_t to, uint16_t pos) {
+    int32_t  delta     = (int32_t)to - from;
+    uint32_t magnitude = delta < 0 ? -delta : delta;
+    uint32_t length    = iter->length;
+    uint32_t scaled    = magnitude * pos;
+    uint32_t steps     = scaled / length;
+
+    channel->down      = delta < 0;
+    channel->value     = from + (channel->down ? -(int32_t)steps : (int32_t)steps);
+    channel->remainder = scaled % length;
+    channel->whole     = 0;
+    channel->fraction  = 0;
+    if (magnitude == 0) {
+        return;
+    }
+    // Neighbouring LEDs further apart than the segment is long never share it
+    if (iter->phase < length) {
+        channel->whole    = magnitude * iter->phase / length;
+        channel->fraction = magnitude * iter->phase % length;
+    }
+    lower_next(iter, ((steps + 1) * length + magnitude - 1) / magnitude - pos);
+}
+
+// Finds the segment of the next LED, which is the only place the keyframes are read and anything is divided
+static void enter_segment(rgblight_timeline_iter_t *iter) {
+    const rgblight_timeline_t *timeline = iter->timeline;
+    rgblight_keyframe_t        from, to;
+
+    // Wrapped around to the start of the cycle
+    if (iter->local < iter->start) {
+        iter->index = 0;
+    }
+    memcpy_P(&from, &timeline->keyframes[iter->index], sizeof(from));
+    while (iter->index + 1 < timeline->keyframe_count) {
+        memcpy_P(&to, &timeline->keyframes[iter->index + 1], sizeof(to));
+        if (to.time * RGBLIGHT_TIMELINE_SUBTICKS > iter->local) break;
+        from = to;
+        iter->index++;
+    }
+
+    iter->in_segment = true;
+    iter->start      = from.time * RGBLIGHT_TIMELINE_SUBTICKS;
+    if (iter->index + 1 == timeline->keyframe_count) {
+        // Hold the last keyframe until the cycle starts over
+        iter->end         = iter->cycle;
+        iter->length      = 0;
+        iter->channels[0] = (rgblight_timeline_channel_t){.value = from.hue};
+        iter->channels[1] = (rgblight_timeline_channel_t){.value = from.sat};
+        iter->channels[2] = (rgblight_timeline_channel_t){.value = from.val};
+        return;
+    }
+
+    uint16_t pos = iter->local - iter->start;
+    iter->end    = to.time * RGBLIGHT_TIMELINE_SUBTICKS < iter->cycle ? to.time * RGBLIGHT_TIMELINE_SUBTICKS : iter->cycle;
+    iter->length = (to.time - from.time) * RGBLIGHT_TIMELINE_SUBTICKS;
+    enter_channel(iter, &iter->channels[0], from.hue, to.hue, pos);
+    enter_channel(iter, &iter->channels[1], from.sat, to.sat, pos);
+    enter_channel(iter, &iter->channels[2], from.val, to.val, pos);
+}
+
+// Moves a channel on by the phase between neighbouring LEDs
+static void step_channel(rgblight_timeline_channel_t *channel, uint16_t length) {
+    uint16_t steps = channel->whole;
+    if (channel->remainder >= length - channel->fraction) {
+        channel->remainder -= length - channel->fraction;
+        steps++;
+    } else {
+        channel->remainder += channel->fraction;
+    }
+    channel->value += channel->down ? -(int16_t)steps : (int16_t)steps;
+}
+
+void rgblight_timeline_begin(rgblight_timeline_iter_t *iter, const rgblight_timeline_t *timeline, uint32_t position) {
+    int16_t phase = timeline->led_phase % (int16_t)timeline->duration;
+
+    iter->timeline   = timeline;
+    iter->cycle      = timeline->duration * RGBLIGHT_TIMELINE_SUBTICKS;
+    iter->next       = iter->cycle;
+    iter->phase      = (phase < 0 ? phase + timeline->duration : phase) * RGBLIGHT_TIMELINE_SUBTICKS;
+    iter->local      = position % iter->cycle;
+    iter->in_segment = false;
+    iter->index      = 0;
+    iter->start      = 0;
+
+    // Stepped timelines are evaluated at the start of the tick, and the phase is in whole ticks so every LED is as far into it
+    iter->offset = 0;
+    if (timeline->step) {
+        iter->offset = iter->local % RGBLIGHT_TIMELINE_SUBTICKS;
+        iter->local -= iter->offset;
+    }
+}
+
+void rgblight_timeline_eval_next(rgblight_timeline_iter_t *iter, HSV *hsv) {
+    if (!iter->in_segment) {
+        enter_segment(iter);
+    }
+    hsv->h = iter->channels[0].value;
+    hsv->s = iter->channels[1].value;
+    hsv->v = iter->channels[2].value;
+    lower_next(iter, iter->end - iter->local);
+
+    uint16_t room = iter->cycle - iter->local;
+    if (iter->phase >= room) {
+        iter->local      = iter->phase - room;
+        iter->in_segment = false;
+    } else {
+        iter->local += iter->phase;
+        if (iter->local >= iter->end) {
+            iter->in_segment = false;
+        } else if (iter->length) {
+            step_channel(&iter->channels[0], iter->length);
+            step_channel(&iter->channels[1], iter->length);
+            step_channel(&iter->channels[2], iter->length);
+        }
+    }
+}
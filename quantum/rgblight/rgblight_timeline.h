@@ -0,0 +1,120 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "color.h"
+#include "util.h"
+
+/**
+ * \file
+ *
+ * \defgroup rgblight_timeline RGB Light Timeline
+ *
+ * Evaluates keyframe animations for rgblight. A timeline is a table of
+ * keyframes in flash, which is linearly interpolated between keyframes and
+ * holds the last keyframe until the end of the cycle. Every LED can run the
+ * timeline at its own phase offset.
+ *
+ * Positions are measured in 1/`RGBLIGHT_TIMELINE_SUBTICKS` of a tick; the
+ * length of a tick in milliseconds is up to the caller. Interpolation is done
+ * in 32 bits, so the change of a channel between two keyframes times the
+ * number of ticks between them must stay below 2^28.
+ *
+ * Rendering a strip goes through `rgblight_timeline_begin()` and
+ * `rgblight_timeline_eval_next()`, which step from one LED to the next in 16
+ * bits without dividing, so the duration and every keyframe time must stay
+ * below 4096 ticks there.
+ * \{
+ */
+
+#define RGBLIGHT_TIMELINE_SUBTICKS 16
+
+typedef struct PACKED {
+    // Start of the keyframe, in ticks from the start of the cycle
+    uint16_t time;
+    // Added to the configured hue; not wrapped, so that a ramp can span a full turn
+    int16_t hue;
+    // Scale the configured saturation and value
+    uint8_t sat;
+    uint8_t val;
+} rgblight_keyframe_t;
+
+typedef struct {
+    // In PROGMEM, in ascending order of time, the first one at 0
+    const rgblight_keyframe_t *keyframes;
+    uint8_t                    keyframe_count;
+    // Change the output on whole ticks only, instead of interpolating in between
+    bool step;
+    // Length of a cycle in ticks, which cuts the timeline short if it ends before the last keyframe
+    uint16_t duration;
+    // Ticks each LED runs ahead of the previous one, may be negative
+    int16_t led_phase;
+} rgblight_timeline_t;
+
+// Interpolation state of one channel within a segment
+typedef struct {
+    int16_t  value;
+    bool     down;
+    // Subticks elapsed in the segment times the change of the channel, modulo the length of the segment
+    uint16_t remainder;
+    // Steps the channel moves between neighbouring LEDs, split into whole steps and the remainder as above
+    uint16_t whole;
+    uint16_t fraction;
+} rgblight_timeline_channel_t;
+
+typedef struct {
+    const rgblight_timeline_t *timeline;
+    // Subticks, at least 1, until the LEDs evaluated so far need rendering again
+    uint16_t next;
+    uint16_t cycle;
+    uint16_t phase;
+    // Position of the next LED in the cycle, in subticks, and how far into the tick it is for stepped timelines
+    uint16_t local;
+    uint8_t  offset;
+    // Segment the next LED is in, between keyframe `index` and the following one, or the hold after the last
+    bool                        in_segment;
+    uint8_t                     index;
+    uint16_t                    start;
+    uint16_t                    end;
+    uint16_t                    length;
+    rgblight_timeline_channel_t channels[3];
+} rgblight_timeline_iter_t;
+
+/**
+ * \brief Evaluates the timeline for one LED.
+ *
+ * \param timeline The timeline to evaluate
+ * \param led Index of the LED, which determines its phase offset
+ * \param position Position in the cycle, in subticks
+ * \param hsv Receives the keyframe output: hue offset, saturation and value scale
+ *
+ * \return Number of subticks, at least 1, until the output of this LED next changes
+ */
+uint32_t rgblight_timeline_eval(const rgblight_timeline_t *timeline, uint8_t led, uint32_t position, HSV *hsv);
+
+/**
+ * \brief Starts evaluating the timeline for a strip of LEDs, from LED 0.
+ *
+ * \param iter Receives the state, which `iter->next` is read from once the last LED has been evaluated
+ * \param timeline The timeline to evaluate
+ * \param position Position in the cycle, in subticks
+ */
+void rgblight_timeline_begin(rgblight_timeline_iter_t *iter, const rgblight_timeline_t *timeline, uint32_t position);
+
+/**
+ * \brief Evaluates the timeline for the next LED of the strip.
+ *
+ * Gives the same output as `rgblight_timeline_eval()`. To save dividing for
+ * every LED, `iter->next` is only exact for the first LED to enter each
+ * segment; LEDs following it through the same segment change at the same
+ * rate and are caught up on its changes, or when they reach another keyframe.
+ *
+ * \param iter State from `rgblight_timeline_begin()`
+ * \param hsv Receives the keyframe output: hue offset, saturation and value scale
+ */
+void rgblight_timeline_eval_next(rgblight_timeline_iter_t *iter, HSV *hsv);
+
+/** \} */
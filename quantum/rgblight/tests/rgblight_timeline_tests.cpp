@@ -0,0 +1,171 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "rgblight_timeline.h"
+}
+
+static const rgblight_keyframe_t hue_up[]   = {{0, 0, 255, 255}, {255, 255, 255, 255}};
+static const rgblight_keyframe_t fade[]     = {{0, 0, 255, 255}, {10, 3, 100, 0}, {20, -7, 200, 50}};
+static const rgblight_keyframe_t snake[]    = {{0, 0, 255, 255}, {4, 0, 255, 0}};
+static const rgblight_keyframe_t constant[] = {{0, 5, 10, 20}};
+
+static bool hsv_equal(const HSV &a, const HSV &b) {
+    return a.h == b.h && a.s == b.s && a.v == b.v;
+}
+
+// Checks that the output stays put for exactly as long as eval says, for every LED and position in a cycle
+static void expect_next_change_exact(const rgblight_timeline_t &timeline, uint8_t leds) {
+    const uint32_t cycle = (uint32_t)timeline.duration * RGBLIGHT_TIMELINE_SUBTICKS;
+    for (uint8_t led = 0; led < leds; led++) {
+        for (uint32_t position = 0; position < cycle; position++) {
+            HSV      hsv, later;
+            uint32_t next = rgblight_timeline_eval(&timeline, led, position, &hsv);
+            ASSERT_GE(next, 1) << "led " << (int)led << " position " << position;
+            for (uint32_t i = 1; i < next; i++) {
+                rgblight_timeline_eval(&timeline, led, position + i, &later);
+                ASSERT_TRUE(hsv_equal(hsv, later)) << "led " << (int)led << " changed early at " << position + i << ", expected " << position + next;
+            }
+            rgblight_timeline_eval(&timeline, led, position + next, &later);
+            if (next < cycle) {
+                ASSERT_FALSE(hsv_equal(hsv, later)) << "led " << (int)led << " didn't change at " << position + next;
+            }
+        }
+    }
+}
+
+class RgblightTimeline : public ::testing::Test {};
+
+/**
+ * This test verifies that a ramp lands on the keyframe values at whole ticks, matching a counter bumped every tick.
+ */
+TEST_F(RgblightTimeline, HueRamp) {
+    rgblight_timeline_t timeline = {hue_up, 2, false, 256, 0};
+    for (uint32_t tick = 0; tick < 512; tick++) {
+        HSV hsv;
+        rgblight_timeline_eval(&timeline, 0, tick * RGBLIGHT_TIMELINE_SUBTICKS, &hsv);
+        EXPECT_EQ(hsv.h, (uint8_t)tick);
+        EXPECT_EQ(hsv.s, 255);
+        EXPECT_EQ(hsv.v, 255);
+    }
+}
+
+/**
+ * This test verifies that the time until the next change is exact, so nothing is rendered twice or missed.
+ */
+TEST_F(RgblightTimeline, NextChange) {
+    expect_next_change_exact({hue_up, 2, false, 256, 0}, 1);
+    expect_next_change_exact({fade, 3, false, 30, 0}, 1);
+    expect_next_change_exact({fade, 3, false, 15, 0}, 1);
+    expect_next_change_exact({snake, 2, true, 10, 1}, 10);
+}
+
+/**
+ * This test verifies that the last keyframe is held until the cycle starts over.
+ */
+TEST_F(RgblightTimeline, HoldsLastKeyframe) {
+    rgblight_timeline_t timeline = {fade, 3, false, 30, 0};
+    HSV                 hsv;
+    EXPECT_EQ(rgblight_timeline_eval(&timeline, 0, 20 * RGBLIGHT_TIMELINE_SUBTICKS, &hsv), 10 * RGBLIGHT_TIMELINE_SUBTICKS);
+    EXPECT_EQ((int8_t)hsv.h, -7);
+    EXPECT_EQ(hsv.s, 200);
+    EXPECT_EQ(hsv.v, 50);
+
+    timeline = {constant, 1, false, 8, 3};
+    EXPECT_EQ(rgblight_timeline_eval(&timeline, 2, 0, &hsv), 2 * RGBLIGHT_TIMELINE_SUBTICKS);
+    EXPECT_TRUE(hsv_equal(hsv, {5, 10, 20}));
+}
+
+/**
+ * This test verifies that a stepped timeline only changes on whole ticks, and that LEDs run at their phase offsets
+ * in either direction.
+ */
+TEST_F(RgblightTimeline, SteppedPhases) {
+    for (int16_t phase : {1, -1}) {
+        rgblight_timeline_t timeline = {snake, 2, true, 10, phase};
+        for (uint32_t position = 0; position < 10 * RGBLIGHT_TIMELINE_SUBTICKS; position++) {
+            uint32_t tick = position / RGBLIGHT_TIMELINE_SUBTICKS;
+            for (uint8_t led = 0; led < 10; led++) {
+                HSV      hsv;
+                uint32_t next  = rgblight_timeline_eval(&timeline, led, position, &hsv);
+                uint32_t local = (tick + 10 + phase * led) % 10;
+                EXPECT_EQ(hsv.v, local < 4 ? 255 - 255 * local / 4 : 0) << "led " << (int)led << " position " << position;
+                EXPECT_EQ((position + next) % RGBLIGHT_TIMELINE_SUBTICKS, 0) << "led " << (int)led << " position " << position;
+            }
+        }
+    }
+}
+
+/**
+ * This test verifies that stepping from LED to LED gives the same output as evaluating each LED on its own, and that
+ * LED 0 is rendered again exactly when it changes.
+ */
+TEST_F(RgblightTimeline, EvalNextMatchesEval) {
+    const rgblight_timeline_t timelines[] = {
+        {hue_up, 2, false, 256, 3}, {hue_up, 2, false, 256, -5}, {fade, 3, false, 30, 7}, {fade, 3, false, 15, -4}, {snake, 2, true, 10, 1}, {snake, 2, true, 10, -1}, {constant, 1, false, 8, 3}, {fade, 3, false, 30, 0},
+    };
+    for (const rgblight_timeline_t &timeline : timelines) {
+        const uint32_t cycle = (uint32_t)timeline.duration * RGBLIGHT_TIMELINE_SUBTICKS;
+        for (uint32_t position = 0; position < 2 * cycle; position++) {
+            rgblight_timeline_iter_t iter;
+            rgblight_timeline_begin(&iter, &timeline, position);
+            uint32_t first_next = 0;
+            for (uint8_t led = 0; led < 20; led++) {
+                HSV      hsv, expected;
+                uint32_t next = rgblight_timeline_eval(&timeline, led, position, &expected);
+                if (led == 0) first_next = next;
+                rgblight_timeline_eval_next(&iter, &hsv);
+                ASSERT_TRUE(hsv_equal(hsv, expected)) << "led " << (int)led << " position " << position;
+            }
+            ASSERT_GE(iter.next, 1) << "position " << position;
+            ASSERT_LE(iter.next, first_next) << "position " << position;
+        }
+    }
+}
+
+/**
+ * This test verifies that rendering only when the iterator asks for it keeps every LED within a step of its exact
+ * output.
+ */
+TEST_F(RgblightTimeline, EvalNextKeepsUp) {
+    struct {
+        rgblight_timeline_t timeline;
+        uint32_t            max_lag;
+    } cases[] = {
+        // The hue moves by one about every 16 subticks
+        {{hue_up, 2, false, 256, 3}, 16},
+        {{hue_up, 2, false, 256, -5}, 16},
+        // Every subtick of a fade changes the output, and every tick of a stepped one
+        {{fade, 3, false, 30, 7}, 0},
+        {{snake, 2, true, 10, 1}, 0},
+    };
+    for (const auto &c : cases) {
+        const uint32_t cycle = (uint32_t)c.timeline.duration * RGBLIGHT_TIMELINE_SUBTICKS;
+        HSV            shown[20];
+        uint32_t       stale_since[20];
+        uint32_t       render = 0;
+        for (uint32_t position = 0; position < 3 * cycle; position++) {
+            if (position == render) {
+                rgblight_timeline_iter_t iter;
+                rgblight_timeline_begin(&iter, &c.timeline, position);
+                for (uint8_t led = 0; led < 20; led++) {
+                    rgblight_timeline_eval_next(&iter, &shown[led]);
+                    stale_since[led] = UINT32_MAX;
+                }
+                render += iter.next;
+            }
+            for (uint8_t led = 0; led < 20; led++) {
+                HSV exact;
+                rgblight_timeline_eval(&c.timeline, led, position, &exact);
+                if (hsv_equal(exact, shown[led])) {
+                    stale_since[led] = UINT32_MAX;
+                } else {
+                    if (stale_since[led] == UINT32_MAX) stale_since[led] = position;
+                    ASSERT_LE(position - stale_since[led], c.max_lag) << "led " << (int)led << " position " << position;
+                }
+            }
+        }
+    }
+}
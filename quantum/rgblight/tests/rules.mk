@@ -0,0 +1,4 @@
+rgblight_timeline_INC := $(QUANTUM_PATH)/rgblight/
+rgblight_timeline_SRC := \
+	$(QUANTUM_PATH)/rgblight/rgblight_timeline.c \
+	$(QUANTUM_PATH)/rgblight/tests/rgblight_timeline_tests.cpp
@@ -0,0 +1,7 @@
+split_batch_DEFS := -DSPLIT_KEYBOARD -DSPLIT_TRANSPORT_BATCH -DSPLIT_TRANSPORT_NOTIFY -DSPLIT_MODS_ENABLE -DDISABLE_SYNC_TIMER -DMATRIX_ROWS=4 -DMATRIX_COLS=2
+split_batch_INC := $(QUANTUM_PATH)/split_common/
+split_batch_SRC := \
+	$(QUANTUM_PATH)/split_common/transactions.c \
+	$(QUANTUM_PATH)/crc.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(QUANTUM_PATH)/split_common/tests/split_batch_tests.cpp
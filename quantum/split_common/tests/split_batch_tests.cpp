@@ -0,0 +1,161 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+#define _Static_assert static_assert
+extern "C" {
+#include "transactions.h"
+
+void set_time(uint32_t t);
+}
+
+static split_shared_memory_t master_memory, slave_memory;
+static bool                  fail_batch;
+static int8_t                corrupt_id;
+static uint16_t              transfers[NUM_TOTAL_TRANSACTIONS];
+static uint8_t               real_mods, weak_mods;
+
+extern "C" {
+split_shared_memory_t *const split_shmem = &master_memory;
+
+bool is_transport_connected(void) {
+    return true;
+}
+
+// Hands the transaction to the slave's side, which runs against its own copy of the shared memory
+bool transport_execute_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length) {
+    split_transaction_desc_t *trans = &split_transaction_table[id];
+    transfers[id]++;
+    if (initiator2target_length > 0) {
+        memcpy(split_shmem_offset_ptr(trans->initiator2target_offset), initiator2target_buf, std::min<uint16_t>(initiator2target_length, trans->initiator2target_buffer_size));
+    }
+    if (fail_batch && (id == PUT_BATCH || id == PUT_BATCH_SMALL)) {
+        return false;
+    }
+
+    memcpy((uint8_t *)&slave_memory + trans->initiator2target_offset, split_shmem_offset_ptr(trans->initiator2target_offset), trans->initiator2target_buffer_size);
+    std::swap(master_memory, slave_memory);
+    if (trans->slave_callback) {
+        trans->slave_callback(trans->initiator2target_buffer_size, split_shmem_offset_ptr(trans->initiator2target_offset), trans->target2initiator_buffer_size, split_shmem_offset_ptr(trans->target2initiator_offset));
+    }
+    std::swap(master_memory, slave_memory);
+
+    if (target2initiator_length > 0) {
+        memcpy(target2initiator_buf, (uint8_t *)&slave_memory + trans->target2initiator_offset, std::min<uint16_t>(target2initiator_length, trans->target2initiator_buffer_size));
+        if (id == corrupt_id) {
+            ((uint8_t *)target2initiator_buf)[target2initiator_length - 1] ^= 0xFF;
+        }
+    }
+    return true;
+}
+
+uint8_t get_mods(void) {
+    return real_mods;
+}
+uint8_t get_weak_mods(void) {
+    return weak_mods;
+}
+uint8_t get_oneshot_mods(void) {
+    return 0;
+}
+void set_mods(uint8_t mods) {}
+void set_weak_mods(uint8_t mods) {}
+void set_oneshot_mods(uint8_t mods) {}
+}
+
+class SplitBatch : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(0);
+        memset(&master_memory, 0, sizeof(master_memory));
+        memset(&slave_memory, 0, sizeof(slave_memory));
+        fail_batch = false;
+        corrupt_id = -1;
+        memset(transfers, 0, sizeof(transfers));
+        real_mods  = 0;
+        weak_mods  = 0;
+        transaction_batch_bytes_reset();
+    }
+
+    // Runs one scan on the slave against its own memory, then one on the master
+    bool sync(void) {
+        std::swap(master_memory, slave_memory);
+        transactions_slave(slave_scan, slave_scan);
+        std::swap(master_memory, slave_memory);
+        return transactions_master(master_matrix, slave_matrix);
+    }
+
+    matrix_row_t master_matrix[MATRIX_ROWS / 2] = {};
+    matrix_row_t slave_matrix[MATRIX_ROWS / 2]  = {};
+    matrix_row_t slave_scan[MATRIX_ROWS / 2]    = {};
+};
+
+/**
+ * This test verifies that only the bytes that changed are queued, and that they reach the slave.
+ */
+TEST_F(SplitBatch, SendsChangedBytes) {
+    weak_mods = 0x22;
+    EXPECT_TRUE(sync());
+    EXPECT_EQ(slave_memory.mods.weak_mods, 0x22);
+    EXPECT_EQ(transaction_batch_bytes(PUT_MODS), 3 + 1);
+
+    EXPECT_TRUE(sync());
+    EXPECT_EQ(transaction_batch_bytes(PUT_MODS), 3 + 1) << "Nothing changed, nothing should have been queued";
+}
+
+/**
+ * This test verifies that the changes of a frame that failed are sent again on the next pass, rather than waiting for
+ * a forced sync.
+ */
+TEST_F(SplitBatch, FailedFrameIsResent) {
+    real_mods = 0x02;
+    EXPECT_TRUE(sync());
+    EXPECT_EQ(slave_memory.mods.real_mods, 0x02);
+
+    real_mods  = 0x04;
+    fail_batch = true;
+    EXPECT_FALSE(sync());
+    EXPECT_EQ(slave_memory.mods.real_mods, 0x02);
+
+    fail_batch = false;
+    EXPECT_TRUE(sync());
+    EXPECT_EQ(slave_memory.mods.real_mods, 0x04);
+}
+
+/**
+ * This test verifies that once the slave reports a matrix change, the master fetches the checksum and the matrix in one
+ * transfer, and reads nothing while the matrix stays the same.
+ */
+TEST_F(SplitBatch, ChangedMatrixIsFetchedWithChecksum) {
+    slave_scan[1] = 0x01;
+    EXPECT_TRUE(sync());
+    EXPECT_EQ(transfers[GET_SLAVE_MATRIX_CHECKSUM], 1);
+    EXPECT_EQ(transfers[GET_SLAVE_MATRIX_DATA], 0);
+    EXPECT_EQ(slave_matrix[1], 0x01);
+
+    EXPECT_TRUE(sync());
+    EXPECT_EQ(transfers[GET_SLAVE_MATRIX_CHECKSUM], 1);
+    EXPECT_EQ(transfers[GET_SLAVE_MATRIX_DATA], 0);
+}
+
+/**
+ * This test verifies that a changed matrix arriving with a bad checksum is dropped, and fetched again on the next scan.
+ */
+TEST_F(SplitBatch, CorruptedMatrixIsRefetched) {
+    // Well past the forced sync, so the read happens whatever an earlier test left behind
+    set_time(1000);
+    slave_scan[1] = 0x01;
+    corrupt_id    = GET_SLAVE_MATRIX_CHECKSUM;
+    EXPECT_FALSE(sync());
+    EXPECT_EQ(slave_matrix[1], 0x00);
+
+    corrupt_id                           = -1;
+    transfers[GET_SLAVE_MATRIX_CHECKSUM] = 0;
+    EXPECT_TRUE(sync());
+    EXPECT_EQ(transfers[GET_SLAVE_MATRIX_CHECKSUM], 1);
+    EXPECT_EQ(slave_matrix[1], 0x01);
+}
@@ -21,6 +21,10 @@ enum serial_transaction_id {
     I2C_EXECUTE_CALLBACK,
 #endif // USE_I2C
 
+#ifdef SPLIT_TRANSPORT_NOTIFY
+    GET_SLAVE_STATUS,
+#endif // SPLIT_TRANSPORT_NOTIFY
+
     GET_SLAVE_MATRIX_CHECKSUM,
     GET_SLAVE_MATRIX_DATA,
 
@@ -96,6 +100,11 @@ enum serial_transaction_id {
     PUT_ACTIVITY,
 #endif // SPLIT_ACTIVITY_ENABLE
 
+#if defined(SPLIT_TRANSPORT_BATCH)
+    PUT_BATCH_SMALL,
+    PUT_BATCH,
+#endif // defined(SPLIT_TRANSPORT_BATCH)
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
     PUT_RPC_INFO,
     PUT_RPC_REQ_DATA,
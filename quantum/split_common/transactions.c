@@ -80,6 +80,12 @@
     { 0, 0, sizeof_member(split_shared_memory_t, member), offsetof(split_shared_memory_t, member), cb }
 #define trans_target2initiator_initializer(member) trans_target2initiator_initializer_cb(member, NULL)
 
+#ifdef SPLIT_TRANSPORT_CRC16
+#    define split_checksum(data, length) crc16(data, length)
+#else
+#    define split_checksum(data, length) crc8(data, length)
+#endif // SPLIT_TRANSPORT_CRC16
+
 #define transport_write(id, data, length) transport_execute_transaction(id, data, length, NULL, 0)
 #define transport_read(id, data, length) transport_execute_transaction(id, NULL, 0, data, length)
 
@@ -140,11 +146,11 @@ static bool transaction_handler_master(matrix_row_t master_matrix[], matrix_row_
     } while (0)
 
 inline static bool read_if_checksum_mismatch(int8_t trans_id_checksum, int8_t trans_id_retrieve, uint32_t *last_update, void *destination, const void *equiv_shmem, size_t length) {
-    uint8_t curr_checksum;
-    bool    okay = transport_read(trans_id_checksum, &curr_checksum, sizeof(curr_checksum));
-    if (okay && (timer_elapsed32(*last_update) >= FORCED_SYNC_THROTTLE_MS || curr_checksum != crc8(equiv_shmem, length))) {
+    split_checksum_t curr_checksum;
+    bool             okay = transport_read(trans_id_checksum, &curr_checksum, sizeof(curr_checksum));
+    if (okay && (timer_elapsed32(*last_update) >= FORCED_SYNC_THROTTLE_MS || curr_checksum != split_checksum(equiv_shmem, length))) {
         okay &= transport_read(trans_id_retrieve, destination, length);
-        okay &= curr_checksum == crc8(equiv_shmem, length);
+        okay &= curr_checksum == split_checksum(equiv_shmem, length);
         if (okay) {
             *last_update = timer_read32();
         }
@@ -154,10 +160,161 @@ inline static bool read_if_checksum_mismatch(int8_t trans_id_checksum, int8_t tr
     return okay;
 }
 
+#ifdef SPLIT_TRANSPORT_BATCH
+
+_Static_assert(sizeof(split_batch_frame_t) <= UINT8_MAX, "SPLIT_TRANSPORT_BATCH_SIZE too large for a transaction");
+_Static_assert(SPLIT_TRANSPORT_BATCH_SMALL_SIZE < SPLIT_TRANSPORT_BATCH_SIZE, "SPLIT_TRANSPORT_BATCH_SMALL_SIZE must be smaller than SPLIT_TRANSPORT_BATCH_SIZE");
+
+#    define BATCH_RECORD_HEADER_SIZE 3
+
+static split_batch_frame_t batch_frame;
+static uint16_t            batch_bytes[NUM_TOTAL_TRANSACTIONS];
+
+uint16_t transaction_batch_bytes(int8_t transaction_id) {
+    return (transaction_id >= 0 && transaction_id < NUM_TOTAL_TRANSACTIONS) ? batch_bytes[transaction_id] : 0;
+}
+
+void transaction_batch_bytes_reset(void) {
+    memset(batch_bytes, 0, sizeof(batch_bytes));
+}
+
+static bool batch_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    if (batch_frame.length == 0) {
+        return true;
+    }
+    batch_frame.checksum = split_checksum(batch_frame.records, batch_frame.length);
+
+    // Both sides agree on the size of each transaction, so pick the smallest frame that holds the records
+    uint8_t size = offsetof(split_batch_frame_t, records) + batch_frame.length;
+    return transport_write(size <= SPLIT_TRANSPORT_BATCH_SMALL_SIZE ? PUT_BATCH_SMALL : PUT_BATCH, &batch_frame, size);
+}
+
+// Copies the records of a frame into shared memory, stopping at the first malformed one
+static void batch_apply(const split_batch_frame_t *frame) {
+    for (uint16_t pos = 0; pos + BATCH_RECORD_HEADER_SIZE <= frame->length;) {
+        const uint8_t *record   = &frame->records[pos];
+        int8_t         trans_id = record[0];
+        uint8_t        offset   = record[1];
+        uint8_t        count    = record[2];
+
+        pos += BATCH_RECORD_HEADER_SIZE + count;
+        if (trans_id < 0 || trans_id >= NUM_TOTAL_TRANSACTIONS || pos > frame->length) {
+            return;
+        }
+        split_transaction_desc_t *trans = &split_transaction_table[trans_id];
+        if (offset + count > trans->initiator2target_buffer_size) {
+            return;
+        }
+        memcpy(split_shmem_offset_ptr(trans->initiator2target_offset) + offset, &record[BATCH_RECORD_HEADER_SIZE], count);
+    }
+}
+
+static bool batch_flush(void) {
+    bool okay = transaction_handler_master(NULL, NULL, "batch", &batch_handlers_master);
+    if (okay) {
+        // The master's copy of the slave's shared memory only catches up once the slave has the records, so after a
+        // failed frame every change still differs from it and is queued again on the next pass
+        batch_apply(&batch_frame);
+    }
+    batch_frame.length = 0;
+    return okay;
+}
+
+// Writes whose caller acts on the result straight away have to know the slave got them, so they aren't batched
+static bool batch_allowed(int8_t trans_id) {
+#    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+    if (trans_id == PUT_RGBLIGHT) {
+        return false;
+    }
+#    endif // defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+#    if defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
+    if (trans_id == PUT_POINTING_CPI) {
+        return false;
+    }
+#    endif // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
+    return true;
+}
+
+/**
+ * @brief Queues a write into the batch frame, which is sent at the end of
+ * `transactions_master()` or earlier once full. Only the bytes between the
+ * first and last one that differ from the master's copy of the slave's shared
+ * memory are queued, or all of them when nothing differs (forced sync).
+ */
+static bool transport_put(int8_t trans_id, const void *source, size_t length) {
+    split_transaction_desc_t *trans  = &split_transaction_table[trans_id];
+    uint8_t                  *shadow = split_shmem_offset_ptr(trans->initiator2target_offset);
+    const uint8_t            *data   = (const uint8_t *)source;
+    uint8_t                   size   = trans->initiator2target_buffer_size < length ? trans->initiator2target_buffer_size : length;
+
+    // Callbacks run once per transaction, and oversized writes never fit a frame
+    if (trans->slave_callback || !batch_allowed(trans_id) || BATCH_RECORD_HEADER_SIZE + size > sizeof(batch_frame.records)) {
+        batch_bytes[trans_id] += size;
+        return transport_write(trans_id, source, length);
+    }
+
+    uint8_t first = 0;
+    uint8_t last  = size;
+    while (first < last && shadow[first] == data[first]) {
+        first++;
+    }
+    while (last > first && shadow[last - 1] == data[last - 1]) {
+        last--;
+    }
+    if (first == last) {
+        first = 0;
+        last  = size;
+    }
+
+    uint8_t count = last - first;
+    if (batch_frame.length + BATCH_RECORD_HEADER_SIZE + count > sizeof(batch_frame.records) && !batch_flush()) {
+        return false;
+    }
+
+    uint8_t *record = &batch_frame.records[batch_frame.length];
+    record[0]       = trans_id;
+    record[1]       = first;
+    record[2]       = count;
+    memcpy(&record[BATCH_RECORD_HEADER_SIZE], &data[first], count);
+
+    batch_frame.length += BATCH_RECORD_HEADER_SIZE + count;
+    batch_bytes[trans_id] += BATCH_RECORD_HEADER_SIZE + count;
+    return true;
+}
+
+static void batch_slave_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    const split_batch_frame_t *frame = (const split_batch_frame_t *)initiator2target_buffer;
+    if (frame->length > initiator2target_buffer_size - offsetof(split_batch_frame_t, records) || split_checksum(frame->records, frame->length) != frame->checksum) {
+        return;
+    }
+    batch_apply(frame);
+}
+
+// clang-format off
+#    define TRANSACTIONS_BATCH_MASTER() \
+        do {                            \
+            if (!batch_flush()) {       \
+                return false;           \
+            }                           \
+        } while (0)
+#    define TRANSACTIONS_BATCH_REGISTRATIONS \
+        [PUT_BATCH_SMALL] = {SPLIT_TRANSPORT_BATCH_SMALL_SIZE, offsetof(split_shared_memory_t, batch), 0, 0, batch_slave_callback}, \
+        [PUT_BATCH]       = trans_initiator2target_initializer_cb(batch, batch_slave_callback),
+// clang-format on
+
+#else // SPLIT_TRANSPORT_BATCH
+
+#    define transport_put(id, data, length) transport_write(id, data, length)
+
+#    define TRANSACTIONS_BATCH_MASTER()
+#    define TRANSACTIONS_BATCH_REGISTRATIONS
+
+#endif // SPLIT_TRANSPORT_BATCH
+
 inline static bool send_if_condition(int8_t trans_id, uint32_t *last_update, bool condition, void *source, size_t length) {
     bool okay = true;
     if (timer_elapsed32(*last_update) >= FORCED_SYNC_THROTTLE_MS || condition) {
-        okay &= transport_write(trans_id, source, length);
+        okay &= transport_put(trans_id, source, length);
         if (okay) {
             *last_update = timer_read32();
         }
@@ -170,15 +327,75 @@ inline static bool send_if_data_mismatch(int8_t trans_id, uint32_t *last_update,
     return send_if_condition(trans_id, last_update, (memcmp(source, equiv_shmem, length) != 0), source, length);
 }
 
+////////////////////////////////////////////////////
+// Slave status
+
+#ifdef SPLIT_TRANSPORT_NOTIFY
+
+static split_slave_status_t slave_status;
+
+static bool slave_status_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    return transport_read(GET_SLAVE_STATUS, &slave_status, sizeof(slave_status));
+}
+
+/**
+ * Skips reading while the slave reports no change since the last successful
+ * read. Otherwise the checksum transaction brings the checksum and the data
+ * following it in one transfer, so `trans_id_retrieve` goes unused. The data
+ * is only taken, and `last_seen` only advanced, if the two match.
+ */
+inline static bool read_if_slave_changed(uint8_t change_count, uint8_t *last_seen, int8_t trans_id_checksum, int8_t trans_id_retrieve, uint32_t *last_update, void *destination, const split_checksum_t *equiv_checksum, const void *equiv_shmem, size_t length) {
+    if (change_count == *last_seen && timer_elapsed32(*last_update) < FORCED_SYNC_THROTTLE_MS) {
+        memcpy(destination, equiv_shmem, length);
+        return true;
+    }
+
+    size_t           offset = (const uint8_t *)equiv_shmem - (const uint8_t *)equiv_checksum;
+    uint8_t          buffer[offset + length];
+    split_checksum_t checksum;
+    bool             okay = transport_read(trans_id_checksum, buffer, sizeof(buffer));
+    memcpy(&checksum, buffer, sizeof(checksum));
+    if (okay && checksum == split_checksum(&buffer[offset], length)) {
+        memcpy(destination, &buffer[offset], length);
+        *last_seen   = change_count;
+        *last_update = timer_read32();
+        return true;
+    }
+    return false;
+}
+
+// The checksum transaction carries on over the data, up to the end of `data`
+#    define trans_checksum_initializer(member, data) \
+        { 0, 0, offsetof(split_shared_memory_t, member.data) - offsetof(split_shared_memory_t, member.checksum) + sizeof_member(split_shared_memory_t, member.data), offsetof(split_shared_memory_t, member.checksum), NULL }
+
+#    define split_slave_notify(member) split_shmem->status.member++
+
+#    define TRANSACTIONS_SLAVE_STATUS_MASTER() TRANSACTION_HANDLER_MASTER(slave_status)
+#    define TRANSACTIONS_SLAVE_STATUS_SLAVE()
+#    define TRANSACTIONS_SLAVE_STATUS_REGISTRATIONS [GET_SLAVE_STATUS] = trans_target2initiator_initializer(status),
+
+#else // SPLIT_TRANSPORT_NOTIFY
+
+#    define read_if_slave_changed(change_count, last_seen, trans_id_checksum, trans_id_retrieve, last_update, destination, equiv_checksum, equiv_shmem, length) ((void)(last_seen), read_if_checksum_mismatch(trans_id_checksum, trans_id_retrieve, last_update, destination, equiv_shmem, length))
+#    define trans_checksum_initializer(member, data) trans_target2initiator_initializer(member.checksum)
+#    define split_slave_notify(member)
+
+#    define TRANSACTIONS_SLAVE_STATUS_MASTER()
+#    define TRANSACTIONS_SLAVE_STATUS_SLAVE()
+#    define TRANSACTIONS_SLAVE_STATUS_REGISTRATIONS
+
+#endif // SPLIT_TRANSPORT_NOTIFY
+
 ////////////////////////////////////////////////////
 // Slave matrix
 
 static bool slave_matrix_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     static uint32_t     last_update                    = 0;
+    static uint8_t      last_seen                      = 0;
     static matrix_row_t last_matrix[(MATRIX_ROWS) / 2] = {0}; // last successfully-read matrix, so we can replicate if there are checksum errors
     matrix_row_t        temp_matrix[(MATRIX_ROWS) / 2];       // holding area while we test whether or not checksum is correct
 
-    bool okay = read_if_checksum_mismatch(GET_SLAVE_MATRIX_CHECKSUM, GET_SLAVE_MATRIX_DATA, &last_update, temp_matrix, split_shmem->smatrix.matrix, sizeof(split_shmem->smatrix.matrix));
+    bool okay = read_if_slave_changed(slave_status.matrix, &last_seen, GET_SLAVE_MATRIX_CHECKSUM, GET_SLAVE_MATRIX_DATA, &last_update, temp_matrix, &split_shmem->smatrix.checksum, split_shmem->smatrix.matrix, sizeof(split_shmem->smatrix.matrix));
     if (okay) {
         // Checksum matches the received data, save as the last matrix state
         memcpy(last_matrix, temp_matrix, sizeof(temp_matrix));
@@ -189,15 +406,20 @@ static bool slave_matrix_handlers_master(matrix_row_t master_matrix[], matrix_ro
 }
 
 static void slave_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    bool changed = memcmp(split_shmem->smatrix.matrix, slave_matrix, sizeof(split_shmem->smatrix.matrix)) != 0;
     memcpy(split_shmem->smatrix.matrix, slave_matrix, sizeof(split_shmem->smatrix.matrix));
-    split_shmem->smatrix.checksum = crc8(split_shmem->smatrix.matrix, sizeof(split_shmem->smatrix.matrix));
+    split_shmem->smatrix.checksum = split_checksum(split_shmem->smatrix.matrix, sizeof(split_shmem->smatrix.matrix));
+    // Only announce the change once the data and checksum are ready to be read
+    if (changed) {
+        split_slave_notify(matrix);
+    }
 }
 
 // clang-format off
 #define TRANSACTIONS_SLAVE_MATRIX_MASTER() TRANSACTION_HANDLER_MASTER(slave_matrix)
 #define TRANSACTIONS_SLAVE_MATRIX_SLAVE() TRANSACTION_HANDLER_SLAVE_AUTOLOCK(slave_matrix)
 #define TRANSACTIONS_SLAVE_MATRIX_REGISTRATIONS \
-    [GET_SLAVE_MATRIX_CHECKSUM] = trans_target2initiator_initializer(smatrix.checksum), \
+    [GET_SLAVE_MATRIX_CHECKSUM] = trans_checksum_initializer(smatrix, matrix), \
     [GET_SLAVE_MATRIX_DATA]     = trans_target2initiator_initializer(smatrix.matrix),
 // clang-format on
 
@@ -235,9 +457,10 @@ static void master_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_ro
 
 static bool encoder_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     static uint32_t last_update = 0;
+    static uint8_t  last_seen   = 0;
     uint8_t         temp_state[NUM_ENCODERS_MAX_PER_SIDE];
 
-    bool okay = read_if_checksum_mismatch(GET_ENCODERS_CHECKSUM, GET_ENCODERS_DATA, &last_update, temp_state, split_shmem->encoders.state, sizeof(temp_state));
+    bool okay = read_if_slave_changed(slave_status.encoders, &last_seen, GET_ENCODERS_CHECKSUM, GET_ENCODERS_DATA, &last_update, temp_state, &split_shmem->encoders.checksum, split_shmem->encoders.state, sizeof(temp_state));
     if (okay) encoder_update_raw(temp_state);
     return okay;
 }
@@ -245,17 +468,21 @@ static bool encoder_handlers_master(matrix_row_t master_matrix[], matrix_row_t s
 static void encoder_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     uint8_t encoder_state[NUM_ENCODERS_MAX_PER_SIDE];
     encoder_state_raw(encoder_state);
+    bool changed = memcmp(split_shmem->encoders.state, encoder_state, sizeof(encoder_state)) != 0;
     // Always prepare the encoder state for read.
     memcpy(split_shmem->encoders.state, encoder_state, sizeof(encoder_state));
     // Now update the checksum given that the encoders has been written to
-    split_shmem->encoders.checksum = crc8(encoder_state, sizeof(encoder_state));
+    split_shmem->encoders.checksum = split_checksum(encoder_state, sizeof(encoder_state));
+    if (changed) {
+        split_slave_notify(encoders);
+    }
 }
 
 // clang-format off
 #    define TRANSACTIONS_ENCODERS_MASTER() TRANSACTION_HANDLER_MASTER(encoder)
 #    define TRANSACTIONS_ENCODERS_SLAVE() TRANSACTION_HANDLER_SLAVE_AUTOLOCK(encoder)
 #    define TRANSACTIONS_ENCODERS_REGISTRATIONS \
-    [GET_ENCODERS_CHECKSUM] = trans_target2initiator_initializer(encoders.checksum), \
+    [GET_ENCODERS_CHECKSUM] = trans_checksum_initializer(encoders, state), \
     [GET_ENCODERS_DATA]     = trans_target2initiator_initializer(encoders.state),
 // clang-format on
 
@@ -399,7 +626,7 @@ static bool mods_handlers_master(matrix_row_t master_matrix[], matrix_row_t slav
 
     bool okay = true;
     if (mods_need_sync) {
-        okay &= transport_write(PUT_MODS, &new_mods, sizeof(new_mods));
+        okay &= transport_put(PUT_MODS, &new_mods, sizeof(new_mods));
         if (okay) {
             last_update = timer_read32();
         }
@@ -687,15 +914,16 @@ static bool pointing_handlers_master(matrix_row_t master_matrix[], matrix_row_t
     }
 #    endif
     static uint32_t last_update = 0;
+    static uint8_t  last_seen   = 0;
     static uint16_t last_cpi    = 0;
     report_mouse_t  temp_state;
     uint16_t        temp_cpi;
-    bool            okay = read_if_checksum_mismatch(GET_POINTING_CHECKSUM, GET_POINTING_DATA, &last_update, &temp_state, &split_shmem->pointing.report, sizeof(temp_state));
+    bool            okay = read_if_slave_changed(slave_status.pointing, &last_seen, GET_POINTING_CHECKSUM, GET_POINTING_DATA, &last_update, &temp_state, &split_shmem->pointing.checksum, &split_shmem->pointing.report, sizeof(temp_state));
     if (okay) pointing_device_set_shared_report(temp_state);
     temp_cpi = pointing_device_get_shared_cpi();
     if (temp_cpi && last_cpi != temp_cpi) {
         split_shmem->pointing.cpi = temp_cpi;
-        okay                      = transport_write(PUT_POINTING_CPI, &split_shmem->pointing.cpi, sizeof(split_shmem->pointing.cpi));
+        okay                      = transport_put(PUT_POINTING_CPI, &split_shmem->pointing.cpi, sizeof(split_shmem->pointing.cpi));
         if (okay) {
             last_cpi = temp_cpi;
         }
@@ -734,18 +962,23 @@ static void pointing_handlers_slave(matrix_row_t master_matrix[], matrix_row_t s
         pointing_device_driver.set_cpi(pointing.cpi);
     }
 
-    pointing.report = pointing_device_driver.get_report((report_mouse_t){0});
+    report_mouse_t report = pointing_device_driver.get_report((report_mouse_t){0});
+    bool           changed = memcmp(&pointing.report, &report, sizeof(report_mouse_t)) != 0;
+    pointing.report        = report;
     // Now update the checksum given that the pointing has been written to
-    pointing.checksum = crc8(&pointing.report, sizeof(report_mouse_t));
+    pointing.checksum = split_checksum(&pointing.report, sizeof(report_mouse_t));
 
     split_shared_memory_lock();
     memcpy(&split_shmem->pointing, &pointing, sizeof(split_slave_pointing_sync_t));
+    if (changed) {
+        split_slave_notify(pointing);
+    }
     split_shared_memory_unlock();
 }
 
 #    define TRANSACTIONS_POINTING_MASTER() TRANSACTION_HANDLER_MASTER(pointing)
 #    define TRANSACTIONS_POINTING_SLAVE() TRANSACTION_HANDLER_SLAVE(pointing)
-#    define TRANSACTIONS_POINTING_REGISTRATIONS [GET_POINTING_CHECKSUM] = trans_target2initiator_initializer(pointing.checksum), [GET_POINTING_DATA] = trans_target2initiator_initializer(pointing.report), [PUT_POINTING_CPI] = trans_initiator2target_initializer(pointing.cpi),
+#    define TRANSACTIONS_POINTING_REGISTRATIONS [GET_POINTING_CHECKSUM] = trans_checksum_initializer(pointing, report), [GET_POINTING_DATA] = trans_target2initiator_initializer(pointing.report), [PUT_POINTING_CPI] = trans_initiator2target_initializer(pointing.cpi),
 
 #else // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 
@@ -895,6 +1128,7 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
 #endif // USE_I2C
 
     // clang-format off
+    TRANSACTIONS_SLAVE_STATUS_REGISTRATIONS
     TRANSACTIONS_SLAVE_MATRIX_REGISTRATIONS
     TRANSACTIONS_MASTER_MATRIX_REGISTRATIONS
     TRANSACTIONS_ENCODERS_REGISTRATIONS
@@ -914,6 +1148,7 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
     TRANSACTIONS_HAPTIC_REGISTRATIONS
     TRANSACTIONS_ACTIVITY_REGISTRATIONS
     TRANSACTIONS_DETECTED_OS_REGISTRATIONS
+    TRANSACTIONS_BATCH_REGISTRATIONS
 // clang-format on
 
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
@@ -925,6 +1160,7 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
 };
 
 bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    TRANSACTIONS_SLAVE_STATUS_MASTER();
     TRANSACTIONS_SLAVE_MATRIX_MASTER();
     TRANSACTIONS_MASTER_MATRIX_MASTER();
     TRANSACTIONS_ENCODERS_MASTER();
@@ -944,10 +1180,12 @@ bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix
     TRANSACTIONS_HAPTIC_MASTER();
     TRANSACTIONS_ACTIVITY_MASTER();
     TRANSACTIONS_DETECTED_OS_MASTER();
+    TRANSACTIONS_BATCH_MASTER();
     return true;
 }
 
 void transactions_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    TRANSACTIONS_SLAVE_STATUS_SLAVE();
     TRANSACTIONS_SLAVE_MATRIX_SLAVE();
     TRANSACTIONS_MASTER_MATRIX_SLAVE();
     TRANSACTIONS_ENCODERS_SLAVE();
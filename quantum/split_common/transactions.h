@@ -38,13 +38,20 @@ typedef struct _split_transaction_desc_t {
 extern split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS];
 
 #define split_shmem_offset_ptr(offset) (((uint8_t *)split_shmem) + (offset))
-#define split_trans_initiator2target_buffer(trans) (split_shmem_offset_ptr((trans)->initiator2target_offset))
-#define split_trans_target2initiator_buffer(trans) (split_shmem_offset_ptr((trans)->target2initiator_offset))
+#define split_wire_offset_ptr(offset) (((uint8_t *)split_wire) + (offset))
+#define split_trans_initiator2target_buffer(trans) (split_wire_offset_ptr((trans)->initiator2target_offset))
+#define split_trans_target2initiator_buffer(trans) (split_wire_offset_ptr((trans)->target2initiator_offset))
 
 // returns false if valid data not received from slave
 bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
 void transactions_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
 
+#ifdef SPLIT_TRANSPORT_BATCH
+// Bytes sent for `transaction_id` through the batch frame, including record headers. Wraps at 65535.
+uint16_t transaction_batch_bytes(int8_t transaction_id);
+void     transaction_batch_bytes_reset(void);
+#endif // SPLIT_TRANSPORT_BATCH
+
 void transaction_register_rpc(int8_t transaction_id, slave_callback_t callback);
 
 bool transaction_rpc_exec(int8_t transaction_id, uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
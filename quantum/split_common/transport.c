@@ -22,6 +22,10 @@
 #include "transaction_id_define.h"
 #include "atomic_util.h"
 
+#if defined(SPLIT_TRANSPORT_THREAD) && (defined(USE_I2C) || !defined(PROTOCOL_CHIBIOS))
+#    error "SPLIT_TRANSPORT_THREAD is only supported by serial split keyboards on ChibiOS"
+#endif
+
 #ifdef USE_I2C
 
 #    ifndef SLAVE_I2C_TIMEOUT
@@ -93,13 +97,23 @@ bool transport_execute_transaction(int8_t id, const void *initiator2target_buf,
 static split_shared_memory_t shared_memory;
 split_shared_memory_t *const split_shmem = &shared_memory;
 
+#    ifdef SPLIT_TRANSPORT_THREAD
+split_shared_memory_t *split_wire = &shared_memory;
+
+static void transport_thread_init(void);
+#    endif // SPLIT_TRANSPORT_THREAD
+
 void transport_master_init(void) {
     soft_serial_initiator_init();
+#    ifdef SPLIT_TRANSPORT_THREAD
+    transport_thread_init();
+#    endif // SPLIT_TRANSPORT_THREAD
 }
 void transport_slave_init(void) {
     soft_serial_target_init();
 }
 
+#    ifndef SPLIT_TRANSPORT_THREAD
 bool transport_execute_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length) {
     split_transaction_desc_t *trans = &split_transaction_table[id];
     if (initiator2target_length > 0) {
@@ -118,13 +132,202 @@ bool transport_execute_transaction(int8_t id, const void *initiator2target_buf,
 
     return true;
 }
+#    endif // SPLIT_TRANSPORT_THREAD
 
 #endif // USE_I2C
 
+#ifdef SPLIT_TRANSPORT_THREAD
+
+#    include <ch.h>
+
+#    ifndef SPLIT_TRANSPORT_THREAD_PRIORITY
+#        define SPLIT_TRANSPORT_THREAD_PRIORITY (NORMALPRIO + 1)
+#    endif
+
+#    define transaction_bit(id) (1UL << (id))
+
+/*
+ * The master's main thread runs `transactions_master()` against split_shmem:
+ * writes are queued there, and reads return what the transport thread fetched
+ * on its last exchange. The thread then sends the queued writes and refreshes
+ * the reads through a private copy while the main thread scans the matrix.
+ */
+static split_shared_memory_t wire_memory;
+
+static MUTEX_DECL(snapshot_mutex); // guards split_shmem and the masks below
+static MUTEX_DECL(link_mutex);     // held while driving the link, keeps the writes in order
+static BSEMAPHORE_DECL(exchange_pending, true);
+
+static uint32_t pending_writes;  // queued in split_shmem, not yet sent
+static uint32_t refreshed_reads; // read by transactions_master, fetched on every exchange
+static uint32_t valid_reads;     // fetched successfully by the last exchange
+static bool     exchange_failed; // a write failed on the last exchange, retried on the next one
+static bool     deferred;        // transactions_master is running on the main thread
+
+static bool callback_pending(void) {
+    for (int8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; id++) {
+        if ((pending_writes & transaction_bit(id)) && split_transaction_table[id].slave_callback) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Called with link_mutex held
+static bool send_pending_writes(void) {
+    chMtxLock(&snapshot_mutex);
+    uint32_t writes = pending_writes;
+    pending_writes  = 0;
+    for (int8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; id++) {
+        if (writes & transaction_bit(id)) {
+            split_transaction_desc_t *trans = &split_transaction_table[id];
+            memcpy(split_wire_offset_ptr(trans->initiator2target_offset), split_shmem_offset_ptr(trans->initiator2target_offset), trans->initiator2target_buffer_size);
+        }
+    }
+    chMtxUnlock(&snapshot_mutex);
+
+    uint32_t failed = 0;
+    for (int8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; id++) {
+        if ((writes & transaction_bit(id)) && !soft_serial_transaction(id)) {
+            failed |= transaction_bit(id);
+        }
+    }
+
+    if (failed) {
+        // split_shmem still holds the data, or newer
+        chMtxLock(&snapshot_mutex);
+        pending_writes |= failed;
+        chMtxUnlock(&snapshot_mutex);
+    }
+    return failed == 0;
+}
+
+// Called with link_mutex held, publishes all reads at once so checksums and data stay consistent
+static uint32_t fetch_reads(uint32_t reads) {
+    uint32_t fetched = 0;
+    for (int8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; id++) {
+        if ((reads & transaction_bit(id)) && soft_serial_transaction(id)) {
+            fetched |= transaction_bit(id);
+        }
+    }
+
+    chMtxLock(&snapshot_mutex);
+    for (int8_t id = 0; id < NUM_TOTAL_TRANSACTIONS; id++) {
+        if (fetched & transaction_bit(id)) {
+            split_transaction_desc_t *trans = &split_transaction_table[id];
+            memcpy(split_shmem_offset_ptr(trans->target2initiator_offset), split_wire_offset_ptr(trans->target2initiator_offset), trans->target2initiator_buffer_size);
+        }
+    }
+    valid_reads = (valid_reads & ~reads) | fetched;
+    chMtxUnlock(&snapshot_mutex);
+    return fetched;
+}
+
+// Called without snapshot_mutex held
+static bool exchange_now(uint32_t reads) {
+    chMtxLock(&link_mutex);
+    bool okay = send_pending_writes();
+    if (okay && reads) {
+        okay = fetch_reads(reads) == reads;
+    }
+    chMtxUnlock(&link_mutex);
+    return okay;
+}
+
+static THD_WORKING_AREA(waTransportThread, 1024);
+static THD_FUNCTION(TransportThread, arg) {
+    (void)arg;
+    chRegSetThreadName("split_transport");
+
+    while (true) {
+        chBSemWait(&exchange_pending);
+
+        chMtxLock(&link_mutex);
+        exchange_failed = !send_pending_writes();
+        chMtxLock(&snapshot_mutex);
+        uint32_t reads = refreshed_reads;
+        chMtxUnlock(&snapshot_mutex);
+        fetch_reads(reads);
+        chMtxUnlock(&link_mutex);
+    }
+}
+
+static void transport_thread_init(void) {
+    split_wire = &wire_memory;
+    chThdCreateStatic(waTransportThread, sizeof(waTransportThread), SPLIT_TRANSPORT_THREAD_PRIORITY, TransportThread, NULL);
+}
+
+bool transport_execute_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length) {
+    split_transaction_desc_t *trans = &split_transaction_table[id];
+    uint32_t                  bit   = transaction_bit(id);
+    bool                      okay  = true;
+
+    if (!deferred) {
+        chMtxLock(&snapshot_mutex);
+    } else if (initiator2target_length > 0 && trans->slave_callback && callback_pending()) {
+        // The slave runs a callback once per transfer, send the queued one before it is overwritten
+        chMtxUnlock(&snapshot_mutex);
+        okay = exchange_now(0);
+        chMtxLock(&snapshot_mutex);
+        if (!okay) {
+            return false;
+        }
+    }
+
+    if (initiator2target_length > 0) {
+        size_t len = trans->initiator2target_buffer_size < initiator2target_length ? trans->initiator2target_buffer_size : initiator2target_length;
+        memcpy(split_shmem_offset_ptr(trans->initiator2target_offset), initiator2target_buf, len);
+        pending_writes |= bit;
+    }
+
+    // Custom RPCs need their result right away, as does the first read of each transaction
+    bool now = !deferred || (target2initiator_length > 0 && !(refreshed_reads & bit));
+    if (deferred && target2initiator_length > 0) {
+        refreshed_reads |= bit;
+    }
+    if (now) {
+        chMtxUnlock(&snapshot_mutex);
+        okay = exchange_now(target2initiator_length > 0 ? bit : 0);
+        chMtxLock(&snapshot_mutex);
+        if (!okay && !deferred) {
+            // Let the caller retry, rather than the thread at some later point
+            pending_writes &= ~bit;
+        }
+    } else if (target2initiator_length > 0) {
+        okay = valid_reads & bit;
+    }
+
+    if (okay && target2initiator_length > 0) {
+        size_t len = trans->target2initiator_buffer_size < target2initiator_length ? trans->target2initiator_buffer_size : target2initiator_length;
+        memcpy(target2initiator_buf, split_shmem_offset_ptr(trans->target2initiator_offset), len);
+    }
+
+    if (!deferred) {
+        chMtxUnlock(&snapshot_mutex);
+    }
+    return okay;
+}
+
+bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    chMtxLock(&snapshot_mutex);
+    deferred  = true;
+    bool okay = transactions_master(master_matrix, slave_matrix) && !exchange_failed;
+    deferred  = false;
+    chMtxUnlock(&snapshot_mutex);
+
+    // Exchange the queued writes and refresh the reads while the next scan runs
+    chBSemSignal(&exchange_pending);
+    return okay;
+}
+
+#else // SPLIT_TRANSPORT_THREAD
+
 bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     return transactions_master(master_matrix, slave_matrix);
 }
 
+#endif // SPLIT_TRANSPORT_THREAD
+
 void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     transactions_slave(master_matrix, slave_matrix);
 }
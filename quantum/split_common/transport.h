@@ -31,6 +31,15 @@
 #    define RPC_S2M_BUFFER_SIZE 32
 #endif // RPC_S2M_BUFFER_SIZE
 
+#ifdef SPLIT_TRANSPORT_BATCH
+#    ifndef SPLIT_TRANSPORT_BATCH_SIZE
+#        define SPLIT_TRANSPORT_BATCH_SIZE 64
+#    endif // SPLIT_TRANSPORT_BATCH_SIZE
+#    ifndef SPLIT_TRANSPORT_BATCH_SMALL_SIZE
+#        define SPLIT_TRANSPORT_BATCH_SMALL_SIZE 16
+#    endif // SPLIT_TRANSPORT_BATCH_SMALL_SIZE
+#endif // SPLIT_TRANSPORT_BATCH
+
 void transport_master_init(void);
 void transport_slave_init(void);
 
@@ -52,9 +61,25 @@ bool transport_execute_transaction(int8_t id, const void *initiator2target_buf,
 #    include "rgblight.h"
 #endif // RGBLIGHT_ENABLE
 
+// Width of the checksums guarding the larger blocks read from the slave and the batch frame
+#ifdef SPLIT_TRANSPORT_CRC16
+typedef uint16_t split_checksum_t;
+#else
+typedef uint8_t split_checksum_t;
+#endif // SPLIT_TRANSPORT_CRC16
+
+#ifdef SPLIT_TRANSPORT_NOTIFY
+// Incremented by the slave whenever the corresponding data changes
+typedef struct _split_slave_status_t {
+    uint8_t matrix;
+    uint8_t encoders;
+    uint8_t pointing;
+} split_slave_status_t;
+#endif // SPLIT_TRANSPORT_NOTIFY
+
 typedef struct _split_slave_matrix_sync_t {
-    uint8_t      checksum;
-    matrix_row_t matrix[(MATRIX_ROWS) / 2];
+    split_checksum_t checksum;
+    matrix_row_t     matrix[(MATRIX_ROWS) / 2];
 } split_slave_matrix_sync_t;
 
 #ifdef SPLIT_TRANSPORT_MIRROR
@@ -65,8 +90,8 @@ typedef struct _split_master_matrix_sync_t {
 
 #ifdef ENCODER_ENABLE
 typedef struct _split_slave_encoder_sync_t {
-    uint8_t checksum;
-    uint8_t state[NUM_ENCODERS_MAX_PER_SIDE];
+    split_checksum_t checksum;
+    uint8_t          state[NUM_ENCODERS_MAX_PER_SIDE];
 } split_slave_encoder_sync_t;
 #endif // ENCODER_ENABLE
 
@@ -108,9 +133,9 @@ typedef struct _split_mods_sync_t {
 #if defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 #    include "pointing_device.h"
 typedef struct _split_slave_pointing_sync_t {
-    uint8_t        checksum;
-    report_mouse_t report;
-    uint16_t       cpi;
+    split_checksum_t checksum;
+    report_mouse_t   report;
+    uint16_t         cpi;
 } split_slave_pointing_sync_t;
 #endif // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 
@@ -146,11 +171,24 @@ typedef struct _rpc_sync_info_t {
 #    include "os_detection.h"
 #endif // defined(OS_DETECTION_ENABLE) && defined(SPLIT_DETECTED_OS_ENABLE)
 
+#ifdef SPLIT_TRANSPORT_BATCH
+// Records of [transaction id][offset][count][count bytes], applied in order to the slave's shared memory
+typedef struct _split_batch_frame_t {
+    split_checksum_t checksum;
+    uint8_t          length;
+    uint8_t          records[SPLIT_TRANSPORT_BATCH_SIZE - sizeof(split_checksum_t) - 1];
+} split_batch_frame_t;
+#endif // SPLIT_TRANSPORT_BATCH
+
 typedef struct _split_shared_memory_t {
 #ifdef USE_I2C
     int8_t transaction_id;
 #endif // USE_I2C
 
+#ifdef SPLIT_TRANSPORT_NOTIFY
+    split_slave_status_t status;
+#endif // SPLIT_TRANSPORT_NOTIFY
+
     split_slave_matrix_sync_t smatrix;
 
 #ifdef SPLIT_TRANSPORT_MIRROR
@@ -227,9 +265,21 @@ typedef struct _split_shared_memory_t {
     uint8_t         rpc_s2m_buffer[RPC_S2M_BUFFER_SIZE];
 #endif // defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 
+#ifdef SPLIT_TRANSPORT_BATCH
+    split_batch_frame_t batch;
+#endif // SPLIT_TRANSPORT_BATCH
+
 #if defined(OS_DETECTION_ENABLE) && defined(SPLIT_DETECTED_OS_ENABLE)
     os_variant_t detected_os;
 #endif // defined(OS_DETECTION_ENABLE) && defined(SPLIT_DETECTED_OS_ENABLE)
 } split_shared_memory_t;
 
 extern split_shared_memory_t *const split_shmem;
+
+#ifdef SPLIT_TRANSPORT_THREAD
+// What the transport drivers send and receive. On the master this is owned by
+// the transport thread, and split_shmem is the main thread's snapshot of it.
+extern split_shared_memory_t *split_wire;
+#else
+#    define split_wire split_shmem
+#endif // SPLIT_TRANSPORT_THREAD
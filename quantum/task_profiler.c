@@ -0,0 +1,146 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "task_profiler.h"
+#include "timer.h"
+#include "debug.h"
+#include "util.h"
+
+#if defined(RAW_ENABLE) && defined(TASK_PROFILER_RAW_HID)
+#    include "raw_hid.h"
+#endif
+
+static task_profiler_stats_t task_profiler_stats[TASK_PROFILER_STAGE_COUNT];
+static uint32_t              last_report = 0;
+
+#if defined(CONSOLE_ENABLE)
+static const char *const stage_names[TASK_PROFILER_STAGE_COUNT] = {
+    [TASK_PROFILER_KEYBOARD_TASK]        = "keyboard_task",
+    [TASK_PROFILER_MATRIX_TASK]          = "matrix_task",
+    [TASK_PROFILER_QUANTUM_TASK]         = "quantum_task",
+    [TASK_PROFILER_SPLIT_WATCHDOG_TASK]  = "split_watchdog_task",
+    [TASK_PROFILER_RGBLIGHT_TASK]        = "rgblight_task",
+    [TASK_PROFILER_LED_MATRIX_TASK]      = "led_matrix_task",
+    [TASK_PROFILER_RGB_MATRIX_TASK]      = "rgb_matrix_task",
+    [TASK_PROFILER_BACKLIGHT_TASK]       = "backlight_task",
+    [TASK_PROFILER_ENCODER_READ]         = "encoder_read",
+    [TASK_PROFILER_POINTING_DEVICE_TASK] = "pointing_device_task",
+    [TASK_PROFILER_OLED_TASK]            = "oled_task",
+    [TASK_PROFILER_ST7565_TASK]          = "st7565_task",
+    [TASK_PROFILER_MOUSEKEY_TASK]        = "mousekey_task",
+    [TASK_PROFILER_PS2_MOUSE_TASK]       = "ps2_mouse_task",
+    [TASK_PROFILER_MIDI_TASK]            = "midi_task",
+    [TASK_PROFILER_JOYSTICK_TASK]        = "joystick_task",
+    [TASK_PROFILER_BLUETOOTH_TASK]       = "bluetooth_task",
+    [TASK_PROFILER_HAPTIC_TASK]          = "haptic_task",
+    [TASK_PROFILER_LED_TASK]             = "led_task",
+};
+#endif
+
+__attribute__((weak)) uint32_t task_profiler_timestamp(void) {
+    return timer_read_raw32();
+}
+
+void task_profiler_record(task_profiler_stage_t stage, uint32_t ticks) {
+    task_profiler_stats_t *stats = &task_profiler_stats[stage];
+
+    if (stats->count == 0 || ticks < stats->min) {
+        stats->min = ticks;
+    }
+    if (ticks > stats->max) {
+        stats->max = ticks;
+    }
+    stats->count++;
+    stats->total = (stats->total > UINT32_MAX - ticks) ? UINT32_MAX : stats->total + ticks;
+
+    uint8_t  bucket = 0;
+    uint32_t scaled = ticks >> TASK_PROFILER_HISTOGRAM_SHIFT;
+    while (scaled && bucket < TASK_PROFILER_HISTOGRAM_BUCKETS - 1) {
+        scaled >>= 1;
+        bucket++;
+    }
+    if (stats->histogram[bucket] < UINT16_MAX) {
+        stats->histogram[bucket]++;
+    }
+}
+
+const task_profiler_stats_t *task_profiler_get_stats(task_profiler_stage_t stage) {
+    return &task_profiler_stats[stage];
+}
+
+uint32_t task_profiler_get_average(task_profiler_stage_t stage) {
+    const task_profiler_stats_t *stats = &task_profiler_stats[stage];
+    return stats->count ? stats->total / stats->count : 0;
+}
+
+void task_profiler_reset(void) {
+    memset(task_profiler_stats, 0, sizeof(task_profiler_stats));
+}
+
+#if defined(CONSOLE_ENABLE)
+static void task_profiler_export_console(task_profiler_stage_t stage) {
+    const task_profiler_stats_t *stats = &task_profiler_stats[stage];
+
+    dprintf("prof %s: n=%lu min=%lu avg=%lu max=%lu hist=", stage_names[stage], (unsigned long)stats->count, (unsigned long)stats->min, (unsigned long)task_profiler_get_average(stage), (unsigned long)stats->max);
+    for (uint8_t i = 0; i < TASK_PROFILER_HISTOGRAM_BUCKETS; i++) {
+        dprintf(i ? ",%u" : "%u", stats->histogram[i]);
+    }
+    dprint("\n");
+}
+#endif
+
+#if defined(RAW_ENABLE) && defined(TASK_PROFILER_RAW_HID)
+/*
+ * Report layout, little endian:
+ *   [0]      TASK_PROFILER_RAW_HID_REPORT_ID
+ *   [1]      stage
+ *   [2..3]   sample count, saturated to 16 bits
+ *   [4..7]   min
+ *   [8..11]  avg
+ *   [12..15] max
+ *   [16..]   histogram buckets, 16 bits each, as many as fit
+ */
+static void task_profiler_export_raw_hid(task_profiler_stage_t stage) {
+    const task_profiler_stats_t *stats = &task_profiler_stats[stage];
+    uint8_t                      data[32]         = {0};
+    uint16_t                     count            = MIN(stats->count, UINT16_MAX);
+    uint32_t                     fields[3]        = {stats->min, task_profiler_get_average(stage), stats->max};
+
+    data[0] = TASK_PROFILER_RAW_HID_REPORT_ID;
+    data[1] = stage;
+    data[2] = count & 0xFF;
+    data[3] = count >> 8;
+    for (uint8_t i = 0; i < 3; i++) {
+        for (uint8_t b = 0; b < 4; b++) {
+            data[4 + i * 4 + b] = (fields[i] >> (b * 8)) & 0xFF;
+        }
+    }
+    for (uint8_t i = 0; i < TASK_PROFILER_HISTOGRAM_BUCKETS && 16U + i * 2U + 1U < sizeof(data); i++) {
+        data[16 + i * 2]     = stats->histogram[i] & 0xFF;
+        data[16 + i * 2 + 1] = stats->histogram[i] >> 8;
+    }
+    raw_hid_send(data, sizeof(data));
+}
+#endif
+
+void task_profiler_task(void) {
+    if (timer_elapsed32(last_report) < TASK_PROFILER_REPORT_INTERVAL) {
+        return;
+    }
+    last_report = timer_read32();
+
+    for (uint8_t stage = 0; stage < TASK_PROFILER_STAGE_COUNT; stage++) {
+        if (task_profiler_stats[stage].count == 0) {
+            continue;
+        }
+#if defined(CONSOLE_ENABLE)
+        task_profiler_export_console(stage);
+#endif
+#if defined(RAW_ENABLE) && defined(TASK_PROFILER_RAW_HID)
+        task_profiler_export_raw_hid(stage);
+#endif
+    }
+
+    task_profiler_reset();
+}
@@ -0,0 +1,125 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * \file
+ *
+ * \defgroup task_profiler Task Profiler
+ *
+ * Times every stage of `keyboard_task()` and keeps min/avg/max and a log2
+ * histogram per stage. The statistics are periodically exported over console
+ * and/or raw HID and then reset.
+ *
+ * Durations are measured in platform timestamp ticks:
+ *   - ChibiOS: the realtime counter (CPU cycles on Cortex-M3 and up)
+ *   - AVR: timer0 ticks (`F_CPU / TIMER_PRESCALER`)
+ *   - otherwise: microseconds, in steps of a millisecond
+ *
+ * Override `task_profiler_timestamp()` to use a different time source.
+ * \{
+ */
+
+#ifndef TASK_PROFILER_REPORT_INTERVAL
+#    define TASK_PROFILER_REPORT_INTERVAL 1000
+#endif
+
+#ifndef TASK_PROFILER_HISTOGRAM_BUCKETS
+#    define TASK_PROFILER_HISTOGRAM_BUCKETS 8
+#endif
+
+// Width of the first histogram bucket, as a power of two of ticks
+#ifndef TASK_PROFILER_HISTOGRAM_SHIFT
+#    define TASK_PROFILER_HISTOGRAM_SHIFT 6
+#endif
+
+#ifndef TASK_PROFILER_RAW_HID_REPORT_ID
+#    define TASK_PROFILER_RAW_HID_REPORT_ID 0xFD
+#endif
+
+typedef enum {
+    TASK_PROFILER_KEYBOARD_TASK,
+    TASK_PROFILER_MATRIX_TASK,
+    TASK_PROFILER_QUANTUM_TASK,
+    TASK_PROFILER_SPLIT_WATCHDOG_TASK,
+    TASK_PROFILER_RGBLIGHT_TASK,
+    TASK_PROFILER_LED_MATRIX_TASK,
+    TASK_PROFILER_RGB_MATRIX_TASK,
+    TASK_PROFILER_BACKLIGHT_TASK,
+    TASK_PROFILER_ENCODER_READ,
+    TASK_PROFILER_POINTING_DEVICE_TASK,
+    TASK_PROFILER_OLED_TASK,
+    TASK_PROFILER_ST7565_TASK,
+    TASK_PROFILER_MOUSEKEY_TASK,
+    TASK_PROFILER_PS2_MOUSE_TASK,
+    TASK_PROFILER_MIDI_TASK,
+    TASK_PROFILER_JOYSTICK_TASK,
+    TASK_PROFILER_BLUETOOTH_TASK,
+    TASK_PROFILER_HAPTIC_TASK,
+    TASK_PROFILER_LED_TASK,
+    TASK_PROFILER_STAGE_COUNT,
+} task_profiler_stage_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint32_t total;
+    uint16_t histogram[TASK_PROFILER_HISTOGRAM_BUCKETS];
+} task_profiler_stats_t;
+
+#ifdef TASK_PROFILER_ENABLE
+
+/**
+ * \brief Runs the statement(s) and records the time taken against `stage`.
+ */
+#    define TASK_PROFILE(stage, ...)                                                        \
+        do {                                                                                \
+            const uint32_t task_profiler_start = task_profiler_timestamp();                 \
+            __VA_ARGS__;                                                                    \
+            task_profiler_record((stage), task_profiler_timestamp() - task_profiler_start); \
+        } while (0)
+
+/**
+ * \brief Current timestamp in platform ticks. Weakly defined.
+ */
+uint32_t task_profiler_timestamp(void);
+
+/**
+ * \brief Adds a sample of `ticks` duration to the statistics of `stage`.
+ */
+void task_profiler_record(task_profiler_stage_t stage, uint32_t ticks);
+
+/**
+ * \brief Statistics collected for `stage` since the last export.
+ */
+const task_profiler_stats_t *task_profiler_get_stats(task_profiler_stage_t stage);
+
+/**
+ * \brief Average duration of `stage` in ticks, or zero if it never ran.
+ */
+uint32_t task_profiler_get_average(task_profiler_stage_t stage);
+
+/**
+ * \brief Clears the statistics of every stage.
+ */
+void task_profiler_reset(void);
+
+/**
+ * \brief Exports and resets the statistics every `TASK_PROFILER_REPORT_INTERVAL` milliseconds.
+ */
+void task_profiler_task(void);
+
+#else
+
+#    define TASK_PROFILE(stage, ...) \
+        do {                         \
+            __VA_ARGS__;             \
+        } while (0)
+
+#endif // TASK_PROFILER_ENABLE
+
+/** \} */
@@ -14,21 +14,24 @@ void MockBackingStore::reset_instance() {
 
     locked = true;
 
-    backing_erasure_count     = 0;
-    backing_max_write_count   = 0;
-    backing_total_write_count = 0;
-
-    backing_init_invoke_count   = 0;
-    backing_unlock_invoke_count = 0;
-    backing_erase_invoke_count  = 0;
-    backing_write_invoke_count  = 0;
-    backing_lock_invoke_count   = 0;
-
-    init_success_callback   = [](std::uint64_t) { return true; };
-    erase_success_callback  = [](std::uint64_t) { return true; };
-    unlock_success_callback = [](std::uint64_t) { return true; };
-    write_success_callback  = [](std::uint64_t, std::uint32_t) { return true; };
-    lock_success_callback   = [](std::uint64_t) { return true; };
+    backing_erasure_count         = 0;
+    backing_partial_erasure_count = 0;
+    backing_max_write_count       = 0;
+    backing_total_write_count     = 0;
+
+    backing_init_invoke_count          = 0;
+    backing_unlock_invoke_count        = 0;
+    backing_erase_invoke_count         = 0;
+    backing_erase_partial_invoke_count = 0;
+    backing_write_invoke_count         = 0;
+    backing_lock_invoke_count          = 0;
+
+    init_success_callback          = [](std::uint64_t) { return true; };
+    erase_success_callback         = [](std::uint64_t) { return true; };
+    erase_partial_success_callback = [](std::uint64_t, std::uint32_t) { return true; };
+    unlock_success_callback        = [](std::uint64_t) { return true; };
+    write_success_callback         = [](std::uint64_t, std::uint32_t) { return true; };
+    lock_success_callback          = [](std::uint64_t) { return true; };
 
     write_log.clear();
 }
@@ -75,6 +78,30 @@ bool MockBackingStore::erase(void) {
     return true;
 }
 
+bool MockBackingStore::erase_partial(uint32_t address, uint32_t end, uint32_t& next) {
+    ++backing_erase_partial_invoke_count;
+
+    EXPECT_FALSE(is_locked()) << "Erase was attempted without being unlocked first";
+
+    // Refuse anything that isn't exactly one sector, as a flash peripheral would
+    if (address % MOCK_ERASE_SECTOR_SIZE::value != 0 || address + MOCK_ERASE_SECTOR_SIZE::value > end || end > WEAR_LEVELING_BACKING_SIZE) {
+        return false;
+    }
+
+    // Drop out of erase early with failure if we need to
+    if (erase_partial_success_callback && !erase_partial_success_callback(backing_erase_partial_invoke_count, address)) {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < MOCK_ERASE_SECTOR_SIZE::value / BACKING_STORE_WRITE_SIZE; ++i) {
+        backing_storage[address / BACKING_STORE_WRITE_SIZE + i].erase();
+    }
+
+    ++backing_partial_erasure_count;
+    next = address + MOCK_ERASE_SECTOR_SIZE::value;
+    return true;
+}
+
 bool MockBackingStore::write(uint32_t address, backing_store_int_t value) {
     ++backing_write_invoke_count;
 
@@ -152,3 +179,7 @@ extern "C" bool backing_store_lock(void) {
 extern "C" bool backing_store_read(uint32_t address, backing_store_int_t* value) {
     return MockBackingStore::Instance().read(address, *value);
 }
+
+extern "C" bool backing_store_erase_partial(uint32_t address, uint32_t end, uint32_t* next) {
+    return MockBackingStore::Instance().erase_partial(address, end, *next);
+}
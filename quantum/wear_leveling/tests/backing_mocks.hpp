@@ -19,6 +19,8 @@ extern "C" {
 using MOCK_WRITE_LOG_MAX_ENTRIES = std::integral_constant<std::size_t, 1024>;
 // Complement to the backing store integral, for emulating flash erases of all bytes=0xFF
 using BACKING_STORE_INTEGRAL_COMPLEMENT = std::integral_constant<backing_store_int_t, ((backing_store_int_t)(~(backing_store_int_t)0))>;
+// Size of the sectors erased by backing_store_erase_partial()
+using MOCK_ERASE_SECTOR_SIZE = std::integral_constant<std::size_t, 32>;
 // Total number of elements stored in the backing arrays
 using BACKING_STORE_ELEMENT_COUNT = std::integral_constant<std::size_t, (WEAR_LEVELING_BACKING_SIZE / sizeof(backing_store_int_t))>;
 
@@ -83,6 +85,8 @@ class MockBackingStore {
     storage_t backing_storage;
     // The number of erase cycles that have occurred
     std::uint64_t backing_erasure_count;
+    // The number of single sector erases that have occurred
+    std::uint64_t backing_partial_erasure_count;
     // The max number of writes to an element of the backing store
     std::uint64_t backing_max_write_count;
     // The total number of writes to all elements of the backing store
@@ -94,6 +98,7 @@ class MockBackingStore {
     std::uint64_t backing_init_invoke_count;
     std::uint64_t backing_unlock_invoke_count;
     std::uint64_t backing_erase_invoke_count;
+    std::uint64_t backing_erase_partial_invoke_count;
     std::uint64_t backing_write_invoke_count;
     std::uint64_t backing_lock_invoke_count;
 
@@ -101,6 +106,8 @@ class MockBackingStore {
     std::function<bool(std::uint64_t)> init_success_callback;
     // Whether erase should succeed
     std::function<bool(std::uint64_t)> erase_success_callback;
+    // Whether single sector erases should succeed
+    std::function<bool(std::uint64_t, std::uint32_t)> erase_partial_success_callback;
     // Whether unlocks should succeed
     std::function<bool(std::uint64_t)> unlock_success_callback;
     // Whether writes should succeed
@@ -124,6 +131,9 @@ class MockBackingStore {
     std::uint64_t erasure_count() const {
         return backing_erasure_count;
     }
+    std::uint64_t partial_erasure_count() const {
+        return backing_partial_erasure_count;
+    }
     std::uint64_t max_write_count() const {
         return backing_max_write_count;
     }
@@ -141,6 +151,9 @@ class MockBackingStore {
     std::uint64_t erase_invoke_count() const {
         return backing_erase_invoke_count;
     }
+    std::uint64_t erase_partial_invoke_count() const {
+        return backing_erase_partial_invoke_count;
+    }
     std::uint64_t write_invoke_count() const {
         return backing_write_invoke_count;
     }
@@ -159,6 +172,7 @@ class MockBackingStore {
     bool init();
     bool unlock();
     bool erase();
+    bool erase_partial(std::uint32_t address, std::uint32_t end, std::uint32_t& next);
     bool write(std::uint32_t address, backing_store_int_t value);
     bool lock();
     bool read(std::uint32_t address, backing_store_int_t& value) const;
@@ -170,6 +184,9 @@ class MockBackingStore {
     void set_erase_callback(std::function<bool(std::uint64_t)> callback) {
         erase_success_callback = callback;
     }
+    void set_erase_partial_callback(std::function<bool(std::uint64_t, std::uint32_t)> callback) {
+        erase_partial_success_callback = callback;
+    }
     void set_unlock_callback(std::function<bool(std::uint64_t)> callback) {
         unlock_success_callback = callback;
     }
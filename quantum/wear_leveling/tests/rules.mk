@@ -63,4 +63,43 @@ wear_leveling_8byte_SRC := \
 	$(wear_leveling_common_SRC) \
 	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_8byte.cpp
 wear_leveling_8byte_INC := \
-	$(wear_leveling_common_INC)
\ No newline at end of file
+	$(wear_leveling_common_INC)
+wear_leveling_2byte_write_amplification_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DWEAR_LEVELING_BACKING_SIZE=2048 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=1024
+wear_leveling_2byte_write_amplification_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_write_amplification.cpp
+wear_leveling_2byte_write_amplification_INC := \
+	$(wear_leveling_common_INC)
+
+wear_leveling_2byte_write_back_DEFS := \
+	$(wear_leveling_2byte_write_amplification_DEFS) \
+	-DWEAR_LEVELING_WRITE_BACK
+wear_leveling_2byte_write_back_SRC := \
+	$(wear_leveling_2byte_write_amplification_SRC)
+wear_leveling_2byte_write_back_INC := \
+	$(wear_leveling_common_INC)
+
+wear_leveling_2byte_incremental_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DWEAR_LEVELING_BACKING_SIZE=256 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=64 \
+	-DWEAR_LEVELING_INCREMENTAL_CONSOLIDATION \
+	-DWEAR_LEVELING_CONSOLIDATION_CHUNK=16
+wear_leveling_2byte_incremental_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_incremental.cpp
+wear_leveling_2byte_incremental_INC := \
+	$(wear_leveling_common_INC)
+
+wear_leveling_2byte_incremental_write_back_DEFS := \
+	$(wear_leveling_2byte_incremental_DEFS) \
+	-DWEAR_LEVELING_WRITE_BACK
+wear_leveling_2byte_incremental_write_back_SRC := \
+	$(wear_leveling_2byte_incremental_SRC)
+wear_leveling_2byte_incremental_write_back_INC := \
+	$(wear_leveling_common_INC)
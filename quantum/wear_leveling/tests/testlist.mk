@@ -3,4 +3,8 @@ TEST_LIST += \
 	wear_leveling_2byte_optimized_writes \
 	wear_leveling_2byte \
 	wear_leveling_4byte \
-	wear_leveling_8byte
+	wear_leveling_8byte \
+	wear_leveling_2byte_write_amplification \
+	wear_leveling_2byte_write_back \
+	wear_leveling_2byte_incremental \
+	wear_leveling_2byte_incremental_write_back
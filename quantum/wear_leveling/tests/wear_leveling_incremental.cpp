@@ -0,0 +1,200 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <numeric>
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "backing_mocks.hpp"
+
+class WearLevelingIncremental : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        MockBackingStore::Instance().reset_instance();
+        wear_leveling_init();
+        verify_data.fill(0);
+        counter = 0;
+    }
+
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> verify_data;
+    std::uint8_t                                         counter;
+
+    wear_leveling_status_t write_byte(const uint32_t address) {
+        uint8_t value        = ++counter;
+        verify_data[address] = value;
+        auto status          = wear_leveling_write(address, &value, sizeof(value));
+#ifdef WEAR_LEVELING_WRITE_BACK
+        // Flushed straight away, so the log fills up as it would writing through
+        if (status == WEAR_LEVELING_SUCCESS) {
+            status = wear_leveling_flush();
+        }
+#endif // WEAR_LEVELING_WRITE_BACK
+        return status;
+    }
+
+    // Writes single bytes until a background consolidation starts
+    void fill_log_until_pending() {
+        for (uint32_t i = 0; !wear_leveling_consolidation_pending(); ++i) {
+            ASSERT_EQ(write_byte(i % WEAR_LEVELING_LOGICAL_SIZE), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+            ASSERT_LT(i, WEAR_LEVELING_BANK_SIZE) << "Consolidation never started";
+        }
+    }
+
+    // Runs background steps until the consolidation completes, returning the number of steps
+    int run_to_completion() {
+        auto& inst  = MockBackingStore::Instance();
+        int   steps = 0;
+        while (wear_leveling_consolidation_pending()) {
+            auto partial_erases = inst.erase_partial_invoke_count();
+            auto writes         = inst.write_invoke_count();
+            auto status         = wear_leveling_task();
+            EXPECT_NE(status, WEAR_LEVELING_FAILED) << "Step failed";
+            EXPECT_LE(inst.erase_partial_invoke_count() - partial_erases, 1) << "Step erased more than one sector";
+            if (status == WEAR_LEVELING_SUCCESS) {
+                EXPECT_LE(inst.write_invoke_count() - writes, WEAR_LEVELING_CONSOLIDATION_CHUNK / BACKING_STORE_WRITE_SIZE) << "Step wrote more than one chunk";
+            }
+            ++steps;
+        }
+        return steps;
+    }
+
+    void verify_after_reboot() {
+        EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> readback;
+        EXPECT_EQ(wear_leveling_read(0, readback.data(), readback.size()), WEAR_LEVELING_SUCCESS) << "Failed to read";
+        EXPECT_EQ(readback, verify_data) << "Invalid readback";
+    }
+};
+
+/**
+ * This test verifies that filling half the log starts a consolidation into the spare bank, which runs a sector or
+ * chunk per step and never erases the whole backing store.
+ */
+TEST_F(WearLevelingIncremental, ConsolidatesInSteps) {
+    auto& inst = MockBackingStore::Instance();
+    fill_log_until_pending();
+    EXPECT_EQ(inst.partial_erasure_count(), 0) << "Nothing should happen until the first step";
+
+    int steps = run_to_completion();
+    EXPECT_EQ(steps, (WEAR_LEVELING_BANK_SIZE / MOCK_ERASE_SECTOR_SIZE::value) + (WEAR_LEVELING_LOGICAL_SIZE / WEAR_LEVELING_CONSOLIDATION_CHUNK) + 1) << "Unexpected number of steps";
+    EXPECT_EQ(inst.erasure_count(), 0) << "Backing store should not have been fully erased";
+    EXPECT_EQ(inst.partial_erasure_count(), WEAR_LEVELING_BANK_SIZE / MOCK_ERASE_SECTOR_SIZE::value) << "Spare bank should have been erased";
+
+    // New writes go to the log of the second bank
+    auto log_size = std::distance(inst.log_begin(), inst.log_end());
+    EXPECT_EQ(write_byte(0x04), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+    EXPECT_EQ((inst.log_begin() + log_size)->address, WEAR_LEVELING_BANK_SIZE + WEAR_LEVELING_LOG_OFFSET) << "Invalid write log address";
+
+    verify_after_reboot();
+}
+
+/**
+ * This test verifies that writes made while consolidating are kept, both to data already copied to the spare bank and
+ * to data not yet copied.
+ */
+TEST_F(WearLevelingIncremental, WritesDuringConsolidation) {
+    fill_log_until_pending();
+
+    // Erase the spare bank, then copy the first chunk
+    for (std::size_t i = 0; i < WEAR_LEVELING_BANK_SIZE / MOCK_ERASE_SECTOR_SIZE::value + 1; ++i) {
+        EXPECT_EQ(wear_leveling_task(), WEAR_LEVELING_SUCCESS) << "Step returned incorrect status";
+    }
+
+    EXPECT_EQ(write_byte(0x01), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+    EXPECT_EQ(write_byte(WEAR_LEVELING_LOGICAL_SIZE - 1), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+
+    run_to_completion();
+    verify_after_reboot();
+}
+
+/**
+ * This test verifies that losing power part way through leaves the live bank in charge, and that the consolidation is
+ * picked up again after the reboot.
+ */
+TEST_F(WearLevelingIncremental, PowerLossDuringConsolidation) {
+    fill_log_until_pending();
+    for (std::size_t steps = 0; steps < WEAR_LEVELING_BANK_SIZE / MOCK_ERASE_SECTOR_SIZE::value + 2; ++steps) {
+        EXPECT_EQ(wear_leveling_task(), WEAR_LEVELING_SUCCESS) << "Step returned incorrect status";
+    }
+
+    verify_after_reboot();
+
+    // The log is still half full, so it starts over from the beginning
+    EXPECT_TRUE(wear_leveling_consolidation_pending()) << "Consolidation should restart after a reboot";
+    run_to_completion();
+    verify_after_reboot();
+}
+
+/**
+ * This test verifies that the remaining steps run inline if the log fills up before the background steps have run.
+ */
+TEST_F(WearLevelingIncremental, LogFullFinishesInline) {
+    auto&                  inst   = MockBackingStore::Instance();
+    wear_leveling_status_t status = WEAR_LEVELING_SUCCESS;
+    for (uint32_t i = 0; status == WEAR_LEVELING_SUCCESS; ++i) {
+        status = write_byte(i % WEAR_LEVELING_LOGICAL_SIZE);
+        ASSERT_LT(i, WEAR_LEVELING_BANK_SIZE) << "Log never filled up";
+    }
+    EXPECT_EQ(status, WEAR_LEVELING_CONSOLIDATED) << "Write returned incorrect status";
+    EXPECT_FALSE(wear_leveling_consolidation_pending()) << "Consolidation should have completed";
+    EXPECT_EQ(inst.erasure_count(), 0) << "Backing store should not have been fully erased";
+
+    verify_after_reboot();
+}
+
+/**
+ * This test verifies that the newest bank is picked on boot, as the older bank stays valid until it's next erased.
+ */
+TEST_F(WearLevelingIncremental, NewestBankWins) {
+    for (int round = 0; round < 5; ++round) {
+        fill_log_until_pending();
+        run_to_completion();
+        verify_after_reboot();
+    }
+}
+
+/**
+ * This test verifies that a backing store which can't erase a single bank falls back to erasing everything.
+ */
+TEST_F(WearLevelingIncremental, NoPartialEraseFallsBack) {
+    auto& inst = MockBackingStore::Instance();
+    inst.set_erase_partial_callback([](std::uint64_t, std::uint32_t) { return false; });
+
+    fill_log_until_pending();
+    EXPECT_EQ(wear_leveling_task(), WEAR_LEVELING_FAILED) << "Step returned incorrect status";
+    EXPECT_FALSE(wear_leveling_consolidation_pending()) << "Failed consolidation should not be retried in the background";
+
+    wear_leveling_status_t status = WEAR_LEVELING_SUCCESS;
+    for (uint32_t i = 0; status == WEAR_LEVELING_SUCCESS; ++i) {
+        status = write_byte(i % WEAR_LEVELING_LOGICAL_SIZE);
+        ASSERT_LT(i, WEAR_LEVELING_BANK_SIZE) << "Log never filled up";
+    }
+    EXPECT_EQ(status, WEAR_LEVELING_CONSOLIDATED) << "Write returned incorrect status";
+    EXPECT_EQ(inst.erasure_count(), 1) << "Backing store should have been fully erased";
+
+    // The fresh log should be consolidated in the background again once it fills up
+    fill_log_until_pending();
+
+    verify_after_reboot();
+}
+
+#ifdef WEAR_LEVELING_WRITE_BACK
+/**
+ * This test verifies that saved erase cycles are counted against the half of the bank's log that starts a consolidation.
+ */
+TEST_F(WearLevelingIncremental, StatsCountHalfLogPerConsolidation) {
+    for (uint32_t address = 0; address < WEAR_LEVELING_LOGICAL_SIZE; ++address) {
+        verify_data[address] = address | 0x80;
+        EXPECT_EQ(wear_leveling_write(address, &verify_data[address], 1), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+    }
+    EXPECT_NE(wear_leveling_flush(), WEAR_LEVELING_FAILED) << "Flush returned incorrect status";
+    run_to_completion();
+
+    wear_leveling_stats_t stats;
+    wear_leveling_get_stats(&stats);
+    const uint32_t half_log = (WEAR_LEVELING_BANK_SIZE - WEAR_LEVELING_LOG_OFFSET) / 2;
+    ASSERT_GT(stats.log_bytes_write_through, stats.log_bytes);
+    EXPECT_EQ(stats.consolidations_saved, (stats.log_bytes_write_through - stats.log_bytes) / half_log);
+    EXPECT_GT(stats.consolidations_saved, 0) << "Coalescing should have saved erase cycles";
+
+    verify_after_reboot();
+}
+#endif // WEAR_LEVELING_WRITE_BACK
@@ -0,0 +1,237 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <cstdio>
+#include <numeric>
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "backing_mocks.hpp"
+
+// Built both with and without WEAR_LEVELING_WRITE_BACK, so the printed figures of the two test runs can be compared.
+
+class WearLevelingWriteAmplification : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        MockBackingStore::Instance().reset_instance();
+        wear_leveling_init();
+        verify_data.fill(0);
+        logical_bytes = 0;
+    }
+
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> verify_data;
+    std::size_t                                          logical_bytes;
+
+    void write(const uint32_t address, const void* value, size_t length) {
+        memcpy(&verify_data[address], value, length);
+        logical_bytes += length;
+        EXPECT_NE(wear_leveling_write(address, value, length), WEAR_LEVELING_FAILED) << "Write failed";
+    }
+
+    // Equivalent of eeprom_update_byte(), as used by dynamic_keymap_set_buffer()
+    void update_byte(const uint32_t address, uint8_t value) {
+        uint8_t current;
+        wear_leveling_read(address, &current, sizeof(current));
+        if (current != value) {
+            write(address, &value, sizeof(value));
+        }
+    }
+
+    // Stands in for the idle flush of the EEPROM driver
+    void idle() {
+#ifdef WEAR_LEVELING_WRITE_BACK
+        EXPECT_NE(wear_leveling_flush(), WEAR_LEVELING_FAILED) << "Flush failed";
+#endif
+    }
+
+    void verify_after_reboot() {
+        EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> readback;
+        EXPECT_EQ(wear_leveling_read(0, readback.data(), readback.size()), WEAR_LEVELING_SUCCESS) << "Failed to read";
+        EXPECT_EQ(readback, verify_data) << "Invalid readback";
+    }
+
+    void report(const char* workload) {
+        auto& inst = MockBackingStore::Instance();
+        std::printf("%-24s %5zu logical bytes -> %6llu backing bytes (%5.2fx), %llu erase(s)\n", workload, logical_bytes, (unsigned long long)(inst.total_write_count() * BACKING_STORE_WRITE_SIZE), (double)(inst.total_write_count() * BACKING_STORE_WRITE_SIZE) / logical_bytes, (unsigned long long)inst.erasure_count());
+#ifdef WEAR_LEVELING_WRITE_BACK
+        wear_leveling_stats_t stats;
+        wear_leveling_get_stats(&stats);
+        std::printf("%-24s write-through would have logged %lu bytes, logged %lu, %lu erase(s) saved\n", "", (unsigned long)stats.log_bytes_write_through, (unsigned long)stats.log_bytes, (unsigned long)stats.consolidations_saved);
+#endif
+    }
+};
+
+/**
+ * A VIA keymap upload -- four layers of a 60 key board, written a byte at a time from a random-ish keymap.
+ */
+TEST_F(WearLevelingWriteAmplification, KeymapUpload) {
+    const uint32_t keymap_address = 37;
+    const size_t   keymap_size    = 4 * 60 * 2;
+    uint32_t       seed           = 1;
+    for (size_t offset = 0; offset < keymap_size; offset += 2) {
+        seed = seed * 1103515245 + 12345;
+        // Mostly KC_NO/KC_TRNS on the upper layers, like a real keymap
+        uint16_t keycode = offset < keymap_size / 4 ? (seed >> 16) & 0xFF : (seed >> 16) & 1;
+        update_byte(keymap_address + offset, keycode & 0xFF);
+        update_byte(keymap_address + offset + 1, keycode >> 8);
+    }
+    idle();
+
+    report("Keymap upload");
+    verify_after_reboot();
+}
+
+/**
+ * Holding down a brightness key -- the same eeconfig block rewritten on every step, with idle gaps.
+ */
+TEST_F(WearLevelingWriteAmplification, ConfigBursts) {
+    const uint32_t config_address = 0x20;
+    for (int burst = 0; burst < 10; ++burst) {
+        for (uint8_t step = 0; step < 32; ++step) {
+            uint8_t config[4] = {0x01, (uint8_t)(burst * 32 + step), 0x80, (uint8_t)burst};
+            write(config_address, config, sizeof(config));
+        }
+        idle();
+    }
+
+    report("Config bursts");
+    verify_after_reboot();
+}
+
+/**
+ * Scattered single byte writes across the whole logical area.
+ */
+TEST_F(WearLevelingWriteAmplification, ScatteredWrites) {
+    uint32_t seed = 7;
+    for (int batch = 0; batch < 20; ++batch) {
+        for (int i = 0; i < 24; ++i) {
+            seed             = seed * 1103515245 + 12345;
+            uint32_t address = (seed >> 8) % WEAR_LEVELING_LOGICAL_SIZE;
+            uint8_t  value   = seed >> 24;
+            write(address, &value, sizeof(value));
+        }
+        idle();
+    }
+
+    report("Scattered writes");
+    verify_after_reboot();
+}
+
+#ifdef WEAR_LEVELING_WRITE_BACK
+
+/**
+ * This test verifies that nothing reaches the backing store until a flush, while reads see the new data straight away.
+ */
+TEST_F(WearLevelingWriteAmplification, WritesDeferredUntilFlush) {
+    auto&   inst  = MockBackingStore::Instance();
+    uint8_t value = 0x42;
+    write(0x100, &value, sizeof(value));
+
+    uint8_t readback = 0;
+    EXPECT_EQ(wear_leveling_read(0x100, &readback, sizeof(readback)), WEAR_LEVELING_SUCCESS) << "Failed to read";
+    EXPECT_EQ(readback, value) << "Read did not see the pending write";
+    EXPECT_TRUE(wear_leveling_write_pending()) << "Write should be pending";
+    EXPECT_EQ(inst.write_invoke_count(), 0) << "Backing store was written before the flush";
+
+    EXPECT_EQ(wear_leveling_flush(), WEAR_LEVELING_SUCCESS) << "Flush returned incorrect status";
+    EXPECT_FALSE(wear_leveling_write_pending()) << "Nothing should be pending after a flush";
+    EXPECT_GT(inst.write_invoke_count(), 0) << "Flush did not write to the backing store";
+    EXPECT_TRUE(inst.is_locked()) << "Backing store left unlocked";
+
+    verify_after_reboot();
+}
+
+/**
+ * This test verifies that single byte writes to neighbouring addresses are flushed as full multi-byte log entries, and
+ * that rewritten addresses are only logged once.
+ */
+TEST_F(WearLevelingWriteAmplification, AdjacentWritesCoalesced) {
+    auto& inst = MockBackingStore::Instance();
+    for (uint8_t pass = 0; pass < 3; ++pass) {
+        for (uint32_t i = 0; i < LOG_ENTRY_MULTIBYTE_MAX_BYTES; ++i) {
+            uint8_t value = 0x10 + pass + i;
+            write(0x200 + (LOG_ENTRY_MULTIBYTE_MAX_BYTES - 1 - i), &value, sizeof(value));
+        }
+    }
+    EXPECT_EQ(wear_leveling_flush(), WEAR_LEVELING_SUCCESS) << "Flush returned incorrect status";
+
+    // One multi-byte entry, a full one takes 4 writes on a 2-byte backing store
+    EXPECT_EQ(std::distance(inst.log_begin(), inst.log_end()), 4);
+    write_log_entry_t e;
+    e.raw16[0] = inst.log_begin()->value;
+    e.raw16[1] = (inst.log_begin() + 1)->value;
+    EXPECT_EQ(LOG_ENTRY_GET_TYPE(e), LOG_ENTRY_TYPE_MULTIBYTE) << "Invalid write log entry type";
+    EXPECT_EQ(LOG_ENTRY_MULTIBYTE_GET_ADDRESS(e), 0x200) << "Invalid write log entry address";
+    EXPECT_EQ(LOG_ENTRY_MULTIBYTE_GET_LENGTH(e), LOG_ENTRY_MULTIBYTE_MAX_BYTES) << "Invalid write log entry length";
+
+    verify_after_reboot();
+}
+
+/**
+ * This test verifies that more disjoint writes than there are dirty ranges still all make it to the backing store.
+ */
+TEST_F(WearLevelingWriteAmplification, DirtyRangesExhausted) {
+    for (uint32_t i = 0; i < 4 * WEAR_LEVELING_WRITE_BACK_RANGES; ++i) {
+        uint8_t value = 0x80 + i;
+        write(0x80 + ((i * 37) % 400) * 2, &value, sizeof(value));
+    }
+    EXPECT_NE(wear_leveling_flush(), WEAR_LEVELING_FAILED) << "Flush failed";
+
+    verify_after_reboot();
+}
+
+/**
+ * This test verifies that an erase drops pending writes.
+ */
+TEST_F(WearLevelingWriteAmplification, EraseDropsPendingWrites) {
+    auto&   inst  = MockBackingStore::Instance();
+    uint8_t value = 0x42;
+    write(0x100, &value, sizeof(value));
+    EXPECT_EQ(wear_leveling_erase(), WEAR_LEVELING_SUCCESS) << "Erase returned incorrect status";
+    EXPECT_FALSE(wear_leveling_write_pending()) << "Erase should drop pending writes";
+
+    EXPECT_EQ(wear_leveling_flush(), WEAR_LEVELING_SUCCESS) << "Flush returned incorrect status";
+    EXPECT_EQ(inst.write_invoke_count(), 0) << "Dropped write reached the backing store";
+}
+
+/**
+ * This test verifies that a failed flush keeps the data pending, and a later flush writes it out.
+ */
+TEST_F(WearLevelingWriteAmplification, FailedFlushRetried) {
+    auto& inst = MockBackingStore::Instance();
+    std::array<std::uint8_t, 16> block;
+    std::iota(block.begin(), block.end(), 0x30);
+    write(0x180, block.data(), block.size());
+
+    inst.set_write_callback([](std::uint64_t, std::uint32_t) { return false; });
+    EXPECT_EQ(wear_leveling_flush(), WEAR_LEVELING_FAILED) << "Flush returned incorrect status";
+    EXPECT_TRUE(wear_leveling_write_pending()) << "Failed flush should keep the write pending";
+
+    inst.set_write_callback([](std::uint64_t, std::uint32_t) { return true; });
+    EXPECT_EQ(wear_leveling_flush(), WEAR_LEVELING_SUCCESS) << "Flush returned incorrect status";
+
+    verify_after_reboot();
+}
+
+/**
+ * This test verifies the traffic counters, and that coalescing a long keymap upload saves erase cycles.
+ */
+TEST_F(WearLevelingWriteAmplification, StatsReportSavedErases) {
+    auto& inst = MockBackingStore::Instance();
+    for (uint32_t address = 64; address < 64 + 900; ++address) {
+        update_byte(address, (address * 7) | 0x80);
+    }
+    EXPECT_EQ(wear_leveling_flush(), WEAR_LEVELING_CONSOLIDATED) << "Flush returned incorrect status";
+
+    wear_leveling_stats_t stats;
+    wear_leveling_get_stats(&stats);
+    EXPECT_EQ(stats.bytes_written, 900);
+    EXPECT_EQ(stats.consolidations, inst.erasure_count());
+    // Each byte on its own takes a 4 byte entry, coalesced it's 8 bytes per 5
+    EXPECT_EQ(stats.log_bytes_write_through, 900 * 4);
+    EXPECT_LT(stats.log_bytes, stats.log_bytes_write_through);
+    EXPECT_EQ(stats.consolidations_saved, 2) << "Coalescing should have saved erase cycles";
+
+    verify_after_reboot();
+}
+
+#endif // WEAR_LEVELING_WRITE_BACK
@@ -76,6 +76,12 @@
             * A new write log entry is appended to the log.
             * If the log's full, data is consolidated and the write log cleared.
 
+        With WEAR_LEVELING_WRITE_BACK, writes only update the cache and record
+        the dirty range, merging it with any overlapping or adjacent range.
+        wear_leveling_flush() appends each dirty range to the log in one go, so
+        a burst of single byte writes becomes a few multi-byte log entries and
+        rewrites of the same address before a flush cost nothing.
+
     Write log structure:
 
         The first 8 bytes of the write log are a FNV1a_64 hash of the contents
@@ -153,7 +159,48 @@
         ║  │Address >> 1 ║
         ║  └── Value: 1  ║
         ╚════════════════╝
-        0 <= Address <= 0x3FFE (16382) */
+        0 <= Address <= 0x3FFE (16382)
+
+    Incremental consolidation:
+
+        With WEAR_LEVELING_INCREMENTAL_CONSOLIDATION, the backing store is split
+        into two banks, each laid out as above with an extra 8 bytes holding a
+        generation counter between the FNV1a_64 and the write log. The live
+        bank is the valid one -- matching FNV1a_64 -- with the newer generation.
+
+        Once the live bank's log is half full, consolidation into the spare
+        bank is started, and wear_leveling_task() advances it a step at a time:
+            * Erase the spare bank, one sector per step.
+            * Copy the cache to the spare bank, one chunk per step, hashing it
+                as it goes.
+            * Append any bytes changed since they were copied to the spare
+                bank's log, then write its generation and FNV1a_64.
+        Writes keep going to the live bank's log until the final step, which
+        makes the spare bank live. A power loss at any point leaves the old
+        bank intact. If the live log fills up before then, the remaining steps
+        run straight away. */
+
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+/**
+ * Progress of the consolidation into the spare bank.
+ */
+typedef enum wear_leveling_consolidation_state_t {
+    CONSOLIDATION_IDLE,
+    CONSOLIDATION_ERASING,
+    CONSOLIDATION_COPYING,
+    CONSOLIDATION_FINISHING,
+} wear_leveling_consolidation_state_t;
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
+#ifdef WEAR_LEVELING_WRITE_BACK
+/**
+ * Logical range [start, end) which has been written to the cache, but not yet to the write log.
+ */
+typedef struct wear_leveling_dirty_range_t {
+    uint32_t start;
+    uint32_t end;
+} wear_leveling_dirty_range_t;
+#endif // WEAR_LEVELING_WRITE_BACK
 
 /**
  * Storage area for the wear-leveling cache.
@@ -162,8 +209,28 @@ static struct __attribute__((__aligned__(BACKING_STORE_WRITE_SIZE))) {
     __attribute__((__aligned__(BACKING_STORE_WRITE_SIZE))) uint8_t cache[(WEAR_LEVELING_LOGICAL_SIZE)];
     uint32_t                                                       write_address;
     bool                                                           unlocked;
+#ifdef WEAR_LEVELING_WRITE_BACK
+    wear_leveling_dirty_range_t dirty[(WEAR_LEVELING_WRITE_BACK_RANGES) + 1]; // +1 leaves room to insert before merging down to the limit
+    uint8_t                     dirty_count;
+    bool                        estimating; // Log appends are only counted, not written
+    wear_leveling_stats_t       stats;
+#endif // WEAR_LEVELING_WRITE_BACK
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+    uint32_t                            bank;       // Address of the live bank
+    uint32_t                            generation; // Generation of the live bank
+    wear_leveling_consolidation_state_t consolidation_state;
+    uint32_t                            consolidation_offset; // Next offset to erase or copy in the spare bank
+    uint64_t                            consolidation_hash;   // FNV1a_64 of the data copied so far
+    bool                                consolidation_failed; // Don't restart in the background until the log fills up
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
 } wear_leveling;
 
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+#    define WEAR_LEVELING_BANK_ADDRESS (wear_leveling.bank)
+#else
+#    define WEAR_LEVELING_BANK_ADDRESS 0
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
 /**
  * Locking helper: status
  */
@@ -202,7 +269,36 @@ static inline backing_store_lock_status_t wear_leveling_lock(void) {
  */
 static void wear_leveling_clear_cache(void) {
     memset(wear_leveling.cache, 0, (WEAR_LEVELING_LOGICAL_SIZE));
-    wear_leveling.write_address = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 is due to the FNV1a_64 of the consolidated buffer
+    wear_leveling.write_address = WEAR_LEVELING_BANK_ADDRESS + (WEAR_LEVELING_LOG_OFFSET);
+#ifdef WEAR_LEVELING_WRITE_BACK
+    wear_leveling.dirty_count = 0;
+#endif // WEAR_LEVELING_WRITE_BACK
+}
+
+/**
+ * Reads an 8-byte entry, such as the FNV1a_64 of the consolidated data, from the backing store.
+ */
+static bool wear_leveling_read_entry(uint32_t address, write_log_entry_t *entry) {
+#if BACKING_STORE_WRITE_SIZE == 2
+    return backing_store_read_bulk(address, entry->raw16, 4);
+#elif BACKING_STORE_WRITE_SIZE == 4
+    return backing_store_read_bulk(address, entry->raw32, 2);
+#elif BACKING_STORE_WRITE_SIZE == 8
+    return backing_store_read(address, &entry->raw64);
+#endif
+}
+
+/**
+ * Writes an 8-byte entry, such as the FNV1a_64 of the consolidated data, to the backing store.
+ */
+static bool wear_leveling_write_entry(uint32_t address, write_log_entry_t *entry) {
+#if BACKING_STORE_WRITE_SIZE == 2
+    return backing_store_write_bulk(address, entry->raw16, 4);
+#elif BACKING_STORE_WRITE_SIZE == 4
+    return backing_store_write_bulk(address, entry->raw32, 2);
+#elif BACKING_STORE_WRITE_SIZE == 8
+    return backing_store_write(address, entry->raw64);
+#endif
 }
 
 /**
@@ -213,7 +309,7 @@ static wear_leveling_status_t wear_leveling_read_consolidated(void) {
     wl_dprintf("Reading consolidated data\n");
 
     wear_leveling_status_t status = WEAR_LEVELING_SUCCESS;
-    if (!backing_store_read_bulk(0, (backing_store_int_t *)wear_leveling.cache, sizeof(wear_leveling.cache) / sizeof(backing_store_int_t))) {
+    if (!backing_store_read_bulk(WEAR_LEVELING_BANK_ADDRESS, (backing_store_int_t *)wear_leveling.cache, sizeof(wear_leveling.cache) / sizeof(backing_store_int_t))) {
         wl_dprintf("Failed to read from backing store\n");
         status = WEAR_LEVELING_FAILED;
     }
@@ -223,13 +319,7 @@ static wear_leveling_status_t wear_leveling_read_consolidated(void) {
         uint64_t          expected = fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT);
         write_log_entry_t entry;
         wl_dprintf("Reading checksum\n");
-#if BACKING_STORE_WRITE_SIZE == 2
-        backing_store_read_bulk((WEAR_LEVELING_LOGICAL_SIZE), entry.raw16, 4);
-#elif BACKING_STORE_WRITE_SIZE == 4
-        backing_store_read_bulk((WEAR_LEVELING_LOGICAL_SIZE), entry.raw32, 2);
-#elif BACKING_STORE_WRITE_SIZE == 8
-        backing_store_read((WEAR_LEVELING_LOGICAL_SIZE) + 0, &entry.raw64);
-#endif
+        wear_leveling_read_entry(WEAR_LEVELING_BANK_ADDRESS + (WEAR_LEVELING_LOGICAL_SIZE), &entry);
         // If we have a mismatch, clear the cache but do not flag a failure,
         // which will cater for the completely clean MCU case.
         if (entry.raw64 == expected) {
@@ -258,34 +348,29 @@ static wear_leveling_status_t wear_leveling_write_consolidated(void) {
 
     backing_store_lock_status_t lock_status = wear_leveling_unlock();
     wear_leveling_status_t      status      = WEAR_LEVELING_CONSOLIDATED;
-    if (!backing_store_write_bulk(0, (backing_store_int_t *)wear_leveling.cache, sizeof(wear_leveling.cache) / sizeof(backing_store_int_t))) {
+    if (!backing_store_write_bulk(WEAR_LEVELING_BANK_ADDRESS, (backing_store_int_t *)wear_leveling.cache, sizeof(wear_leveling.cache) / sizeof(backing_store_int_t))) {
         wl_dprintf("Failed to write to backing store\n");
         status = WEAR_LEVELING_FAILED;
     }
 
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+    if (status != WEAR_LEVELING_FAILED) {
+        // Write out the generation ahead of the FNV1a_64, which is what makes the bank valid
+        write_log_entry_t entry = {.raw64 = wear_leveling.generation};
+        if (!wear_leveling_write_entry(WEAR_LEVELING_BANK_ADDRESS + (WEAR_LEVELING_LOGICAL_SIZE) + 8, &entry)) {
+            status = WEAR_LEVELING_FAILED;
+        }
+    }
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
     if (status != WEAR_LEVELING_FAILED) {
         // Write out the FNV1a_64 result of the consolidated data
         write_log_entry_t entry;
         entry.raw64 = fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT);
         wl_dprintf("Writing checksum\n");
-        do {
-#if BACKING_STORE_WRITE_SIZE == 2
-            if (!backing_store_write_bulk((WEAR_LEVELING_LOGICAL_SIZE), entry.raw16, 4)) {
-                status = WEAR_LEVELING_FAILED;
-                break;
-            }
-#elif BACKING_STORE_WRITE_SIZE == 4
-            if (!backing_store_write_bulk((WEAR_LEVELING_LOGICAL_SIZE), entry.raw32, 2)) {
-                status = WEAR_LEVELING_FAILED;
-                break;
-            }
-#elif BACKING_STORE_WRITE_SIZE == 8
-            if (!backing_store_write((WEAR_LEVELING_LOGICAL_SIZE), entry.raw64)) {
-                status = WEAR_LEVELING_FAILED;
-                break;
-            }
-#endif
-        } while (0);
+        if (!wear_leveling_write_entry(WEAR_LEVELING_BANK_ADDRESS + (WEAR_LEVELING_LOGICAL_SIZE), &entry)) {
+            status = WEAR_LEVELING_FAILED;
+        }
     }
 
     if (lock_status == STATUS_SUCCESS) {
@@ -294,12 +379,167 @@ static wear_leveling_status_t wear_leveling_write_consolidated(void) {
     return status;
 }
 
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+static wear_leveling_status_t wear_leveling_write_raw(uint32_t address, const void *value, size_t length);
+
+/**
+ * Starts consolidating into the spare bank, the steps are run by wear_leveling_consolidation_step().
+ */
+static void wear_leveling_consolidation_begin(void) {
+    wl_dprintf("Starting incremental consolidation\n");
+    wear_leveling.consolidation_state  = CONSOLIDATION_ERASING;
+    wear_leveling.consolidation_offset = 0;
+}
+
+/**
+ * Abandons the consolidation, the spare bank is erased again by the next attempt.
+ */
+static wear_leveling_status_t wear_leveling_consolidation_abort(void) {
+    wl_dprintf("Incremental consolidation failed\n");
+    wear_leveling.consolidation_state  = CONSOLIDATION_IDLE;
+    wear_leveling.consolidation_failed = true;
+    return WEAR_LEVELING_FAILED;
+}
+
+/**
+ * Final step: catches the spare bank up with any writes made since copying started, then makes it the live bank.
+ */
+static wear_leveling_status_t wear_leveling_consolidation_finish(uint32_t spare) {
+    const uint32_t live_bank          = wear_leveling.bank;
+    const uint32_t live_write_address = wear_leveling.write_address;
+
+    // Log entries from here on go to the spare bank
+    wear_leveling.bank          = spare;
+    wear_leveling.write_address = spare + (WEAR_LEVELING_LOG_OFFSET);
+
+    wear_leveling_status_t status = WEAR_LEVELING_SUCCESS;
+    for (uint32_t offset = 0; offset < (WEAR_LEVELING_LOGICAL_SIZE) && status == WEAR_LEVELING_SUCCESS; offset += (WEAR_LEVELING_CONSOLIDATION_CHUNK)) {
+        backing_store_int_t chunk[(WEAR_LEVELING_CONSOLIDATION_CHUNK) / (BACKING_STORE_WRITE_SIZE)];
+        const uint8_t *     copied    = (const uint8_t *)chunk;
+        const uint32_t      remaining = (WEAR_LEVELING_LOGICAL_SIZE) - offset;
+        const uint32_t      length    = remaining < (WEAR_LEVELING_CONSOLIDATION_CHUNK) ? remaining : (WEAR_LEVELING_CONSOLIDATION_CHUNK);
+        if (!backing_store_read_bulk(spare + offset, chunk, length / (BACKING_STORE_WRITE_SIZE))) {
+            status = WEAR_LEVELING_FAILED;
+            break;
+        }
+
+        // Log each run of bytes that no longer matches the cache
+        uint32_t i = 0;
+        while (i < length && status == WEAR_LEVELING_SUCCESS) {
+            if (copied[i] == wear_leveling.cache[offset + i]) {
+                ++i;
+                continue;
+            }
+            uint32_t end = i + 1;
+            while (end < length && copied[end] != wear_leveling.cache[offset + end]) {
+                ++end;
+            }
+            status = wear_leveling_write_raw(offset + i, &wear_leveling.cache[offset + i], end - i);
+            i      = end;
+        }
+    }
+
+    if (status == WEAR_LEVELING_SUCCESS) {
+        // The generation goes ahead of the FNV1a_64, which is what makes the bank valid
+        write_log_entry_t generation = {.raw64 = wear_leveling.generation + 1};
+        write_log_entry_t hash       = {.raw64 = wear_leveling.consolidation_hash};
+        if (!wear_leveling_write_entry(spare + (WEAR_LEVELING_LOGICAL_SIZE) + 8, &generation) || !wear_leveling_write_entry(spare + (WEAR_LEVELING_LOGICAL_SIZE), &hash)) {
+            status = WEAR_LEVELING_FAILED;
+        }
+    }
+
+    if (status != WEAR_LEVELING_SUCCESS) {
+        // The spare bank has no valid FNV1a_64, so the live bank is still the one read on the next boot
+        wear_leveling.bank          = live_bank;
+        wear_leveling.write_address = live_write_address;
+        return wear_leveling_consolidation_abort();
+    }
+
+    wl_dprintf("Incremental consolidation complete\n");
+    ++wear_leveling.generation;
+    wear_leveling.consolidation_state = CONSOLIDATION_IDLE;
+#    ifdef WEAR_LEVELING_WRITE_BACK
+    ++wear_leveling.stats.consolidations;
+#    endif // WEAR_LEVELING_WRITE_BACK
+    return WEAR_LEVELING_CONSOLIDATED;
+}
+
+/**
+ * Runs the next step of the consolidation into the spare bank -- at most one sector erase or chunk of writes, apart
+ * from the final step.
+ *
+ * @return WEAR_LEVELING_SUCCESS if more steps are needed, WEAR_LEVELING_CONSOLIDATED once the spare bank is live
+ */
+static wear_leveling_status_t wear_leveling_consolidation_step(void) {
+    const uint32_t spare = (WEAR_LEVELING_BANK_SIZE) - wear_leveling.bank;
+    switch (wear_leveling.consolidation_state) {
+        case CONSOLIDATION_IDLE:
+            break;
+
+        case CONSOLIDATION_ERASING: {
+            const uint32_t address = spare + wear_leveling.consolidation_offset;
+            uint32_t       next    = address;
+            if (!backing_store_erase_partial(address, spare + (WEAR_LEVELING_BANK_SIZE), &next) || next <= address) {
+                return wear_leveling_consolidation_abort();
+            }
+            wear_leveling.consolidation_offset = next - spare;
+            if (wear_leveling.consolidation_offset >= (WEAR_LEVELING_BANK_SIZE)) {
+                wear_leveling.consolidation_state  = CONSOLIDATION_COPYING;
+                wear_leveling.consolidation_offset = 0;
+                wear_leveling.consolidation_hash   = FNV1A_64_INIT;
+            }
+        } break;
+
+        case CONSOLIDATION_COPYING: {
+            const uint32_t offset    = wear_leveling.consolidation_offset;
+            const uint32_t remaining = (WEAR_LEVELING_LOGICAL_SIZE) - offset;
+            const uint32_t length    = remaining < (WEAR_LEVELING_CONSOLIDATION_CHUNK) ? remaining : (WEAR_LEVELING_CONSOLIDATION_CHUNK);
+            if (!backing_store_write_bulk(spare + offset, (backing_store_int_t *)&wear_leveling.cache[offset], length / (BACKING_STORE_WRITE_SIZE))) {
+                return wear_leveling_consolidation_abort();
+            }
+            // Hash what was written, later changes to the cache are picked up by the final step
+            wear_leveling.consolidation_hash   = fnv_64a_buf(&wear_leveling.cache[offset], length, wear_leveling.consolidation_hash);
+            wear_leveling.consolidation_offset = offset + length;
+            if (wear_leveling.consolidation_offset >= (WEAR_LEVELING_LOGICAL_SIZE)) {
+                wear_leveling.consolidation_state = CONSOLIDATION_FINISHING;
+            }
+        } break;
+
+        case CONSOLIDATION_FINISHING:
+            return wear_leveling_consolidation_finish(spare);
+    }
+
+    return WEAR_LEVELING_SUCCESS;
+}
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
 /**
  * Forces a write of the current cache.
  * Erases the backing store, including the write log.
  * During this operation, there is the potential for data loss if a power loss occurs.
  */
 static wear_leveling_status_t wear_leveling_consolidate_force(void) {
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+    // Run the remaining steps now, the live bank stays intact until the spare bank takes over. A second attempt has no
+    // writes arriving in between, so can't run out of log in the spare bank catching up.
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        if (wear_leveling.consolidation_state == CONSOLIDATION_IDLE) {
+            wear_leveling_consolidation_begin();
+        }
+        wear_leveling_status_t step_status;
+        do {
+            step_status = wear_leveling_consolidation_step();
+        } while (step_status == WEAR_LEVELING_SUCCESS);
+        if (step_status == WEAR_LEVELING_CONSOLIDATED) {
+            wear_leveling.consolidation_failed = false;
+            return step_status;
+        }
+    }
+
+    // The backing store can't erase a single bank, start over from the first one
+    wear_leveling.bank = 0;
+    ++wear_leveling.generation;
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
     wl_dprintf("Erasing backing store\n");
 
     // Erase the backing store. Expectation is that any un-written values that are read back after this call come back as zero.
@@ -308,15 +548,24 @@ static wear_leveling_status_t wear_leveling_consolidate_force(void) {
         wl_dprintf("Failed to erase backing store\n");
         return WEAR_LEVELING_FAILED;
     }
+#ifdef WEAR_LEVELING_WRITE_BACK
+    ++wear_leveling.stats.consolidations;
+#endif // WEAR_LEVELING_WRITE_BACK
 
     // Write the cache to the first section of the backing store.
     wear_leveling_status_t status = wear_leveling_write_consolidated();
     if (status == WEAR_LEVELING_FAILED) {
         wl_dprintf("Failed to write consolidated data\n");
     }
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+    else {
+        // The log starts over empty, so background consolidation may run again
+        wear_leveling.consolidation_failed = false;
+    }
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
 
     // Next write of the log occurs after the consolidated values at the start of the backing store.
-    wear_leveling.write_address = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 due to the FNV1a_64 of the consolidated area
+    wear_leveling.write_address = WEAR_LEVELING_BANK_ADDRESS + (WEAR_LEVELING_LOG_OFFSET);
 
     return status;
 }
@@ -329,7 +578,18 @@ static wear_leveling_status_t wear_leveling_consolidate_force(void) {
  * @return true if consolidation occurred
  */
 static wear_leveling_status_t wear_leveling_consolidate_if_needed(void) {
-    if (wear_leveling.write_address >= (WEAR_LEVELING_BACKING_SIZE)) {
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+    if (wear_leveling.consolidation_state == CONSOLIDATION_FINISHING) {
+        // Catching up the spare bank, running out of log there means starting over
+        return wear_leveling.write_address >= wear_leveling.bank + (WEAR_LEVELING_BANK_SIZE) ? WEAR_LEVELING_FAILED : WEAR_LEVELING_SUCCESS;
+    }
+
+    // Start early enough that the background steps finish before the log fills up
+    if (wear_leveling.consolidation_state == CONSOLIDATION_IDLE && !wear_leveling.consolidation_failed && wear_leveling.write_address >= wear_leveling.bank + (WEAR_LEVELING_LOG_OFFSET) + ((WEAR_LEVELING_BANK_SIZE) - (WEAR_LEVELING_LOG_OFFSET)) / 2) {
+        wear_leveling_consolidation_begin();
+    }
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+    if (wear_leveling.write_address >= WEAR_LEVELING_BANK_ADDRESS + (WEAR_LEVELING_BANK_SIZE)) {
         return wear_leveling_consolidate_force();
     }
 
@@ -342,6 +602,13 @@ static wear_leveling_status_t wear_leveling_consolidate_if_needed(void) {
  * @return true if consolidation occurred
  */
 static wear_leveling_status_t wear_leveling_append_raw(backing_store_int_t value) {
+#ifdef WEAR_LEVELING_WRITE_BACK
+    if (wear_leveling.estimating) {
+        wear_leveling.stats.log_bytes_write_through += (BACKING_STORE_WRITE_SIZE);
+        return WEAR_LEVELING_SUCCESS;
+    }
+    wear_leveling.stats.log_bytes += (BACKING_STORE_WRITE_SIZE);
+#endif // WEAR_LEVELING_WRITE_BACK
     bool ok = backing_store_write(wear_leveling.write_address, value);
     if (!ok) {
         wl_dprintf("Failed to write to backing store\n");
@@ -477,8 +744,8 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
 
     wear_leveling_status_t status          = WEAR_LEVELING_SUCCESS;
     bool                   cancel_playback = false;
-    uint32_t               address         = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 due to the FNV1a_64 of the consolidated area
-    while (!cancel_playback && address < (WEAR_LEVELING_BACKING_SIZE)) {
+    uint32_t               address         = WEAR_LEVELING_BANK_ADDRESS + (WEAR_LEVELING_LOG_OFFSET);
+    while (!cancel_playback && address < WEAR_LEVELING_BANK_ADDRESS + (WEAR_LEVELING_BANK_SIZE)) {
         backing_store_int_t value;
         bool                ok = backing_store_read(address, &value);
         if (!ok) {
@@ -611,6 +878,103 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
     return status;
 }
 
+#ifdef WEAR_LEVELING_WRITE_BACK
+/**
+ * Merges the two dirty ranges with the smallest gap between them, if that gap is no larger than `max_gap` -- the
+ * unchanged bytes in between are rewritten on flush.
+ *
+ * @return true if two ranges were merged
+ */
+static bool wear_leveling_merge_closest(uint32_t max_gap) {
+    wear_leveling_dirty_range_t *dirty   = wear_leveling.dirty;
+    uint8_t                      closest = 0;
+    for (uint8_t i = 1; i + 1 < wear_leveling.dirty_count; ++i) {
+        if (dirty[i + 1].start - dirty[i].end < dirty[closest + 1].start - dirty[closest].end) {
+            closest = i;
+        }
+    }
+    if (wear_leveling.dirty_count < 2 || dirty[closest + 1].start - dirty[closest].end > max_gap) {
+        return false;
+    }
+
+    dirty[closest].end = dirty[closest + 1].end;
+    --wear_leveling.dirty_count;
+    memmove(&dirty[closest + 1], &dirty[closest + 2], (wear_leveling.dirty_count - closest - 1) * sizeof(wear_leveling_dirty_range_t));
+    return true;
+}
+
+/**
+ * Records [start, end) as dirty, keeping the ranges sorted and merging any that overlap or touch.
+ *
+ * @return false if out of ranges, the range is still recorded but needs a flush to get back under the limit
+ */
+static bool wear_leveling_mark_dirty(uint32_t start, uint32_t end) {
+    wear_leveling_dirty_range_t *dirty = wear_leveling.dirty;
+
+    // Insert in order of start address
+    uint8_t index = 0;
+    while (index < wear_leveling.dirty_count && dirty[index].start < start) {
+        ++index;
+    }
+    memmove(&dirty[index + 1], &dirty[index], (wear_leveling.dirty_count - index) * sizeof(wear_leveling_dirty_range_t));
+    dirty[index].start = start;
+    dirty[index].end   = end;
+    ++wear_leveling.dirty_count;
+
+    // Merge overlapping and adjacent ranges
+    uint8_t last = 0;
+    for (uint8_t i = 1; i < wear_leveling.dirty_count; ++i) {
+        if (dirty[i].start <= dirty[last].end) {
+            if (dirty[i].end > dirty[last].end) {
+                dirty[last].end = dirty[i].end;
+            }
+        } else {
+            dirty[++last] = dirty[i];
+        }
+    }
+    wear_leveling.dirty_count = last + 1;
+
+    // Out of ranges, bridging a short gap is cheaper than the extra log entry
+    if (wear_leveling.dirty_count > (WEAR_LEVELING_WRITE_BACK_RANGES)) {
+        return wear_leveling_merge_closest(WEAR_LEVELING_WRITE_BACK_MAX_GAP);
+    }
+    return true;
+}
+#endif // WEAR_LEVELING_WRITE_BACK
+
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+/**
+ * Picks the live bank -- of the banks with a matching FNV1a_64, the one with the newer generation.
+ * Uses the cache as scratch space.
+ */
+static void wear_leveling_select_bank(void) {
+    bool found                         = false;
+    wear_leveling.bank                 = 0;
+    wear_leveling.generation           = 0;
+    wear_leveling.consolidation_state  = CONSOLIDATION_IDLE;
+    wear_leveling.consolidation_failed = false;
+
+    for (uint32_t bank = 0; bank < (WEAR_LEVELING_BACKING_SIZE); bank += (WEAR_LEVELING_BANK_SIZE)) {
+        write_log_entry_t hash;
+        write_log_entry_t generation;
+        if (!backing_store_read_bulk(bank, (backing_store_int_t *)wear_leveling.cache, sizeof(wear_leveling.cache) / sizeof(backing_store_int_t)) || !wear_leveling_read_entry(bank + (WEAR_LEVELING_LOGICAL_SIZE), &hash) || !wear_leveling_read_entry(bank + (WEAR_LEVELING_LOGICAL_SIZE) + 8, &generation)) {
+            continue;
+        }
+        if (hash.raw64 != fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT)) {
+            continue;
+        }
+        // Compare by difference so the generation can wrap
+        if (!found || (int32_t)((uint32_t)generation.raw64 - wear_leveling.generation) > 0) {
+            found                    = true;
+            wear_leveling.bank       = bank;
+            wear_leveling.generation = (uint32_t)generation.raw64;
+        }
+    }
+
+    wl_dprintf("Live bank at 0x%04X, generation %d\n", (int)wear_leveling.bank, (int)wear_leveling.generation);
+}
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
 /**
  * Wear-leveling initialization
  */
@@ -619,6 +983,9 @@ wear_leveling_status_t wear_leveling_init(void) {
 
     // Reset the cache
     wear_leveling_clear_cache();
+#ifdef WEAR_LEVELING_WRITE_BACK
+    memset(&wear_leveling.stats, 0, sizeof(wear_leveling.stats));
+#endif // WEAR_LEVELING_WRITE_BACK
 
     // Initialise the backing store
     if (!backing_store_init()) {
@@ -627,6 +994,10 @@ wear_leveling_status_t wear_leveling_init(void) {
         return WEAR_LEVELING_FAILED;
     }
 
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+    wear_leveling_select_bank();
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
     // Read the previous consolidated values, then replay the existing write log so that the cache has the "live" values
     wear_leveling_status_t status = wear_leveling_read_consolidated();
     if (status == WEAR_LEVELING_FAILED) {
@@ -661,6 +1032,12 @@ wear_leveling_status_t wear_leveling_erase(void) {
 
     // Perform the erase
     bool ret = backing_store_erase();
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+    wear_leveling.bank                 = 0;
+    wear_leveling.generation           = 0;
+    wear_leveling.consolidation_state  = CONSOLIDATION_IDLE;
+    wear_leveling.consolidation_failed = false;
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
     wear_leveling_clear_cache();
 
     // Lock the backing store if we acquired the lock successfully
@@ -691,6 +1068,25 @@ wear_leveling_status_t wear_leveling_write(const uint32_t address, const void *v
     // Update the cache before writing to the backing store -- if we hit the end of the backing store during writes to the log then we'll force a consolidation in-line
     memcpy(&wear_leveling.cache[address], value, length);
 
+#ifdef WEAR_LEVELING_WRITE_BACK
+    // Count what writing through would have appended, then leave the log alone until the next flush
+    wear_leveling.stats.bytes_written += length;
+    wear_leveling.estimating = true;
+    wear_leveling_write_raw(address, value, length);
+    wear_leveling.estimating = false;
+
+    if (wear_leveling_mark_dirty(address, address + length)) {
+        return WEAR_LEVELING_SUCCESS;
+    }
+
+    // Out of ranges and they're too far apart to bridge, so write out everything pending
+    wear_leveling_status_t status = wear_leveling_flush();
+    if (status == WEAR_LEVELING_FAILED) {
+        // Keep the data pending regardless, the next flush rewrites the bytes in between
+        wear_leveling_merge_closest(UINT32_MAX);
+    }
+    return status;
+#else
     // Unlock the backing store
     backing_store_lock_status_t lock_status = wear_leveling_unlock();
     if (lock_status == STATUS_FAILURE) {
@@ -724,8 +1120,120 @@ wear_leveling_status_t wear_leveling_write(const uint32_t address, const void *v
     }
 
     return status;
+#endif // WEAR_LEVELING_WRITE_BACK
 }
 
+#ifdef WEAR_LEVELING_WRITE_BACK
+/**
+ * Writes all dirty ranges from the cache to the write log.
+ */
+wear_leveling_status_t wear_leveling_flush(void) {
+    if (wear_leveling.dirty_count == 0) {
+        return WEAR_LEVELING_SUCCESS;
+    }
+
+    wl_dprintf("Flush %d range(s)\n", (int)wear_leveling.dirty_count);
+
+    // Unlock the backing store
+    backing_store_lock_status_t lock_status = wear_leveling_unlock();
+    if (lock_status == STATUS_FAILURE) {
+        wear_leveling_lock();
+        return WEAR_LEVELING_FAILED;
+    }
+
+    wear_leveling_status_t status = WEAR_LEVELING_SUCCESS;
+    while (wear_leveling.dirty_count > 0) {
+        const wear_leveling_dirty_range_t range = wear_leveling.dirty[0];
+
+        status = wear_leveling_write_raw(range.start, &wear_leveling.cache[range.start], range.end - range.start);
+        if (status == WEAR_LEVELING_FAILED) {
+            // Keep the range dirty so the next flush retries it
+            break;
+        }
+        if (status == WEAR_LEVELING_CONSOLIDATED) {
+            // Consolidation wrote out the whole cache, including every other dirty range
+            wear_leveling.dirty_count = 0;
+            break;
+        }
+
+        --wear_leveling.dirty_count;
+        memmove(&wear_leveling.dirty[0], &wear_leveling.dirty[1], wear_leveling.dirty_count * sizeof(wear_leveling_dirty_range_t));
+    }
+
+    if (status == WEAR_LEVELING_SUCCESS) {
+        // Consolidate the cache + write log if required
+        status = wear_leveling_consolidate_if_needed();
+    }
+
+    if (lock_status == STATUS_SUCCESS) {
+        if (wear_leveling_lock() == STATUS_FAILURE) {
+            status = WEAR_LEVELING_FAILED;
+        }
+    }
+
+    return status;
+}
+
+/**
+ * Checks whether any dirty ranges are waiting to be flushed.
+ */
+bool wear_leveling_write_pending(void) {
+    return wear_leveling.dirty_count > 0;
+}
+
+/**
+ * Retrieves the write traffic counters.
+ */
+void wear_leveling_get_stats(wear_leveling_stats_t *stats) {
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+    // Consolidation starts once the live bank's log is half full
+    const uint32_t log_capacity = ((WEAR_LEVELING_BANK_SIZE) - (WEAR_LEVELING_LOG_OFFSET)) / 2;
+#else
+    const uint32_t log_capacity = (WEAR_LEVELING_BANK_SIZE) - (WEAR_LEVELING_LOG_OFFSET);
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
+    *stats = wear_leveling.stats;
+    if (stats->log_bytes_write_through > stats->log_bytes) {
+        stats->consolidations_saved = (stats->log_bytes_write_through - stats->log_bytes) / log_capacity;
+    }
+}
+#endif // WEAR_LEVELING_WRITE_BACK
+
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+/**
+ * Runs the next step of a background consolidation, if one is in progress.
+ */
+wear_leveling_status_t wear_leveling_task(void) {
+    if (wear_leveling.consolidation_state == CONSOLIDATION_IDLE) {
+        return WEAR_LEVELING_SUCCESS;
+    }
+
+    // Unlock the backing store
+    backing_store_lock_status_t lock_status = wear_leveling_unlock();
+    if (lock_status == STATUS_FAILURE) {
+        wear_leveling_lock();
+        return WEAR_LEVELING_FAILED;
+    }
+
+    wear_leveling_status_t status = wear_leveling_consolidation_step();
+
+    if (lock_status == STATUS_SUCCESS) {
+        if (wear_leveling_lock() == STATUS_FAILURE) {
+            status = WEAR_LEVELING_FAILED;
+        }
+    }
+
+    return status;
+}
+
+/**
+ * Checks whether a background consolidation is in progress.
+ */
+bool wear_leveling_consolidation_pending(void) {
+    return wear_leveling.consolidation_state != CONSOLIDATION_IDLE;
+}
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
 /**
  * Reads logical data from the cache.
  */
@@ -766,3 +1274,12 @@ __attribute__((weak)) bool backing_store_write_bulk(uint32_t address, backing_st
     }
     return true;
 }
+
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+/**
+ * Weak implementation of partial erase, drivers which can erase a single sector should implement it.
+ */
+__attribute__((weak)) bool backing_store_erase_partial(uint32_t address, uint32_t end, uint32_t *next) {
+    return false;
+}
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
@@ -1,6 +1,7 @@
 // Copyright 2022 Nick Brassel (@tzarc)
 // SPDX-License-Identifier: GPL-2.0-or-later
 #pragma once
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -36,6 +37,8 @@ wear_leveling_status_t wear_leveling_erase(void);
  * determine if an overwrite should occur -- if there is any data mismatch the entire block will be written to the log,
  * not just the changed bytes.
  *
+ * With WEAR_LEVELING_WRITE_BACK, only the cache is updated and the write log is appended on wear_leveling_flush().
+ *
  * @param address[in] the logical address to write data
  * @param value[in] pointer to the source buffer
  * @param length[in] length of the data
@@ -52,3 +55,55 @@ wear_leveling_status_t wear_leveling_write(uint32_t address, const void* value,
  * @return Status of the request
  */
 wear_leveling_status_t wear_leveling_read(uint32_t address, void* value, size_t length);
+
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+/**
+ * Runs the next step of a background consolidation, if one is in progress. Intended to be called from the main loop.
+ *
+ * @return Status of the request, WEAR_LEVELING_CONSOLIDATED once the consolidation completes
+ */
+wear_leveling_status_t wear_leveling_task(void);
+
+/**
+ * Checks whether a background consolidation is in progress.
+ *
+ * @return true if wear_leveling_task() has work to do
+ */
+bool wear_leveling_consolidation_pending(void);
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
+#ifdef WEAR_LEVELING_WRITE_BACK
+/**
+ * @typedef Write traffic counters of the write-back cache, accumulated since the last wear_leveling_init().
+ */
+typedef struct wear_leveling_stats_t {
+    uint32_t bytes_written;           //< Changed bytes handed to wear_leveling_write()
+    uint32_t log_bytes;               //< Bytes appended to the write log
+    uint32_t log_bytes_write_through; //< Bytes the same writes would have appended without the write-back cache
+    uint32_t consolidations;          //< Erase cycles of the backing store
+    uint32_t consolidations_saved;    //< Erase cycles avoided compared to writing through
+} wear_leveling_stats_t;
+
+/**
+ * Writes all pending logical data from the cache to the write log.
+ *
+ * Adjacent and overlapping writes made since the last flush are appended as a single run of log entries.
+ *
+ * @return Status of the request
+ */
+wear_leveling_status_t wear_leveling_flush(void);
+
+/**
+ * Checks whether any writes are waiting in the cache for wear_leveling_flush().
+ *
+ * @return true if a flush would append to the write log
+ */
+bool wear_leveling_write_pending(void);
+
+/**
+ * Retrieves the write traffic counters.
+ *
+ * @param stats[out] destination for the counters
+ */
+void wear_leveling_get_stats(wear_leveling_stats_t* stats);
+#endif // WEAR_LEVELING_WRITE_BACK
@@ -27,6 +27,19 @@ typedef uint64_t backing_store_int_t;
 #    error WEAR_LEVELING_LOGICAL_SIZE was not set.
 #endif
 
+#ifdef WEAR_LEVELING_WRITE_BACK
+#    ifndef WEAR_LEVELING_WRITE_BACK_RANGES
+#        define WEAR_LEVELING_WRITE_BACK_RANGES 8
+#    endif
+#    if WEAR_LEVELING_WRITE_BACK_RANGES < 1 || WEAR_LEVELING_WRITE_BACK_RANGES > 254
+#        error WEAR_LEVELING_WRITE_BACK_RANGES needs to be between 1 and 254.
+#    endif
+// Largest run of unchanged bytes bridged when out of ranges, rewriting more costs more than a separate log entry
+#    ifndef WEAR_LEVELING_WRITE_BACK_MAX_GAP
+#        define WEAR_LEVELING_WRITE_BACK_MAX_GAP 2
+#    endif
+#endif
+
 #ifdef WEAR_LEVELING_DEBUG_OUTPUT
 #    include <debug.h>
 #    define bs_dprintf(...) dprintf("Backing store: " __VA_ARGS__)
@@ -66,6 +79,21 @@ _Static_assert(WEAR_LEVELING_BACKING_SIZE >= (WEAR_LEVELING_LOGICAL_SIZE * 2), "
 _Static_assert(WEAR_LEVELING_LOGICAL_SIZE % BACKING_STORE_WRITE_SIZE == 0, "Logical size must be a multiple of write size");
 _Static_assert(WEAR_LEVELING_BACKING_SIZE % WEAR_LEVELING_LOGICAL_SIZE == 0, "Backing size must be a multiple of logical size");
 
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+// Two banks, each holding consolidated data, its FNV1a_64, a generation counter and a write log
+#    define WEAR_LEVELING_BANK_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 2)
+#    define WEAR_LEVELING_LOG_OFFSET ((WEAR_LEVELING_LOGICAL_SIZE) + 16)
+// Number of consolidated bytes written to the spare bank per step
+#    ifndef WEAR_LEVELING_CONSOLIDATION_CHUNK
+#        define WEAR_LEVELING_CONSOLIDATION_CHUNK 64
+#    endif
+_Static_assert(WEAR_LEVELING_BACKING_SIZE >= (WEAR_LEVELING_LOGICAL_SIZE * 4), "Total backing size must be at least four times the logical size for incremental consolidation");
+_Static_assert(WEAR_LEVELING_CONSOLIDATION_CHUNK % 8 == 0, "Consolidation chunk size must be a multiple of 8");
+#else
+#    define WEAR_LEVELING_BANK_SIZE (WEAR_LEVELING_BACKING_SIZE)
+#    define WEAR_LEVELING_LOG_OFFSET ((WEAR_LEVELING_LOGICAL_SIZE) + 8)
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
 // Backing Store API, to be implemented elsewhere by flash driver etc.
 bool backing_store_init(void);
 bool backing_store_unlock(void);
@@ -75,6 +103,9 @@ bool backing_store_write_bulk(uint32_t address, backing_store_int_t* values, siz
 bool backing_store_lock(void);
 bool backing_store_read(uint32_t address, backing_store_int_t* value);
 bool backing_store_read_bulk(uint32_t address, backing_store_int_t* values, size_t item_count); // weak implementation already provided, optimized implementation can be implemented by driver
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+bool backing_store_erase_partial(uint32_t address, uint32_t end, uint32_t* next); // erases the sector starting at address, failing without erasing if it's unaligned or extends past end; weak implementation always fails
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
 
 /**
  * Helper type used to contain a write log entry.
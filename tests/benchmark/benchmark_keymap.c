@@ -0,0 +1,27 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "quantum.h"
+
+enum combos { combo_jk, combo_df };
+
+uint16_t const jk_combo[] = {KC_J, KC_K, COMBO_END};
+uint16_t const df_combo[] = {KC_D, KC_F, COMBO_END};
+
+// clang-format off
+combo_t key_combos[] = {
+    [combo_jk] = COMBO(jk_combo, KC_ESC),
+    [combo_df] = COMBO(df_combo, KC_TAB),
+};
+
+tap_dance_action_t tap_dance_actions[] = {
+    [0] = ACTION_TAP_DANCE_DOUBLE(KC_X, KC_CAPS_LOCK),
+};
+
+const key_override_t delete_key_override = ko_make_basic(MOD_MASK_SHIFT, KC_BSPC, KC_DEL);
+
+const key_override_t **key_overrides = (const key_override_t *[]){
+    &delete_key_override,
+    NULL
+};
+// clang-format on
@@ -0,0 +1,11 @@
+# Copyright 2024 QMK
+# SPDX-License-Identifier: GPL-2.0-or-later
+
+COMBO_ENABLE = yes
+TAP_DANCE_ENABLE = yes
+KEY_OVERRIDE_ENABLE = yes
+AUTOCORRECT_ENABLE = yes
+
+INTROSPECTION_KEYMAP_C = benchmark_keymap.c
+
+OPT_DEFS += -DBENCHMARK_OUTPUT_FILE=\"$(BUILD_DIR)/test/$(TEST_OUTPUT).json\"
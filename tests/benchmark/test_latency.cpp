@@ -0,0 +1,99 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_benchmark.hpp"
+
+class Latency : public LatencyBenchmark {};
+
+TEST_F(Latency, plain_key) {
+    KeymapKey key_a(0, 0, 0, KC_A);
+    set_keymap({key_a});
+
+    for (unsigned i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        EXPECT_TRUE(measure("plain_key_press", [&] { key_a.press(); }));
+        EXPECT_TRUE(measure("plain_key_release", [&] { key_a.release(); }));
+    }
+}
+
+TEST_F(Latency, mod_tap) {
+    KeymapKey mod_tap_key(0, 1, 0, LSFT_T(KC_A));
+    set_keymap({mod_tap_key});
+
+    for (unsigned i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        mod_tap_key.press();
+        settle(1);
+        EXPECT_TRUE(measure("mod_tap_tap", [&] { mod_tap_key.release(); }));
+        settle(TAPPING_TERM);
+
+        EXPECT_TRUE(measure("mod_tap_hold", [&] { mod_tap_key.press(); }));
+        mod_tap_key.release();
+        settle(TAPPING_TERM);
+    }
+}
+
+TEST_F(Latency, combo) {
+    KeymapKey key_j(0, 2, 0, KC_J);
+    KeymapKey key_k(0, 3, 0, KC_K);
+    set_keymap({key_j, key_k});
+
+    for (unsigned i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        key_j.press();
+        settle(1);
+        EXPECT_TRUE(measure("combo_chord", [&] { key_k.press(); }));
+        key_j.release();
+        key_k.release();
+        settle(COMBO_TERM);
+    }
+}
+
+TEST_F(Latency, tap_dance) {
+    KeymapKey key_td(0, 4, 0, TD(0));
+    set_keymap({key_td});
+
+    for (unsigned i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        key_td.press();
+        settle(1);
+        EXPECT_TRUE(measure("tap_dance_single_tap", [&] { key_td.release(); }));
+        settle(TAPPING_TERM);
+    }
+}
+
+TEST_F(Latency, key_override) {
+    KeymapKey key_shift(0, 5, 0, KC_LEFT_SHIFT);
+    KeymapKey key_bspc(0, 6, 0, KC_BACKSPACE);
+    set_keymap({key_shift, key_bspc});
+
+    for (unsigned i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        key_shift.press();
+        settle(1);
+        EXPECT_TRUE(measure("key_override_press", [&] { key_bspc.press(); }));
+        key_bspc.release();
+        key_shift.release();
+        settle(2);
+    }
+}
+
+TEST_F(Latency, autocorrect) {
+    KeymapKey key_f(0, 0, 1, KC_F);
+    KeymapKey key_a(0, 1, 1, KC_A);
+    KeymapKey key_l(0, 2, 1, KC_L);
+    KeymapKey key_e(0, 3, 1, KC_E);
+    KeymapKey key_s(0, 4, 1, KC_S);
+    KeymapKey key_space(0, 5, 1, KC_SPACE);
+    set_keymap({key_f, key_a, key_l, key_e, key_s, key_space});
+
+    autocorrect_enable();
+    for (unsigned i = 0; i < BENCHMARK_ITERATIONS; i++) {
+        for (KeymapKey key : {key_space, key_f, key_a, key_l, key_e}) {
+            key.press();
+            settle(1);
+            key.release();
+            settle(1);
+        }
+        EXPECT_TRUE(measure("autocorrect_typo", [&] { key_s.press(); }));
+        key_s.release();
+        settle(2);
+    }
+}
@@ -0,0 +1,82 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "quantum.h"
+#include "keycode.h"
+#include "test_common.h"
+#include "test_driver.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class ComboKeyIndex : public TestFixture {};
+
+TEST_F(ComboKeyIndex, two_key_combo) {
+    TestDriver driver;
+    KeymapKey  key_a(0, 0, 0, KC_A);
+    KeymapKey  key_b(0, 1, 0, KC_B);
+    set_keymap({key_a, key_b});
+
+    EXPECT_REPORT(driver, (KC_X));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_a, key_b});
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ComboKeyIndex, longer_overlapping_combo_wins) {
+    TestDriver driver;
+    KeymapKey  key_a(0, 0, 0, KC_A);
+    KeymapKey  key_b(0, 1, 0, KC_B);
+    KeymapKey  key_c(0, 2, 0, KC_C);
+    set_keymap({key_a, key_b, key_c});
+
+    EXPECT_REPORT(driver, (KC_Y));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_a, key_b, key_c});
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ComboKeyIndex, combo_in_second_bitset_word) {
+    TestDriver driver;
+    KeymapKey  key_d(0, 3, 0, KC_D);
+    KeymapKey  key_e(0, 4, 0, KC_E);
+    set_keymap({key_d, key_e});
+
+    EXPECT_REPORT(driver, (KC_Z));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_d, key_e});
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ComboKeyIndex, partial_combo_falls_through) {
+    TestDriver driver;
+    KeymapKey  key_a(0, 0, 0, KC_A);
+    KeymapKey  key_d(0, 3, 0, KC_D);
+    set_keymap({key_a, key_d});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_REPORT(driver, (KC_A, KC_D));
+    EXPECT_REPORT(driver, (KC_D));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_combo({key_a, key_d});
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(ComboKeyIndex, non_combo_key_is_not_delayed) {
+    TestDriver driver;
+    KeymapKey  key_q(0, 5, 0, KC_Q);
+    set_keymap({key_q});
+
+    EXPECT_REPORT(driver, (KC_Q));
+    key_q.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_q.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,23 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include "quantum.h"
+
+uint16_t const ab_combo[]     = {KC_A, KC_B, COMBO_END};
+uint16_t const abc_combo[]    = {KC_A, KC_B, KC_C, COMBO_END};
+uint16_t const de_combo[]     = {KC_D, KC_E, COMBO_END};
+uint16_t const unused_combo[] = {KC_F13, KC_F14, COMBO_END};
+
+#define UNUSED_COMBO COMBO_ACTION(unused_combo)
+
+// clang-format off
+// de is placed past the first 32 combos so the second bitset word is exercised
+combo_t key_combos[] = {
+    COMBO(ab_combo, KC_X),
+    COMBO(abc_combo, KC_Y),
+    UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO,
+    UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO,
+    UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO,
+    UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO, UNUSED_COMBO,
+    COMBO(de_combo, KC_Z),
+};
+// clang-format on
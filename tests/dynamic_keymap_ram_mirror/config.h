@@ -0,0 +1,11 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "test_common.h"
+
+#define DYNAMIC_KEYMAP_RAM_MIRROR
+#define DYNAMIC_KEYMAP_WRITE_BACK_DELAY 100
+
+#define EEPROM_SIZE 1024
@@ -0,0 +1,122 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "test_common.hpp"
+
+using testing::_;
+
+extern "C" {
+#include "dynamic_keymap.h"
+#include "eeprom.h"
+}
+
+// Backing store for the custom EEPROM driver, which records every write that reaches it
+static uint8_t                                  eeprom_contents[EEPROM_SIZE];
+static std::vector<std::pair<uintptr_t, size_t>> eeprom_writes;
+
+extern "C" {
+void eeprom_driver_init(void) {}
+
+void eeprom_driver_erase(void) {
+    memset(eeprom_contents, 0, sizeof(eeprom_contents));
+}
+
+void eeprom_read_block(void *buf, const void *addr, size_t len) {
+    memcpy(buf, &eeprom_contents[(uintptr_t)addr], len);
+}
+
+void eeprom_write_block(const void *buf, void *addr, size_t len) {
+    eeprom_writes.emplace_back((uintptr_t)addr, len);
+    memcpy(&eeprom_contents[(uintptr_t)addr], buf, len);
+}
+}
+
+class DynamicKeymapRamMirror : public TestFixture {
+   public:
+    void SetUp() override {
+        dynamic_keymap_reset();
+    }
+
+    uint16_t eeprom_keycode(uint8_t layer, uint8_t row, uint8_t column) {
+        uint8_t *address = (uint8_t *)dynamic_keymap_key_to_eeprom_address(layer, row, column);
+        return eeprom_read_byte(address) << 8 | eeprom_read_byte(address + 1);
+    }
+};
+
+TEST_F(DynamicKeymapRamMirror, WritesAreDeferredUntilIdle) {
+    TestDriver driver;
+    EXPECT_NO_REPORT(driver);
+
+    dynamic_keymap_set_keycode(0, 0, 0, KC_B);
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 0), KC_B);
+    EXPECT_NE(eeprom_keycode(0, 0, 0), KC_B);
+
+    idle_for(DYNAMIC_KEYMAP_WRITE_BACK_DELAY / 2);
+    dynamic_keymap_set_keycode(0, 1, 0, KC_C);
+    idle_for(DYNAMIC_KEYMAP_WRITE_BACK_DELAY / 2 + 1);
+    EXPECT_NE(eeprom_keycode(0, 0, 0), KC_B);
+    EXPECT_NE(eeprom_keycode(0, 1, 0), KC_C);
+
+    idle_for(DYNAMIC_KEYMAP_WRITE_BACK_DELAY);
+    EXPECT_EQ(eeprom_keycode(0, 0, 0), KC_B);
+    EXPECT_EQ(eeprom_keycode(0, 1, 0), KC_C);
+
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(DynamicKeymapRamMirror, FlushWritesImmediately) {
+    uint8_t data[4] = {0, KC_D, 0, KC_E};
+    dynamic_keymap_set_buffer(0, sizeof(data), data);
+    EXPECT_NE(eeprom_keycode(0, 0, 0), KC_D);
+
+    dynamic_keymap_flush();
+    EXPECT_EQ(eeprom_keycode(0, 0, 0), KC_D);
+    EXPECT_EQ(eeprom_keycode(0, 0, 1), KC_E);
+}
+
+TEST_F(DynamicKeymapRamMirror, MacroBufferIsMirrored) {
+    uint8_t macro[] = {'a', 'b', 0};
+    uint8_t read[sizeof(macro)];
+    dynamic_keymap_macro_set_buffer(0, sizeof(macro), macro);
+    dynamic_keymap_macro_get_buffer(0, sizeof(read), read);
+    EXPECT_EQ(memcmp(macro, read, sizeof(macro)), 0);
+
+    dynamic_keymap_flush();
+    dynamic_keymap_macro_reset();
+    dynamic_keymap_macro_get_buffer(0, sizeof(read), read);
+    EXPECT_EQ(read[0], 0);
+}
+
+TEST_F(DynamicKeymapRamMirror, LongRunsAreWrittenInChunks) {
+    uint8_t data[200];
+    for (size_t i = 0; i < sizeof(data); i += 2) {
+        data[i]     = 0;
+        data[i + 1] = KC_A + (i / 2) % 26;
+    }
+    dynamic_keymap_set_buffer(2, sizeof(data) - 1, data);
+    eeprom_writes.clear();
+    dynamic_keymap_flush();
+
+    uint8_t *base = (uint8_t *)dynamic_keymap_key_to_eeprom_address(0, 0, 0);
+    for (size_t i = 0; i < sizeof(data) - 1; i++) {
+        EXPECT_EQ(eeprom_read_byte(base + 2 + i), data[i]) << "offset " << i;
+    }
+
+    // The dirty blocks form one run, which should reach the driver as back to back writes of at most one chunk each
+    ASSERT_GE(eeprom_writes.size(), (sizeof(data) - 1 + 63) / 64);
+    for (size_t i = 0; i < eeprom_writes.size(); i++) {
+        EXPECT_LE(eeprom_writes[i].second, 64) << "write " << i;
+        if (i > 0) {
+            EXPECT_EQ(eeprom_writes[i].first, eeprom_writes[i - 1].first + eeprom_writes[i - 1].second) << "write " << i;
+        }
+        if (i + 1 < eeprom_writes.size()) {
+            EXPECT_EQ(eeprom_writes[i].second, 64) << "write " << i;
+        }
+    }
+    EXPECT_LE(eeprom_writes.front().first, (uintptr_t)base + 2);
+    EXPECT_GE(eeprom_writes.back().first + eeprom_writes.back().second, (uintptr_t)base + 2 + sizeof(data) - 1);
+}
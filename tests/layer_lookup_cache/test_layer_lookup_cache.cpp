@@ -0,0 +1,101 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+class LayerLookupCache : public TestFixture {};
+
+TEST_F(LayerLookupCache, ResolvesThroughTransparentKeys) {
+    TestDriver driver;
+    KeymapKey  key_a(0, 0, 0, KC_A);
+    KeymapKey  key_b(0, 1, 0, KC_B);
+    set_keymap({key_a, key_b, KeymapKey(1, 0, 0, KC_TRNS), KeymapKey(1, 1, 0, KC_C), KeymapKey(2, 0, 0, KC_D), KeymapKey(2, 1, 0, KC_TRNS)});
+
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 0);
+    EXPECT_EQ(layer_switch_get_layer(key_b.position), 0);
+
+    layer_on(1);
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 0);
+    EXPECT_EQ(layer_switch_get_layer(key_b.position), 1);
+
+    layer_on(2);
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 2);
+    EXPECT_EQ(layer_switch_get_layer(key_b.position), 1);
+
+    layer_off(1);
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 2);
+    EXPECT_EQ(layer_switch_get_layer(key_b.position), 0);
+
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(LayerLookupCache, FollowsDirectLayerStateWrites) {
+    TestDriver driver;
+    KeymapKey  key_a(0, 0, 0, KC_A);
+    set_keymap({key_a, KeymapKey(1, 0, 0, KC_B)});
+
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 0);
+
+    /* Split slaves assign the synced state without going through layer_state_set() */
+    layer_state = (layer_state_t)1 << 1;
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 1);
+    layer_state = 0;
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 0);
+
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(LayerLookupCache, InvalidatedByKeymapChanges) {
+    TestDriver driver;
+    KeymapKey  key_a(0, 0, 0, KC_A);
+    KeymapKey  key_b(1, 0, 0, KC_B);
+    set_keymap({key_a, KeymapKey(1, 0, 0, KC_TRNS)});
+
+    layer_on(1);
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 0);
+
+    set_keymap({key_a, key_b});
+    EXPECT_EQ(layer_switch_get_layer(key_a.position), 1);
+
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_b);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(LayerLookupCache, MomentaryLayerKeyPresses) {
+    TestDriver driver;
+    InSequence s;
+    KeymapKey  layer_key(0, 0, 0, MO(1));
+    KeymapKey  key_a(0, 1, 0, KC_A);
+    KeymapKey  key_b(1, 1, 0, KC_B);
+    set_keymap({layer_key, key_a, KeymapKey(1, 0, 0, KC_TRNS), key_b});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a);
+
+    EXPECT_NO_REPORT(driver);
+    layer_key.press();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_b);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_NO_REPORT(driver);
+    layer_key.release();
+    run_one_scan_loop();
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    tap_key(key_a);
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,112 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+extern "C" {
+#include "matrix_idle_sleep.h"
+#include "timer.h"
+
+void last_matrix_activity_trigger(void);
+}
+
+using testing::_;
+
+static unsigned armed_count;
+static bool     armed;
+static bool     wakeup_key_down;
+static bool     sleep_allowed;
+
+extern "C" bool matrix_idle_arm(void) {
+    armed_count++;
+    armed = true;
+    return true;
+}
+
+extern "C" bool matrix_idle_key_pressed(void) {
+    return wakeup_key_down;
+}
+
+extern "C" void matrix_idle_disarm(void) {
+    armed = false;
+}
+
+extern "C" bool matrix_idle_sleep_allowed_user(void) {
+    return sleep_allowed;
+}
+
+class MatrixIdleSleep : public TestFixture {
+   public:
+    void SetUp() override {
+        armed_count     = 0;
+        armed           = false;
+        wakeup_key_down = false;
+        sleep_allowed   = true;
+        last_matrix_activity_trigger();
+    }
+};
+
+TEST_F(MatrixIdleSleep, SleepsWhenAllKeysAreUp) {
+    TestDriver driver;
+    EXPECT_NO_REPORT(driver);
+
+    idle_for(MATRIX_IDLE_SLEEP_DELAY);
+    EXPECT_EQ(armed_count, 0);
+
+    uint32_t start = timer_read32();
+    run_one_scan_loop();
+    EXPECT_EQ(armed_count, 1);
+    EXPECT_FALSE(armed);
+    EXPECT_EQ(timer_elapsed32(start), MATRIX_IDLE_SLEEP_TIMEOUT + 1);
+
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(MatrixIdleSleep, WakesUpOnKeyPress) {
+    TestDriver driver;
+    EXPECT_NO_REPORT(driver);
+
+    idle_for(MATRIX_IDLE_SLEEP_DELAY);
+    EXPECT_EQ(armed_count, 0);
+
+    wakeup_key_down = true;
+    uint32_t start  = timer_read32();
+    run_one_scan_loop();
+    EXPECT_EQ(armed_count, 1);
+    EXPECT_FALSE(armed);
+    EXPECT_EQ(timer_elapsed32(start), 1);
+
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(MatrixIdleSleep, StaysAwakeWhileKeysAreHeld) {
+    TestDriver driver;
+    KeymapKey  key_a(0, 0, 0, KC_A);
+    set_keymap({key_a});
+
+    EXPECT_REPORT(driver, (KC_A));
+    key_a.press();
+    idle_for(MATRIX_IDLE_SLEEP_DELAY * 2);
+    EXPECT_EQ(armed_count, 0);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key_a.release();
+    idle_for(MATRIX_IDLE_SLEEP_DELAY);
+    EXPECT_EQ(armed_count, 0);
+    run_one_scan_loop();
+    EXPECT_EQ(armed_count, 1);
+    VERIFY_AND_CLEAR(driver);
+}
+
+TEST_F(MatrixIdleSleep, CanBeVetoed) {
+    TestDriver driver;
+    EXPECT_NO_REPORT(driver);
+
+    sleep_allowed = false;
+    idle_for(MATRIX_IDLE_SLEEP_DELAY * 2);
+    EXPECT_EQ(armed_count, 0);
+
+    VERIFY_AND_CLEAR(driver);
+}
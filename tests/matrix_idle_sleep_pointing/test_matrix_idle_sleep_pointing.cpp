@@ -0,0 +1,42 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "matrix_idle_sleep.h"
+
+void last_matrix_activity_trigger(void);
+}
+
+using testing::_;
+
+static unsigned armed_count;
+
+extern "C" bool matrix_idle_arm(void) {
+    armed_count++;
+    return true;
+}
+
+extern "C" bool matrix_idle_key_pressed(void) {
+    return false;
+}
+
+class MatrixIdleSleepPointing : public TestFixture {
+   public:
+    void SetUp() override {
+        armed_count = 0;
+        last_matrix_activity_trigger();
+    }
+};
+
+TEST_F(MatrixIdleSleepPointing, StaysAwakeForSensorWithoutMotionPin) {
+    TestDriver driver;
+    EXPECT_NO_REPORT(driver);
+
+    // the sensor can only be polled, sleeping would delay its motion
+    idle_for(MATRIX_IDLE_SLEEP_DELAY * 2);
+    EXPECT_EQ(armed_count, 0);
+
+    VERIFY_AND_CLEAR(driver);
+}
@@ -0,0 +1,108 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <vector>
+#include "keycode.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "pointing_device.h"
+
+static int16_t sensor_x = 0;
+static int16_t sensor_y = 0;
+
+report_mouse_t pointing_device_driver_get_report(report_mouse_t mouse_report) {
+    mouse_report.x = sensor_x;
+    mouse_report.y = sensor_y;
+    return mouse_report;
+}
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::Invoke;
+
+class PointingDeviceAccumulate : public TestFixture {
+   public:
+    std::vector<report_mouse_t> reports;
+
+    void SetUp() override {
+        sensor_x = 0;
+        sensor_y = 0;
+        reports.clear();
+    }
+
+    // Runs the keyboard task and records every mouse report sent meanwhile
+    void record_for(TestDriver &driver, unsigned time) {
+        EXPECT_CALL(driver, send_mouse_mock(_)).Times(AnyNumber()).WillRepeatedly(Invoke([this](report_mouse_t &report) { reports.push_back(report); }));
+        idle_for(time);
+        VERIFY_AND_CLEAR(driver);
+    }
+
+    int32_t total_x(void) {
+        int32_t total = 0;
+        for (auto &report : reports) {
+            total += report.x;
+        }
+        return total;
+    }
+};
+
+TEST_F(PointingDeviceAccumulate, sums_motion_between_reports) {
+    TestDriver driver;
+
+    sensor_x = 3;
+    sensor_y = -2;
+    record_for(driver, POINTING_DEVICE_REPORT_INTERVAL_MS * 8);
+    sensor_x = 0;
+    sensor_y = 0;
+    record_for(driver, POINTING_DEVICE_REPORT_INTERVAL_MS);
+
+    // one report per interval instead of one per read, nothing lost
+    EXPECT_LE(reports.size(), 9);
+    EXPECT_GE(reports.size(), 8);
+    EXPECT_EQ(total_x(), 3 * POINTING_DEVICE_REPORT_INTERVAL_MS * 8);
+    for (auto &report : reports) {
+        EXPECT_EQ(report.x * -2, report.y * 3);
+    }
+}
+
+TEST_F(PointingDeviceAccumulate, carries_overflow_into_next_reports) {
+    TestDriver driver;
+
+    sensor_x = 100;
+    record_for(driver, POINTING_DEVICE_REPORT_INTERVAL_MS * 2);
+    sensor_x = 0;
+    record_for(driver, POINTING_DEVICE_REPORT_INTERVAL_MS * 8);
+
+    // reports saturate, the remainder follows after the sensor stopped
+    EXPECT_EQ(total_x(), 100 * POINTING_DEVICE_REPORT_INTERVAL_MS * 2);
+    EXPECT_GE(reports.size(), (100 * POINTING_DEVICE_REPORT_INTERVAL_MS * 2) / XY_REPORT_MAX);
+    for (auto &report : reports) {
+        EXPECT_LE(report.x, XY_REPORT_MAX);
+    }
+}
+
+TEST_F(PointingDeviceAccumulate, sends_button_changes_immediately) {
+    TestDriver driver;
+
+    sensor_x = 1;
+    record_for(driver, 1);
+    sensor_x = 0;
+
+    // pending motion goes out along with the button
+    report_mouse_t report = pointing_device_get_report();
+    report.buttons        = 1;
+    pointing_device_set_report(report);
+    record_for(driver, 1);
+    ASSERT_GE(reports.size(), 1);
+    EXPECT_EQ(reports.back().buttons, 1);
+    EXPECT_EQ(total_x(), 1);
+
+    reports.clear();
+    report.buttons = 0;
+    pointing_device_set_report(report);
+    record_for(driver, 1);
+    ASSERT_EQ(reports.size(), 1);
+    EXPECT_EQ(reports[0].buttons, 0);
+}
@@ -0,0 +1,58 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keycode.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "task_profiler.h"
+}
+
+using testing::_;
+
+class TaskProfiler : public TestFixture {
+   public:
+    void SetUp() override {
+        task_profiler_reset();
+    }
+};
+
+TEST_F(TaskProfiler, records_every_stage_once_per_loop) {
+    TestDriver driver;
+
+    EXPECT_NO_REPORT(driver);
+    idle_for(10);
+    VERIFY_AND_CLEAR(driver);
+
+    EXPECT_EQ(task_profiler_get_stats(TASK_PROFILER_KEYBOARD_TASK)->count, 10);
+    EXPECT_EQ(task_profiler_get_stats(TASK_PROFILER_MATRIX_TASK)->count, 10);
+    EXPECT_EQ(task_profiler_get_stats(TASK_PROFILER_QUANTUM_TASK)->count, 10);
+    EXPECT_EQ(task_profiler_get_stats(TASK_PROFILER_LED_TASK)->count, 10);
+    EXPECT_EQ(task_profiler_get_stats(TASK_PROFILER_RGB_MATRIX_TASK)->count, 0);
+}
+
+TEST_F(TaskProfiler, tracks_min_max_average_and_histogram) {
+    task_profiler_record(TASK_PROFILER_OLED_TASK, 10);
+    task_profiler_record(TASK_PROFILER_OLED_TASK, 1000);
+    task_profiler_record(TASK_PROFILER_OLED_TASK, 100);
+
+    const task_profiler_stats_t *stats = task_profiler_get_stats(TASK_PROFILER_OLED_TASK);
+    EXPECT_EQ(stats->count, 3);
+    EXPECT_EQ(stats->min, 10);
+    EXPECT_EQ(stats->max, 1000);
+    EXPECT_EQ(task_profiler_get_average(TASK_PROFILER_OLED_TASK), 370);
+
+    // 10 < 64, 100 < 128 and 1000 < 1024 ticks
+    EXPECT_EQ(stats->histogram[0], 1);
+    EXPECT_EQ(stats->histogram[1], 1);
+    EXPECT_EQ(stats->histogram[4], 1);
+}
+
+TEST_F(TaskProfiler, resets_after_report_interval) {
+    TestDriver driver;
+
+    EXPECT_NO_REPORT(driver);
+    idle_for(TASK_PROFILER_REPORT_INTERVAL + 1);
+    EXPECT_LT(task_profiler_get_stats(TASK_PROFILER_KEYBOARD_TASK)->count, TASK_PROFILER_REPORT_INTERVAL);
+    VERIFY_AND_CLEAR(driver);
+}
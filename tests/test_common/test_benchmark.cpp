@@ -0,0 +1,154 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "test_benchmark.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <vector>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "keyboard.h"
+#include "timer.h"
+
+void advance_time(uint32_t ms);
+}
+
+namespace {
+
+struct Scenario {
+    std::vector<uint64_t> wall_ns;
+    std::vector<uint32_t> scans;
+    uint32_t              misses = 0;
+};
+
+template <typename T>
+T percentile(std::vector<T> samples, unsigned pct) {
+    if (samples.empty()) {
+        return 0;
+    }
+    std::sort(samples.begin(), samples.end());
+    size_t index = (samples.size() * pct + 99) / 100;
+    return samples[std::min(samples.size(), std::max<size_t>(index, 1)) - 1];
+}
+
+class BenchmarkResults : public ::testing::Environment {
+   public:
+    static std::map<std::string, Scenario>& scenarios() {
+        static std::map<std::string, Scenario> results;
+        return results;
+    }
+
+    void TearDown() override {
+        if (scenarios().empty()) {
+            return;
+        }
+
+        const char* path = std::getenv("QMK_BENCHMARK_OUTPUT");
+#ifdef BENCHMARK_OUTPUT_FILE
+        if (path == nullptr) {
+            path = BENCHMARK_OUTPUT_FILE;
+        }
+#endif
+
+        std::cout << std::left << std::setw(32) << "scenario" << std::right << std::setw(8) << "samples" << std::setw(12) << "p50 ns" << std::setw(12) << "p99 ns" << std::setw(12) << "max ns" << std::setw(10) << "p50 scans" << std::setw(8) << "misses" << std::endl;
+        for (const auto& [name, s] : scenarios()) {
+            std::cout << std::left << std::setw(32) << name << std::right << std::setw(8) << s.wall_ns.size() << std::setw(12) << percentile(s.wall_ns, 50) << std::setw(12) << percentile(s.wall_ns, 99) << std::setw(12) << percentile(s.wall_ns, 100) << std::setw(10) << percentile(s.scans, 50) << std::setw(8) << s.misses << std::endl;
+        }
+
+        if (path == nullptr) {
+            return;
+        }
+
+        std::ofstream out(path);
+        if (!out) {
+            std::cerr << "unable to write benchmark results to " << path << std::endl;
+            return;
+        }
+
+        out << "{\n  \"scenarios\": [";
+        bool first = true;
+        for (const auto& [name, s] : scenarios()) {
+            out << (first ? "\n" : ",\n");
+            out << "    {\"name\": \"" << name << "\", \"samples\": " << s.wall_ns.size() << ", \"misses\": " << s.misses;
+            out << ", \"p50_ns\": " << percentile(s.wall_ns, 50) << ", \"p99_ns\": " << percentile(s.wall_ns, 99) << ", \"max_ns\": " << percentile(s.wall_ns, 100);
+            out << ", \"p50_scans\": " << percentile(s.scans, 50) << ", \"p99_scans\": " << percentile(s.scans, 99) << ", \"max_scans\": " << percentile(s.scans, 100) << "}";
+            first = false;
+        }
+        out << "\n  ]\n}\n";
+        std::cout << "benchmark results written to " << path << std::endl;
+    }
+};
+
+::testing::Environment* const benchmark_results = ::testing::AddGlobalTestEnvironment(new BenchmarkResults);
+
+} // namespace
+
+uint32_t LatencyBenchmark::m_reports = 0;
+
+LatencyBenchmark::LatencyBenchmark() : m_driver{&LatencyBenchmark::keyboard_leds, &LatencyBenchmark::send_keyboard, &LatencyBenchmark::send_nkro, &LatencyBenchmark::send_mouse, &LatencyBenchmark::send_extra} {
+    m_reports = 0;
+    host_set_driver(&m_driver);
+}
+
+LatencyBenchmark::~LatencyBenchmark() {}
+
+bool LatencyBenchmark::measure(const std::string& scenario, const std::function<void()>& matrix_change, unsigned max_scans) {
+    Scenario& results = BenchmarkResults::scenarios()[scenario];
+    uint32_t  before  = m_reports;
+    uint32_t  scans   = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    matrix_change();
+    while (m_reports == before && scans < max_scans) {
+        keyboard_task();
+        advance_time(1);
+        scans++;
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    if (m_reports == before) {
+        results.misses++;
+        return false;
+    }
+
+    results.wall_ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    results.scans.push_back(scans);
+    return true;
+}
+
+void LatencyBenchmark::settle(unsigned ms) {
+    for (unsigned i = 0; i < ms; i++) {
+        keyboard_task();
+        advance_time(1);
+    }
+}
+
+uint32_t LatencyBenchmark::reports_sent() const {
+    return m_reports;
+}
+
+uint8_t LatencyBenchmark::keyboard_leds(void) {
+    return 0;
+}
+
+void LatencyBenchmark::send_keyboard(report_keyboard_t* report) {
+    m_reports++;
+}
+
+void LatencyBenchmark::send_nkro(report_nkro_t* report) {
+    m_reports++;
+}
+
+void LatencyBenchmark::send_mouse(report_mouse_t* report) {
+    m_reports++;
+}
+
+void LatencyBenchmark::send_extra(report_extra_t* report) {
+    m_reports++;
+}
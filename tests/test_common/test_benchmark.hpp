@@ -0,0 +1,73 @@
+// Copyright 2024 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "test_fixture.hpp"
+
+extern "C" {
+#include "host.h"
+}
+
+/**
+ * @brief Number of measured events per scenario, unless overridden by the test.
+ */
+#ifndef BENCHMARK_ITERATIONS
+#    define BENCHMARK_ITERATIONS 500
+#endif
+
+/**
+ * @brief Upper bound of keyboard task loops a single measured event may take
+ * before it is counted as a miss.
+ */
+#ifndef BENCHMARK_MAX_SCANS
+#    define BENCHMARK_MAX_SCANS 1000
+#endif
+
+/**
+ * @brief Fixture measuring the host CPU time from a matrix change until the
+ * next HID report leaves the keyboard.
+ *
+ * A lightweight host driver replaces the gmock based TestDriver while a
+ * benchmark runs, so the mock machinery does not show up in the numbers.
+ * Results are aggregated per scenario and written as JSON once all tests have
+ * run, either to `BENCHMARK_OUTPUT_FILE` or to the path in the
+ * `QMK_BENCHMARK_OUTPUT` environment variable.
+ */
+class LatencyBenchmark : public TestFixture {
+   public:
+    LatencyBenchmark();
+    ~LatencyBenchmark();
+
+    /**
+     * @brief Applies `matrix_change`, then runs the keyboard task until a
+     * report is sent or `max_scans` loops have elapsed. The elapsed time is
+     * recorded as one sample of `scenario`.
+     *
+     * @return true if a report was sent within `max_scans` loops.
+     */
+    bool measure(const std::string& scenario, const std::function<void()>& matrix_change, unsigned max_scans = BENCHMARK_MAX_SCANS);
+
+    /**
+     * @brief Runs the keyboard task for `ms` loops without recording anything.
+     */
+    void settle(unsigned ms);
+
+    /**
+     * @brief Number of reports sent to the host since the benchmark started.
+     */
+    uint32_t reports_sent() const;
+
+   private:
+    static uint8_t keyboard_leds(void);
+    static void    send_keyboard(report_keyboard_t* report);
+    static void    send_nkro(report_nkro_t* report);
+    static void    send_mouse(report_mouse_t* report);
+    static void    send_extra(report_extra_t* report);
+
+    static uint32_t m_reports;
+    host_driver_t   m_driver;
+};
@@ -118,14 +118,136 @@ static const USBDescriptor *usb_get_descriptor_cb(USBDriver *usbp, uint8_t dtype
     return &descriptor;
 }
 
+/* ---------------------------------------------------------
+ *                   HID report queues
+ * ---------------------------------------------------------
+ */
+
+/*
+ * Every HID IN endpoint has a small queue of reports. send_report() copies the
+ * report into the queue and returns, the IN notification callback starts the
+ * next report as soon as the previous one went out. The main loop only waits
+ * when a whole queue is still pending, e.g. while a macro types a long string.
+ */
+
+#ifndef USB_REPORT_QUEUE_SIZE
+#    define USB_REPORT_QUEUE_SIZE 4
+#endif
+
+/* Large enough for any report sent over a HID endpoint */
+typedef union {
+    report_keyboard_t keyboard;
+#ifdef NKRO_ENABLE
+    report_nkro_t nkro;
+#endif
+#ifdef EXTRAKEY_ENABLE
+    report_extra_t extra;
+#endif
+#ifdef MOUSE_ENABLE
+    report_mouse_t mouse;
+#endif
+#ifdef PROGRAMMABLE_BUTTON_ENABLE
+    report_programmable_button_t programmable_button;
+#endif
+#ifdef JOYSTICK_ENABLE
+    report_joystick_t joystick;
+#endif
+#ifdef DIGITIZER_ENABLE
+    report_digitizer_t digitizer;
+#endif
+} usb_report_t;
+
+typedef struct {
+    usb_report_t report[USB_REPORT_QUEUE_SIZE];
+    size_t       size[USB_REPORT_QUEUE_SIZE];
+    uint8_t      head;
+    uint8_t      count;
+    bool         transmitting; /* report[head] is being sent */
+} usb_report_queue_t;
+
+/* Folds report into the queued report if the host doesn't need to see both,
+ * returns false if they have to be sent separately. */
+typedef bool (*usb_report_merge_f)(usb_report_t *queued, const void *report);
+
+#ifndef KEYBOARD_SHARED_EP
+static usb_report_queue_t kbd_report_queue;
+#endif
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+static usb_report_queue_t mouse_report_queue;
+#endif
+#ifdef SHARED_EP_ENABLE
+static usb_report_queue_t shared_report_queue;
+#endif
+#if defined(JOYSTICK_ENABLE) && !defined(JOYSTICK_SHARED_EP)
+static usb_report_queue_t joystick_report_queue;
+#endif
+#if defined(DIGITIZER_ENABLE) && !defined(DIGITIZER_SHARED_EP)
+static usb_report_queue_t digitizer_report_queue;
+#endif
+
+static usb_report_queue_t *usb_report_queue_get(usbep_t ep) {
+#ifndef KEYBOARD_SHARED_EP
+    if (ep == KEYBOARD_IN_EPNUM) return &kbd_report_queue;
+#endif
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+    if (ep == MOUSE_IN_EPNUM) return &mouse_report_queue;
+#endif
+#ifdef SHARED_EP_ENABLE
+    if (ep == SHARED_IN_EPNUM) return &shared_report_queue;
+#endif
+#if defined(JOYSTICK_ENABLE) && !defined(JOYSTICK_SHARED_EP)
+    if (ep == JOYSTICK_IN_EPNUM) return &joystick_report_queue;
+#endif
+#if defined(DIGITIZER_ENABLE) && !defined(DIGITIZER_SHARED_EP)
+    if (ep == DIGITIZER_IN_EPNUM) return &digitizer_report_queue;
+#endif
+    return NULL;
+}
+
+/* Drops all queued reports, the endpoints have been reset.
+ * Called from locked state. */
+static void usb_report_queue_reset_all_i(void) {
+    for (usbep_t ep = 0; ep <= USB_MAX_ENDPOINTS; ep++) {
+        usb_report_queue_t *queue = usb_report_queue_get(ep);
+        if (queue) {
+            queue->head         = 0;
+            queue->count        = 0;
+            queue->transmitting = false;
+        }
+    }
+}
+
+/* Starts sending the oldest queued report if the endpoint is free.
+ * Called from locked state. */
+static void usb_report_queue_start_i(USBDriver *usbp, usbep_t ep, usb_report_queue_t *queue) {
+    if (queue->count == 0 || queue->transmitting || usbGetDriverStateI(usbp) != USB_ACTIVE || usbGetTransmitStatusI(usbp, ep)) {
+        return;
+    }
+    queue->transmitting = true;
+    usbStartTransmitI(usbp, ep, (uint8_t *)&queue->report[queue->head], queue->size[queue->head]);
+}
+
 /*
- * USB notification callback that does nothing.  Needed to work around bugs in
- * some USB LLDs that fail to resume the waiting thread when the notification
- * callback pointer is NULL.
+ * IN notification callback of the HID endpoints, called from ISR once a
+ * transfer is complete. Also needed to work around bugs in some USB LLDs that
+ * fail to resume the waiting thread when the notification callback pointer is
+ * NULL.
  */
-static void dummy_usb_cb(USBDriver *usbp, usbep_t ep) {
-    (void)usbp;
-    (void)ep;
+static void usb_report_queue_cb(USBDriver *usbp, usbep_t ep) {
+    usb_report_queue_t *queue = usb_report_queue_get(ep);
+    if (!queue) {
+        return;
+    }
+
+    osalSysLockFromISR();
+    /* The transfer may also have been a keyboard idle report */
+    if (queue->transmitting) {
+        queue->transmitting = false;
+        queue->head         = (queue->head + 1) % USB_REPORT_QUEUE_SIZE;
+        queue->count--;
+    }
+    usb_report_queue_start_i(usbp, ep, queue);
+    osalSysUnlockFromISR();
 }
 
 #ifndef KEYBOARD_SHARED_EP
@@ -135,7 +257,7 @@ static USBInEndpointState kbd_ep_state;
 static const USBEndpointConfig kbd_ep_config = {
     USB_EP_MODE_TYPE_INTR,  /* Interrupt EP */
     NULL,                   /* SETUP packet notification callback */
-    dummy_usb_cb,           /* IN notification callback */
+    usb_report_queue_cb,    /* IN notification callback */
     NULL,                   /* OUT notification callback */
     KEYBOARD_EPSIZE,        /* IN maximum packet size */
     0,                      /* OUT maximum packet size */
@@ -153,7 +275,7 @@ static USBInEndpointState mouse_ep_state;
 static const USBEndpointConfig mouse_ep_config = {
     USB_EP_MODE_TYPE_INTR,  /* Interrupt EP */
     NULL,                   /* SETUP packet notification callback */
-    dummy_usb_cb,           /* IN notification callback */
+    usb_report_queue_cb,    /* IN notification callback */
     NULL,                   /* OUT notification callback */
     MOUSE_EPSIZE,           /* IN maximum packet size */
     0,                      /* OUT maximum packet size */
@@ -171,7 +293,7 @@ static USBInEndpointState shared_ep_state;
 static const USBEndpointConfig shared_ep_config = {
     USB_EP_MODE_TYPE_INTR,  /* Interrupt EP */
     NULL,                   /* SETUP packet notification callback */
-    dummy_usb_cb,           /* IN notification callback */
+    usb_report_queue_cb,    /* IN notification callback */
     NULL,                   /* OUT notification callback */
     SHARED_EPSIZE,          /* IN maximum packet size */
     0,                      /* OUT maximum packet size */
@@ -189,7 +311,7 @@ static USBInEndpointState joystick_ep_state;
 static const USBEndpointConfig joystick_ep_config = {
     USB_EP_MODE_TYPE_INTR,  /* Interrupt EP */
     NULL,                   /* SETUP packet notification callback */
-    dummy_usb_cb,           /* IN notification callback */
+    usb_report_queue_cb,    /* IN notification callback */
     NULL,                   /* OUT notification callback */
     JOYSTICK_EPSIZE,        /* IN maximum packet size */
     0,                      /* OUT maximum packet size */
@@ -207,7 +329,7 @@ static USBInEndpointState digitizer_ep_state;
 static const USBEndpointConfig digitizer_ep_config = {
     USB_EP_MODE_TYPE_INTR,  /* Interrupt EP */
     NULL,                   /* SETUP packet notification callback */
-    dummy_usb_cb,           /* IN notification callback */
+    usb_report_queue_cb,    /* IN notification callback */
     NULL,                   /* OUT notification callback */
     DIGITIZER_EPSIZE,       /* IN maximum packet size */
     0,                      /* OUT maximum packet size */
@@ -494,6 +616,7 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
 
         case USB_EVENT_CONFIGURED:
             osalSysLockFromISR();
+            usb_report_queue_reset_all_i();
             /* Enable the endpoints specified into the configuration. */
 #ifndef KEYBOARD_SHARED_EP
             usbInitEndpointI(usbp, KEYBOARD_IN_EPNUM, &kbd_ep_config);
@@ -534,6 +657,9 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
             /* Falls into.*/
         case USB_EVENT_RESET:
             usb_event_queue_enqueue(event);
+            osalSysLockFromISR();
+            usb_report_queue_reset_all_i();
+            osalSysUnlockFromISR();
             for (int i = 0; i < NUM_USB_DRIVERS; i++) {
                 chSysLockFromISR();
                 /* Disconnection event on suspend.*/
@@ -713,7 +839,14 @@ static bool usb_requests_hook_cb(USBDriver *usbp) {
     return false;
 }
 
+static volatile uint16_t usb_frame_count = 0;
+
+uint16_t usb_get_frame_count(void) {
+    return usb_frame_count;
+}
+
 static void usb_sof_cb(USBDriver *usbp) {
+    usb_frame_count++;
     osalSysLockFromISR();
     for (int i = 0; i < NUM_USB_DRIVERS; i++) {
         qmkusbSOFHookI(&drivers.array[i].driver);
@@ -826,27 +959,51 @@ uint8_t keyboard_leds(void) {
     return keyboard_led_state;
 }
 
-void send_report(uint8_t endpoint, void *report, size_t size) {
+static void send_report_merge(uint8_t endpoint, void *report, size_t size, usb_report_merge_f merge) {
+    usb_report_queue_t *queue = usb_report_queue_get(endpoint);
+    if (!queue || size > sizeof(usb_report_t)) {
+        return;
+    }
+
     osalSysLock();
     if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
         osalSysUnlock();
         return;
     }
 
-    if (usbGetTransmitStatusI(&USB_DRIVER, endpoint)) {
-        /* Need to either suspend, or loop and call unlock/lock during
+    /* Fold into the newest queued report, unless that one is already being sent */
+    if (merge && queue->count > (queue->transmitting ? 1 : 0)) {
+        uint8_t tail = (queue->head + queue->count - 1) % USB_REPORT_QUEUE_SIZE;
+        if (queue->size[tail] == size && merge(&queue->report[tail], report)) {
+            osalSysUnlock();
+            return;
+        }
+    }
+
+    while (queue->count == USB_REPORT_QUEUE_SIZE) {
+        /* The host is a whole queue behind, wait for the next transfer.
+         * Need to either suspend, or loop and call unlock/lock during
          * every iteration - otherwise the system will remain locked,
          * no interrupts served, so USB not going through as well.
          * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[endpoint]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
+        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[endpoint]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT || usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
             osalSysUnlock();
             return;
         }
     }
-    usbStartTransmitI(&USB_DRIVER, endpoint, report, size);
+
+    uint8_t slot = (queue->head + queue->count) % USB_REPORT_QUEUE_SIZE;
+    memcpy(&queue->report[slot], report, size);
+    queue->size[slot] = size;
+    queue->count++;
+    usb_report_queue_start_i(&USB_DRIVER, endpoint, queue);
     osalSysUnlock();
 }
 
+void send_report(uint8_t endpoint, void *report, size_t size) {
+    send_report_merge(endpoint, report, size, NULL);
+}
+
 /* prepare and start sending a report IN
  * not callable from ISR or locked state */
 void send_keyboard(report_keyboard_t *report) {
@@ -871,9 +1028,54 @@ void send_nkro(report_nkro_t *report) {
  * ---------------------------------------------------------
  */
 
+#ifdef MOUSE_ENABLE
+#    ifdef MOUSE_EXTENDED_REPORT
+#        define MOUSE_REPORT_XY_MAX 32767
+#    else
+#        define MOUSE_REPORT_XY_MAX 127
+#    endif
+
+static bool mouse_report_merge_axis(int32_t sum, int32_t max) {
+    return sum >= -max && sum <= max;
+}
+
+/* Relative movement of reports with the same buttons can be summed */
+static bool mouse_report_merge(usb_report_t *queued, const void *report) {
+    report_mouse_t       *q = &queued->mouse;
+    const report_mouse_t *r = report;
+
+#    ifdef MOUSE_SHARED_EP
+    if (q->report_id != r->report_id) {
+        return false;
+    }
+#    endif
+    if (q->buttons != r->buttons) {
+        return false;
+    }
+
+    int32_t x = (int32_t)q->x + r->x;
+    int32_t y = (int32_t)q->y + r->y;
+    int32_t v = (int32_t)q->v + r->v;
+    int32_t h = (int32_t)q->h + r->h;
+    if (!mouse_report_merge_axis(x, MOUSE_REPORT_XY_MAX) || !mouse_report_merge_axis(y, MOUSE_REPORT_XY_MAX) || !mouse_report_merge_axis(v, 127) || !mouse_report_merge_axis(h, 127)) {
+        return false;
+    }
+
+    q->x = x;
+    q->y = y;
+    q->v = v;
+    q->h = h;
+#    ifdef MOUSE_EXTENDED_REPORT
+    q->boot_x = (x > 127) ? 127 : ((x < -127) ? -127 : x);
+    q->boot_y = (y > 127) ? 127 : ((y < -127) ? -127 : y);
+#    endif
+    return true;
+}
+#endif
+
 void send_mouse(report_mouse_t *report) {
 #ifdef MOUSE_ENABLE
-    send_report(MOUSE_IN_EPNUM, report, sizeof(report_mouse_t));
+    send_report_merge(MOUSE_IN_EPNUM, report, sizeof(report_mouse_t), mouse_report_merge);
     mouse_report_sent = *report;
 #endif
 }
@@ -36,6 +36,9 @@ void init_usb_driver(USBDriver *usbp);
 /* Restart the USB driver and bus */
 void restart_usb_driver(USBDriver *usbp);
 
+/* Number of Start Of Frame packets received, wraps around */
+uint16_t usb_get_frame_count(void);
+
 /* ---------------
  * USB Event queue
  * ---------------